@@ -0,0 +1,371 @@
+// Scaling stress harness (make bench-stress)
+//
+// Where bench_sim soak-tests one long session, this sweeps scenario size
+// and emits CSV so regressions show up as a bent curve instead of a gut
+// feeling. Each scenario rebuilds the world from scratch, seeds it with
+// N goal-carrying NPCs on the turn queue and M particle emitters, then
+// drives the player across K chunk boundaries with the scripted walker
+// (exercising mapgen, serialization and paging) before idling out the
+// remaining turns. Reported per row: turn throughput, frame time
+// average/p95, the TURNS phase p95, and the arena / chunk-store
+// high-water marks. One row per scenario; axes are swept one at a time
+// around a fixed baseline so each column reads as a scaling curve.
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "../game/api.h"
+#include "../game/world.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// api.h only provides the signature macros (the SDL3 host resolves these
+// through dlsym); here we link the game statically, so declare them
+GAME_SET_HOST_FUNCTIONS_SIG(GAME_SET_HOST_FUNCTIONS_NAME);
+GAME_GET_MEMORY_SIZE_SIG(GAME_GET_MEMORY_SIZE_NAME);
+GAME_SET_MEMORY_SIG(GAME_SET_MEMORY_NAME);
+GAME_INIT_SIG(GAME_INIT_NAME);
+GAME_INPUT_SIG(GAME_INPUT_NAME);
+GAME_FRAME_SIG(GAME_FRAME_NAME);
+GAME_CHUNK_STORED_SIG(GAME_CHUNK_STORED_NAME);
+GAME_CHUNK_LOADED_SIG(GAME_CHUNK_LOADED_NAME);
+
+#define STRESS_DEFAULT_TURNS 400 // per scenario
+#define STRESS_DEFAULT_SEED 12345
+
+// Same fixed cadence as bench_sim: one move animation per frame
+#define STRESS_DT 0.1
+
+// ============================================================================
+// Stub host: logging, timing, and an in-memory chunk store (as bench_sim)
+// ============================================================================
+
+static HOST_TIME_US_SIG(stub_time_us) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1000000.0 + (double)ts.tv_nsec / 1000.0;
+}
+
+static HOST_LOG_SIG(stub_log) {
+  if (level >= LOG_WARN) { // CSV goes to stdout; keep it parseable
+    fprintf(stderr, "[game] %s\n", message);
+  }
+}
+
+static HOST_SUBMIT_GEOMETRY_SIG(stub_submit_geometry) {
+  (void)vertices, (void)vertex_count;
+}
+
+static HOST_SUBMIT_LAYER_SIG(stub_submit_layer) {
+  (void)layer_id, (void)version, (void)vertices, (void)vertex_count;
+  (void)offset_x, (void)offset_y;
+}
+
+static HOST_PARALLEL_FOR_SIG(stub_parallel_for) {
+  for (int i = 0; i < count; i++) {
+    task(i, ctx);
+  }
+}
+
+// Jobs run synchronously: the bench measures the game's own work
+static HOST_JOB_SUBMIT_SIG(stub_job_submit) {
+  task(ctx);
+  return 0;
+}
+
+static HOST_JOB_WAIT_SIG(stub_job_wait) { (void)job; }
+
+#define STORE_MAX 4096
+
+typedef struct {
+  uint64_t key;
+  void *data;
+  size_t size;
+} StoredChunk;
+
+static StoredChunk store[STORE_MAX];
+static int store_count;
+static size_t store_bytes;
+
+static StoredChunk *store_find(uint64_t chunk_key) {
+  for (int i = 0; i < store_count; i++) {
+    if (store[i].key == chunk_key) {
+      return &store[i];
+    }
+  }
+  return NULL;
+}
+
+static HOST_STORE_CHUNK_SIG(stub_store_chunk) {
+  StoredChunk *slot = store_find(chunk_key);
+  if (!slot) {
+    if (store_count >= STORE_MAX) {
+      game_chunk_stored(chunk_key, false);
+      return;
+    }
+    slot = &store[store_count++];
+    slot->key = chunk_key;
+  }
+  free(slot->data);
+  store_bytes -= slot->size;
+  slot->data = malloc(data_size);
+  memcpy(slot->data, data, data_size);
+  slot->size = data_size;
+  store_bytes += data_size;
+  game_chunk_stored(chunk_key, true);
+}
+
+static HOST_LOAD_CHUNK_SIG(stub_load_chunk) {
+  StoredChunk *slot = store_find(chunk_key);
+  if (slot) {
+    game_chunk_loaded(chunk_key, slot->data, slot->size);
+  } else {
+    game_chunk_loaded(chunk_key, NULL, 0);
+  }
+}
+
+// scenarios must not see each other's pages
+static void store_reset(void) {
+  for (int i = 0; i < store_count; i++) {
+    free(store[i].data);
+    store[i] = (StoredChunk){0};
+  }
+  store_count = 0;
+  store_bytes = 0;
+}
+
+// ============================================================================
+// Scripted input: same walker as bench_sim, reseeded per scenario
+// ============================================================================
+
+static uint64_t script_state;
+
+static uint64_t script_rand(void) { // splitmix64, private stream
+  uint64_t z = (script_state += 0x9e3779b97f4a7c15);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+static InputCommand script_heading;
+static int script_run_left;
+
+static InputCommand script_next(void) {
+  if (script_run_left == 0) {
+    if (script_rand() % 8 == 0) {
+      script_run_left = 1;
+      return INPUT_CMD_PERIOD;
+    }
+    script_heading = (InputCommand)(INPUT_CMD_UP + script_rand() % 4);
+    script_run_left = 1 + (int)(script_rand() % 12);
+  }
+  script_run_left--;
+  return script_heading;
+}
+
+// ============================================================================
+// Scenario population
+// ============================================================================
+
+// Mirrors spawn_monsters in game.c, at stress scale: reserve the index
+// range in one batch, fill parts directly, commit bits per part, then do
+// the per-entity bookkeeping. Each NPC lands on the turn queue and gets
+// a goal stack, so the goal pool and Goals part churn are real even
+// though move decisions run through the flowfield NPC tiers
+static uint16_t stress_spawn_npcs(uint16_t count) {
+  Position positions[MAX_ENTITIES];
+  uint16_t placed = 0;
+  for (uint16_t i = 0; i < count; i++) {
+    if (map_get_random_passable(&WORLD.map, 0, 0, WORLD.map.width,
+                                WORLD.map.height, &positions[placed], 100)) {
+      placed++;
+    }
+  }
+
+  EntityBatch batch = entity_batch_alloc(placed);
+  for (uint16_t i = 0; i < placed; i++) {
+    EntityIndex npc = batch.first + i;
+    PART(Position, npc) = positions[i];
+    PART(Health, npc) = HEALTH_FULL;
+  }
+  ENTITY_BATCH_ENABLE_PART(Position, batch);
+  ENTITY_BATCH_ENABLE_PART(Health, batch);
+
+  for (uint16_t i = 0; i < placed; i++) {
+    EntityIndex npc = batch.first + i;
+    spatial_index_insert(npc);
+    turn_queue_insert(npc, 0);
+    entity_push_goal(npc, (Goal){
+                              .type = GOAL_HUNT,
+                              .target_entity = ENTITIES.player,
+                          });
+  }
+  return placed;
+}
+
+// Standalone smoke emitters scattered over the window; emission runs off
+// the 10Hz tick, so M emitters stress both the emitter query and the
+// particle integrate-and-age pass
+static uint16_t stress_spawn_emitters(uint16_t count) {
+  Position positions[MAX_ENTITIES];
+  uint16_t placed = 0;
+  for (uint16_t i = 0; i < count; i++) {
+    if (map_get_random_passable(&WORLD.map, 0, 0, WORLD.map.width,
+                                WORLD.map.height, &positions[placed], 100)) {
+      placed++;
+    }
+  }
+
+  EntityBatch batch = entity_batch_alloc(placed);
+  for (uint16_t i = 0; i < placed; i++) {
+    EntityIndex emitter = batch.first + i;
+    PART(Position, emitter) = positions[i];
+    PART(ParticleEmitter, emitter) = (ParticleEmitter){
+        .particle_type = PARTICLE_TYPE_TORCH_SMOKE,
+        .countdown_ticks = 1,
+    };
+  }
+  ENTITY_BATCH_ENABLE_PART(Position, batch);
+  ENTITY_BATCH_ENABLE_PART(ParticleEmitter, batch);
+
+  for (uint16_t i = 0; i < placed; i++) {
+    spatial_index_insert((EntityIndex)(batch.first + i));
+  }
+  return placed;
+}
+
+// ============================================================================
+// Scenario runner
+// ============================================================================
+
+#define FRAME_SAMPLES_MAX (64 * 1024)
+
+static float frame_samples_us[FRAME_SAMPLES_MAX];
+
+static int compare_float(const void *a, const void *b) {
+  float fa = *(const float *)a;
+  float fb = *(const float *)b;
+  return (fa > fb) - (fa < fb);
+}
+
+static void run_scenario(void *memory, size_t memory_size, uint16_t n_entities,
+                         uint16_t m_emitters, int k_chunks, long turn_target,
+                         uint64_t seed) {
+  // same reset path a replay restart takes: zero the world, re-init
+  store_reset();
+  memset(memory, 0, memory_size);
+  game_init(seed);
+  script_state = seed ^ 0x5eed;
+  script_run_left = 0;
+
+  stress_spawn_npcs(n_entities);
+  stress_spawn_emitters(m_emitters);
+
+  // walk until K chunk boundaries have been crossed, then idle in place
+  // so the remaining turns measure steady-state cost at this population
+  int crossings = 0;
+  int prev_chunk_x = WORLD.worldmap.curr_chunk_x;
+  int prev_chunk_y = WORLD.worldmap.curr_chunk_y;
+
+  long turns_done = 0;
+  long frames = 0;
+  double frame_total_us = 0.0;
+  uint64_t start_us = (uint64_t)stub_time_us();
+  while (turns_done < turn_target) {
+    if (WORLD.next_player_input == INPUT_CMD_NONE) {
+      game_input(crossings < k_chunks ? script_next() : INPUT_CMD_PERIOD);
+      turns_done++;
+    }
+    double frame_start_us = stub_time_us();
+    game_frame(STRESS_DT);
+    double frame_us = stub_time_us() - frame_start_us;
+    frame_total_us += frame_us;
+    if (frames < FRAME_SAMPLES_MAX) {
+      frame_samples_us[frames] = (float)frame_us;
+    }
+    frames++;
+
+    if (WORLD.worldmap.curr_chunk_x != prev_chunk_x ||
+        WORLD.worldmap.curr_chunk_y != prev_chunk_y) {
+      prev_chunk_x = WORLD.worldmap.curr_chunk_x;
+      prev_chunk_y = WORLD.worldmap.curr_chunk_y;
+      crossings++;
+    }
+  }
+  double secs = ((double)stub_time_us() - (double)start_us) / 1000000.0;
+
+  long sorted = frames < FRAME_SAMPLES_MAX ? frames : FRAME_SAMPLES_MAX;
+  qsort(frame_samples_us, (size_t)sorted, sizeof(float), compare_float);
+  float frame_p95_us = sorted ? frame_samples_us[sorted * 95 / 100] : 0.0f;
+
+  printf("%u,%u,%d,%ld,%ld,%.0f,%.1f,%.1f,%.1f,%zu,%zu,%u,%u,%d,%zu\n",
+         n_entities, m_emitters, k_chunks, turns_done, frames,
+         (double)turns_done / secs, frame_total_us / (double)frames,
+         (double)frame_p95_us,
+         (double)profile_phase_p95(PROFILE_PHASE_TURNS),
+         WORLD.frame_arena.high_water / 1024, WORLD.turn_arena.high_water / 1024,
+         ENTITIES.count, WORLD.compact_counter, store_count,
+         store_bytes / 1024);
+  fflush(stdout);
+}
+
+// ============================================================================
+// Sweep definition
+// ============================================================================
+
+// baseline scenario; each axis is swept with the other two held here
+#define BASE_ENTITIES 256
+#define BASE_EMITTERS 64
+#define BASE_CHUNKS 2
+
+static const uint16_t sweep_entities[] = {0, 64, 256, 1024};
+static const uint16_t sweep_emitters[] = {0, 16, 64, 256};
+static const int sweep_chunks[] = {0, 2, 4, 8};
+
+#define COUNT_OF(a) (int)(sizeof(a) / sizeof((a)[0]))
+
+int main(int argc, char **argv) {
+  long turn_target = STRESS_DEFAULT_TURNS;
+  uint64_t seed = STRESS_DEFAULT_SEED;
+  if (argc > 1) {
+    turn_target = atol(argv[1]);
+  }
+  if (argc > 2) {
+    seed = strtoull(argv[2], NULL, 10);
+  }
+  if (turn_target <= 0) {
+    fprintf(stderr, "usage: %s [turns-per-scenario] [seed]\n", argv[0]);
+    return 1;
+  }
+
+  game_set_host_functions(stub_log, stub_submit_geometry, stub_submit_layer,
+                          stub_load_chunk, stub_store_chunk, stub_parallel_for,
+                          stub_job_submit, stub_job_wait, stub_time_us);
+
+  size_t memory_size = game_get_memory_size();
+  void *memory = malloc(memory_size);
+  memset(memory, 0, memory_size);
+  game_set_memory(memory, memory_size);
+
+  printf("entities,emitters,chunks,turns,frames,turns_per_s,frame_avg_us,"
+         "frame_p95_us,turn_p95_us,frame_arena_kb,turn_arena_kb,"
+         "entities_end,compactions,chunks_stored,store_kb\n");
+  for (int i = 0; i < COUNT_OF(sweep_entities); i++) {
+    run_scenario(memory, memory_size, sweep_entities[i], BASE_EMITTERS,
+                 BASE_CHUNKS, turn_target, seed);
+  }
+  for (int i = 0; i < COUNT_OF(sweep_emitters); i++) {
+    run_scenario(memory, memory_size, BASE_ENTITIES, sweep_emitters[i],
+                 BASE_CHUNKS, turn_target, seed);
+  }
+  for (int i = 0; i < COUNT_OF(sweep_chunks); i++) {
+    run_scenario(memory, memory_size, BASE_ENTITIES, BASE_EMITTERS,
+                 sweep_chunks[i], turn_target, seed);
+  }
+
+  store_reset();
+  free(memory);
+  return 0;
+}
@@ -4,43 +4,12 @@ typedef struct {
   Attributes attr;
 } CombatStats;
 
-static Attributes gather_attributes(EntityIndex entity,
-                                    EntitySet *entity_tree) {
-  Attributes attr = {0};
-
-  if (HAS_PART(Attributes, entity)) {
-    attr = PART(Attributes, entity);
-
-    ENTITYSET_QUERY(i, entity_tree, HAS(AttributesModifier)) {
-      if (get_attributes_ancestor(i) == entity) {
-        attr.str =
-            clamp_int(attr.str + PART(AttributesModifier, i).str, 0, STR_MAX);
-        attr.dex =
-            clamp_int(attr.dex + PART(AttributesModifier, i).dex, 0, DEX_MAX);
-        attr.wil =
-            clamp_int(attr.wil + PART(AttributesModifier, i).wil, 0, WIL_MAX);
-        attr.con =
-            clamp_int(attr.con + PART(AttributesModifier, i).con, 0, CON_MAX);
-      }
-    }
-  } else {
-    attr.str = STR_DEFAULT;
-    attr.dex = DEX_DEFAULT;
-    attr.wil = WIL_DEFAULT;
-    attr.con = CON_DEFAULT;
-  }
-
-  return attr;
-}
-
 static CombatStats gather_combat_stats(EntityIndex combatant) {
   CombatStats stats = {0};
 
-  EntitySet combatant_tree = {0};
-  entityset_add(&combatant_tree, combatant);
-  entityset_expand_descendants(&combatant_tree);
-
-  stats.attr = gather_attributes(combatant, &combatant_tree);
+  // cached in the EffectiveAttributes part; the hierarchy walk only
+  // reruns after an attribute or equipment change
+  stats.attr = attributes_effective(combatant);
 
   // TODO: find and apply more bonuses or effects
 
@@ -71,7 +40,7 @@ void action_combat(EntityIndex attacker, EntityIndex defender) {
     if (health < 0) {
       health = 0;
     }
-    PART(Health, defender) = health;
+    PART_MUT(Health, defender) = health;
 
     if (health == 0) {
       ENABLE_PART(IsDead, defender);
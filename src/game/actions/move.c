@@ -11,6 +11,9 @@ void on_player_moved(void) {
     ensure_chunks_around_position(pos->x, pos->y);
 
     fov_compute(&WORLD.map, pos->x, pos->y, PLAYER_FOV_RADIUS);
+
+    // One shared expansion serves every entity chasing the player
+    flowfield_build(pos->x, pos->y);
   }
 }
 
@@ -26,16 +29,13 @@ void action_move(EntityIndex entity, Direction dir) {
     return;
   }
 
-  if (!MAP(x, y).passable) {
+  if (!MAP_PASSABLE(x, y)) {
     return;
   }
 
-  WORLD_QUERY(i, BITS(Position)) {
-    Position *pos2 = &PART(Position, i);
-    if (x == pos2->x && y == pos2->y) {
-      action_combat(entity, i);
-      return;
-    }
+  TILE_ENTITIES_QUERY(i, x, y) {
+    action_combat(entity, i);
+    return;
   }
 
   turn_queue_add_delay(entity, TURN_INTERVAL);
@@ -44,5 +44,5 @@ void action_move(EntityIndex entity, Direction dir) {
                             .actor = entity_handle_from_index(entity),
                             .move = {.from = *pos, .to = {x, y}}};
 
-  *pos = (Position){x, y};
+  spatial_index_move(entity, (Position){x, y});
 }
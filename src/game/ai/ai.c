@@ -55,6 +55,35 @@ void entity_pop_goal(EntityIndex entity) {
   aistate_free_goal(&WORLD.ai, goal);
 }
 
+void goal_path_store(Goal *goal, Position target, const Direction *moves,
+                     int count) {
+  if (count > GOAL_PATH_MAX) {
+    count = GOAL_PATH_MAX; // replay the head; we repath when it runs out
+  }
+  memcpy(goal->path, moves, count * sizeof(Direction));
+  goal->path_length = count;
+  goal->path_progress = 0;
+  goal->path_map_counter = WORLD.map.change_counter;
+  goal->path_target = target;
+}
+
+int goal_path_next(Goal *goal, Position target) {
+  if (goal->path_progress >= goal->path_length) {
+    return -1; // no cached path, or replayed to the end
+  }
+  if (goal->path_map_counter != WORLD.map.change_counter) {
+    return -1; // map changed under the path
+  }
+  int dx = target.x > goal->path_target.x ? target.x - goal->path_target.x
+                                          : goal->path_target.x - target.x;
+  int dy = target.y > goal->path_target.y ? target.y - goal->path_target.y
+                                          : goal->path_target.y - target.y;
+  if (dx + dy > GOAL_PATH_RETARGET_DIST) {
+    return -1; // target strayed too far from where we pathed to
+  }
+  return goal->path[goal->path_progress++];
+}
+
 void entity_take_action(EntityIndex entity) {
   if (!HAS_PART(Goals, entity)) {
     return;
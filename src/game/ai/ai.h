@@ -27,6 +27,14 @@ typedef uint16_t GoalType;
 
 typedef uint16_t GoalIndex;
 
+// Cached path replay: a goal keeps the leading moves of its last
+// computed path and replays them turn by turn instead of repathing
+#define GOAL_PATH_MAX 32
+
+// How far (manhattan) the target may stray from the tile the cached
+// path was computed for before we repath
+#define GOAL_PATH_RETARGET_DIST 2
+
 typedef struct {
   GoalType type;
   GoalIndex original_intent;
@@ -36,6 +44,12 @@ typedef struct {
     EntityHandle target_entity;
     Position target_position;
   };
+  // Cached path state (see goal_path_store / goal_path_next)
+  uint8_t path_length;       // moves stored in path[], 0 = no cached path
+  uint8_t path_progress;     // next move to replay
+  uint32_t path_map_counter; // WORLD.map.change_counter at compute time
+  Position path_target;      // tile the path was computed toward
+  Direction path[GOAL_PATH_MAX];
 } Goal;
 
 typedef struct {
@@ -56,3 +70,12 @@ Goal *entity_peek_goal(EntityIndex entity);
 bool entity_has_goal(EntityIndex entity);
 
 void entity_pop_goal(EntityIndex entity);
+
+// Cache the leading moves of a freshly computed path toward target
+void goal_path_store(Goal *goal, Position target, const Direction *moves,
+                     int count);
+
+// Next cached move toward target, advancing the replay position.
+// Returns -1 when the cache is stale: exhausted, computed against an
+// older map, or target moved more than GOAL_PATH_RETARGET_DIST away.
+int goal_path_next(Goal *goal, Position target);
@@ -1,22 +1,36 @@
 #include "astar.h"
+#include "../world.h"
 
 #define OPEN_SET_MAX 8192
 
 #define SCORE_MAX ((1 << 26) - 1)
 #define SCORE_MIN (-(1 << 26))
 
-// Priority queue node for A* open set
+// Bucket (dial) queue width. Must be a power of two, and must exceed the
+// largest f-score increase a single expansion can produce (step cost plus
+// heuristic change; ~20 with the usual cost of 10 per tile). Keys that
+// fall outside the live window are clamped into it, which only reorders
+// pops; the closed-set check keeps the search correct.
+#define BUCKET_COUNT 256
+
+// Open set node, pooled and chained into per-bucket lists
 typedef struct {
   uint16_t x;
   uint16_t y;
-  int32_t f_score; // g + h (can be negative with cost bonuses)
-} PQNode;
+  int32_t next; // pool index of the next node in the same bucket, or -1
+} BQNode;
 
-// Simple binary heap priority queue
+// Bucket queue over a circular window of f-scores. All live keys lie in
+// [cursor, cursor + BUCKET_COUNT - 1], so bucket indices never alias.
+// Push and pop are O(1) (pop amortized over cursor advances), replacing
+// the log-factor of the old binary heap.
 typedef struct {
-  int count;
-  PQNode nodes[OPEN_SET_MAX]; // Reasonable max for open set
-} PriorityQueue;
+  int count;      // live nodes across all buckets
+  int pool_count; // nodes handed out from the pool
+  int32_t cursor; // lowest key that may still hold nodes
+  int32_t buckets[BUCKET_COUNT]; // head pool index per bucket, or -1
+  BQNode pool[OPEN_SET_MAX];
+} BucketQueue;
 
 // A* cell state
 typedef struct {
@@ -28,68 +42,53 @@ typedef struct {
   uint32_t in_closed : 1;
 } AStarCell;
 
-static bool push_node(PriorityQueue *pq, int x, int y, int f_score) {
-  if (pq->count >= OPEN_SET_MAX) {
-    return false; // Queue full
+// Full state of an in-flight search, so it can stop after a bounded
+// number of expansions and resume later (see astar_search_begin)
+struct AStarSearch {
+  void *ctx;
+  AStarCostFunction cost_func;
+  int map_width;
+  int map_height;
+  int sx, sy;
+  int tx, ty;
+  AStarSearchStatus status;
+  AStarCell cells[MAP_WIDTH_MAX * MAP_HEIGHT_MAX];
+  BucketQueue open_set;
+};
+
+static bool push_node(BucketQueue *q, int x, int y, int32_t key) {
+  if (q->pool_count >= OPEN_SET_MAX) {
+    return false; // Pool exhausted
   }
 
-  // Insert at end
-  int i = pq->count++;
-  pq->nodes[i] = (PQNode){x, y, f_score};
-
-  // Bubble up
-  while (i > 0) {
-    int parent = (i - 1) / 2;
-    if (pq->nodes[i].f_score >= pq->nodes[parent].f_score) {
-      break;
-    }
-    // Swap
-    PQNode tmp = pq->nodes[i];
-    pq->nodes[i] = pq->nodes[parent];
-    pq->nodes[parent] = tmp;
-    i = parent;
+  // Clamp into the live window (keys below the cursor can occur with
+  // negative cost bonuses; keys above it with unusually large step costs)
+  if (key < q->cursor) {
+    key = q->cursor;
+  } else if (key >= q->cursor + BUCKET_COUNT) {
+    key = q->cursor + BUCKET_COUNT - 1;
   }
 
+  int i = q->pool_count++;
+  int bucket = key & (BUCKET_COUNT - 1);
+  q->pool[i] = (BQNode){x, y, q->buckets[bucket]};
+  q->buckets[bucket] = i;
+  q->count++;
   return true; // Successfully added
 }
 
-static PQNode pop_node(PriorityQueue *pq) {
-  PQNode result = pq->nodes[0];
-
-  // Move last to front
-  pq->count--;
-  if (pq->count > 0) {
-    pq->nodes[0] = pq->nodes[pq->count];
-
-    // Bubble down
-    int i = 0;
-    while (true) {
-      int left = 2 * i + 1;
-      int right = 2 * i + 2;
-      int smallest = i;
-
-      if (left < pq->count &&
-          pq->nodes[left].f_score < pq->nodes[smallest].f_score) {
-        smallest = left;
-      }
-      if (right < pq->count &&
-          pq->nodes[right].f_score < pq->nodes[smallest].f_score) {
-        smallest = right;
-      }
-
-      if (smallest == i) {
-        break;
-      }
-
-      // Swap
-      PQNode tmp = pq->nodes[i];
-      pq->nodes[i] = pq->nodes[smallest];
-      pq->nodes[smallest] = tmp;
-      i = smallest;
+static BQNode pop_node(BucketQueue *q) {
+  assert(q->count > 0);
+  for (;;) {
+    int bucket = q->cursor & (BUCKET_COUNT - 1);
+    int32_t head = q->buckets[bucket];
+    if (head >= 0) {
+      q->buckets[bucket] = q->pool[head].next;
+      q->count--;
+      return q->pool[head];
     }
+    q->cursor++;
   }
-
-  return result;
 }
 
 // Manhattan distance heuristic with perpendicular distance tie-breaker
@@ -156,54 +155,68 @@ static int reconstruct_path(AStarCell *cells, int sx, int sy, int tx, int ty,
   return path_len;
 }
 
-int astar_find_path(void *ctx, AStarCostFunction cost_func, int map_width,
-                    int map_height, int sx, int sy, int tx, int ty,
-                    Direction *moves_out) {
+AStarSearch *astar_search_begin(Arena *arena, void *ctx,
+                                AStarCostFunction cost_func, int map_width,
+                                int map_height, int sx, int sy, int tx,
+                                int ty) {
+  // Arena memory is zeroed, which is the unvisited cell state
+  AStarSearch *search = arena_alloc(arena, sizeof(AStarSearch));
+  search->ctx = ctx;
+  search->cost_func = cost_func;
+  search->map_width = map_width;
+  search->map_height = map_height;
+  search->sx = sx;
+  search->sy = sy;
+  search->tx = tx;
+  search->ty = ty;
+
   // Validate inputs
-  if (sx < 0 || sy < 0 || tx < 0 || ty < 0) {
-    return -1;
-  }
-  if (sx >= map_width || sy >= map_height || tx >= map_width ||
-      ty >= map_height) {
-    return -1;
+  if (sx < 0 || sy < 0 || tx < 0 || ty < 0 || sx >= map_width ||
+      sy >= map_height || tx >= map_width || ty >= map_height) {
+    search->status = ASTAR_SEARCH_NOT_FOUND;
+    return search;
   }
 
   // Already at target?
   if (sx == tx && sy == ty) {
-    return 0;
+    search->status = ASTAR_SEARCH_FOUND;
+    return search;
   }
 
-  // Allocate cell state (using MAP_WIDTH_MAX as stride for simplicity)
-  // Note: Static buffer makes this function non-reentrant (not thread-safe)
-  static AStarCell cells[MAP_WIDTH_MAX * MAP_HEIGHT_MAX];
-
-  // Initialize all cells to unvisited state
-  // All fields zeroed: g_score=0, in_open=0, in_closed=0, has_parent=0
-  // g_score is only read for cells in open set, which have valid costs
-  memset(cells, 0, sizeof(cells));
-
-  PriorityQueue open_set = {0};
+  search->status = ASTAR_SEARCH_IN_PROGRESS;
+  for (int i = 0; i < BUCKET_COUNT; i++) {
+    search->open_set.buckets[i] = -1;
+  }
 
   // Initialize start cell
   int start_idx = sy * MAP_WIDTH_MAX + sx;
-  cells[start_idx].g_score = 0;
-  cells[start_idx].in_open = 1;
-  cells[start_idx].has_parent = 0;
+  search->cells[start_idx].g_score = 0;
+  search->cells[start_idx].in_open = 1;
+  search->cells[start_idx].has_parent = 0;
 
   int f_start = heuristic(sx, sy, sx, sy, tx, ty);
-  bool initial_push_ok = push_node(&open_set, sx, sy, f_start);
+  search->open_set.cursor = f_start;
+  bool initial_push_ok = push_node(&search->open_set, sx, sy, f_start);
   assert(initial_push_ok);
+  return search;
+}
 
-  int popped_count = 0;
-  int pushed_count = 1;
+AStarSearchStatus astar_search_step(AStarSearch *search, int max_expansions) {
+  if (search->status != ASTAR_SEARCH_IN_PROGRESS) {
+    return search->status;
+  }
+
+  AStarCell *cells = search->cells;
+  BucketQueue *open_set = &search->open_set;
+  int tx = search->tx;
+  int ty = search->ty;
 
-  // A* main loop
-  while (open_set.count) {
-    PQNode node = pop_node(&open_set);
+  // A* main loop, bounded by the expansion budget
+  while (open_set->count && max_expansions-- > 0) {
+    BQNode node = pop_node(open_set);
     int cx = node.x;
     int cy = node.y;
     AStarCell *current = &cells[cy * MAP_WIDTH_MAX + cx];
-    ++popped_count;
 
     // Skip if already processed (stale duplicate from queue)
     if (current->in_closed) {
@@ -216,16 +229,15 @@ int astar_find_path(void *ctx, AStarCostFunction cost_func, int map_width,
 
     // Reached goal?
     if (cx == tx && cy == ty) {
-      // output_message("pushed_count: %d, popped_count: %d", pushed_count,
-      //                popped_count);
-      return reconstruct_path(cells, sx, sy, tx, ty, moves_out);
+      return search->status = ASTAR_SEARCH_FOUND;
     }
 
     // Check 4 neighbors (N, E, S, W)
     for (Direction dir = 0; dir < 4; dir++) {
       int nx = cx + dir_dx(dir);
       int ny = cy + dir_dy(dir);
-      if (nx < 0 || ny < 0 || nx >= map_width || ny >= map_height) {
+      if (nx < 0 || ny < 0 || nx >= search->map_width ||
+          ny >= search->map_height) {
         continue;
       }
 
@@ -234,7 +246,7 @@ int astar_find_path(void *ctx, AStarCostFunction cost_func, int map_width,
         continue;
       }
 
-      int move_cost = cost_func(ctx, cx, cy, nx, ny);
+      int move_cost = search->cost_func(search->ctx, cx, cy, nx, ny);
       if (move_cost == ASTAR_COST_INFINITE) {
         continue; // Impassable coordinate
       }
@@ -251,22 +263,46 @@ int astar_find_path(void *ctx, AStarCostFunction cost_func, int map_width,
             dir_opposite(dir); // Direction from neighbor back to current
         neighbor->has_parent = 1;
 
-        int f_score = tentative_g + heuristic(sx, sy, nx, ny, tx, ty);
+        int f_score = tentative_g + heuristic(search->sx, search->sy, nx, ny,
+                                              tx, ty);
 
-        // PQNode Push to queue (even if already in open set with worse f_score)
+        // Push to queue (even if already in open set with worse f_score)
         // We don't have decrease-key, so we push duplicates
         // The closed set check prevents processing the same node twice
-        if (push_node(&open_set, nx, ny, f_score)) {
+        if (push_node(open_set, nx, ny, f_score)) {
           neighbor->in_open = 1;
-          ++pushed_count;
         }
-        // If push fails (queue full), we skip this cell
+        // If push fails (pool exhausted), we skip this cell
         // This degrades gracefully: we may miss optimal path but won't corrupt
         // state
       }
     }
   }
 
-  // No path found
-  return -1;
+  if (open_set->count == 0) {
+    return search->status = ASTAR_SEARCH_NOT_FOUND; // open set exhausted
+  }
+  return ASTAR_SEARCH_IN_PROGRESS; // budget spent; resume later
+}
+
+int astar_search_result(AStarSearch *search, Direction *moves_out) {
+  if (search->status != ASTAR_SEARCH_FOUND) {
+    return -1;
+  }
+  return reconstruct_path(search->cells, search->sx, search->sy, search->tx,
+                          search->ty, moves_out);
+}
+
+int astar_find_path(void *ctx, AStarCostFunction cost_func, int map_width,
+                    int map_height, int sx, int sy, int tx, int ty,
+                    Direction *moves_out) {
+  // Run an unbudgeted search to completion on the frame arena
+  ArenaCheckpoint checkpoint = arena_checkpoint(&WORLD.frame_arena);
+  AStarSearch *search = astar_search_begin(&WORLD.frame_arena, ctx, cost_func,
+                                           map_width, map_height, sx, sy, tx,
+                                           ty);
+  astar_search_step(search, INT32_MAX);
+  int result = astar_search_result(search, moves_out);
+  arena_restore(&WORLD.frame_arena, checkpoint);
+  return result;
 }
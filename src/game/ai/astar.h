@@ -1,10 +1,15 @@
 #pragma once
 
-#include "../common.h"
+#include "../utils/arena.h"
 
 #define ASTAR_PATH_MAX_LENGTH 1024
 #define ASTAR_COST_INFINITE INT32_MAX
 
+// Suggested per-call expansion budget for astar_search_step when
+// spreading a search across turns (a few hundred expansions keeps
+// worst-case turn latency bounded while finishing short paths in one go)
+#define ASTAR_EXPANSIONS_PER_STEP 256
+
 /*
   Returns the cost of a single move from (sx,sy) to (tx,ty) which will be
   adjacent (up, down, left, right).
@@ -35,3 +40,42 @@ typedef int32_t (*AStarCostFunction)(void *ctx, int sx, int sy, int tx, int ty);
 int astar_find_path(void *ctx, AStarCostFunction cost_func, int map_width,
                     int map_height, int sx, int sy, int tx, int ty,
                     Direction *moves_out);
+
+/*
+  Resumable search interface. astar_find_path is a wrapper that runs a
+  search to completion; callers that must bound per-call latency begin
+  a search, then step it with an expansion budget until it resolves,
+  yielding (e.g. a wait-action) between steps:
+
+    AStarSearch *search = astar_search_begin(arena, ctx, cost, w, h,
+                                             sx, sy, tx, ty);
+    while (astar_search_step(search, ASTAR_EXPANSIONS_PER_STEP) ==
+           ASTAR_SEARCH_IN_PROGRESS) {
+      // yield; resume next turn
+    }
+    int count = astar_search_result(search, moves);  // -1 if not found
+
+  The state lives in the passed arena (roughly 80 KB), so a search that
+  resumes across turns needs an arena that outlives the frame.
+*/
+
+typedef enum {
+  ASTAR_SEARCH_IN_PROGRESS,
+  ASTAR_SEARCH_FOUND,
+  ASTAR_SEARCH_NOT_FOUND,
+} AStarSearchStatus;
+
+typedef struct AStarSearch AStarSearch;
+
+// Start a search; never fails (invalid coordinates yield a search that
+// immediately reports ASTAR_SEARCH_NOT_FOUND)
+AStarSearch *astar_search_begin(Arena *arena, void *ctx,
+                                AStarCostFunction cost_func, int map_width,
+                                int map_height, int sx, int sy, int tx, int ty);
+
+// Expand up to max_expansions nodes; repeat until no longer IN_PROGRESS
+AStarSearchStatus astar_search_step(AStarSearch *search, int max_expansions);
+
+// Move count into moves_out (at least ASTAR_PATH_MAX_LENGTH long), or -1
+// if the search did not find a path
+int astar_search_result(AStarSearch *search, Direction *moves_out);
@@ -0,0 +1,56 @@
+#include "flowfield.h"
+#include "../world.h"
+
+#define FLOW_DIR_NONE 255
+
+void flowfield_build(int x, int y) {
+  FlowField *field = &WORLD.flowfield;
+  for (int i = 0; i < MAP_WIDTH_MAX * MAP_HEIGHT_MAX; i++) {
+    field->dist[i] = FLOW_DIST_INFINITE;
+    field->dir[i] = FLOW_DIR_NONE;
+  }
+
+  // uniform step costs make the Dijkstra expansion a plain BFS
+  Position queue[MAP_WIDTH_MAX * MAP_HEIGHT_MAX];
+  int head = 0, tail = 0;
+  field->dist[y * MAP_WIDTH_MAX + x] = 0;
+  queue[tail++] = (Position){x, y};
+
+  while (head < tail) {
+    Position pos = queue[head++];
+    uint16_t dist = field->dist[pos.y * MAP_WIDTH_MAX + pos.x];
+    for (Direction dir = 0; dir < 4; dir++) {
+      int nx = pos.x + dir_dx(dir);
+      int ny = pos.y + dir_dy(dir);
+      if (nx < 0 || ny < 0 || nx >= WORLD.map.width || ny >= WORLD.map.height) {
+        continue;
+      }
+      if (!MAP_PASSABLE(nx, ny)) {
+        continue;
+      }
+      int nidx = ny * MAP_WIDTH_MAX + nx;
+      if (field->dist[nidx] != FLOW_DIST_INFINITE) {
+        continue;
+      }
+      field->dist[nidx] = dist + 1;
+      // step from the neighbor back toward where we expanded from
+      field->dir[nidx] = dir_opposite(dir);
+      queue[tail++] = (Position){nx, ny};
+    }
+  }
+
+  field->target = (Position){x, y};
+  field->valid = true;
+}
+
+void flowfield_invalidate(void) { WORLD.flowfield.valid = false; }
+
+int flowfield_direction(int x, int y) {
+  FlowField *field = &WORLD.flowfield;
+  if (!field->valid || x < 0 || y < 0 || x >= WORLD.map.width ||
+      y >= WORLD.map.height) {
+    return -1;
+  }
+  uint8_t dir = field->dir[y * MAP_WIDTH_MAX + x];
+  return dir == FLOW_DIR_NONE ? -1 : dir;
+}
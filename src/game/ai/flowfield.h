@@ -0,0 +1,31 @@
+#pragma once
+
+#include "../common.h"
+
+// ============================================================================
+// Shared Dijkstra flow field for crowd pathfinding
+// ============================================================================
+//
+// One Dijkstra expansion from the target position (typically the player)
+// covers the whole loaded window, and every entity pathing toward that
+// target reads its next step in O(1). This replaces N independent A*
+// searches with a single expansion per target move.
+
+#define FLOW_DIST_INFINITE UINT16_MAX
+
+typedef struct {
+  bool valid; // false until built, or after map/window changes
+  Position target;
+  uint8_t dir[MAP_WIDTH_MAX * MAP_HEIGHT_MAX];   // step toward the target
+  uint16_t dist[MAP_WIDTH_MAX * MAP_HEIGHT_MAX]; // steps to the target
+} FlowField;
+
+// rebuild the field flowing toward (x, y) over the loaded window
+void flowfield_build(int x, int y);
+
+// mark the field stale (call whenever map passability changes)
+void flowfield_invalidate(void);
+
+// next step from (x, y) toward the field's target, or -1 if the field is
+// invalid, the tile is unreachable, or (x, y) already is the target
+int flowfield_direction(int x, int y);
@@ -0,0 +1,369 @@
+#include "hpastar.h"
+#include "../world.h"
+
+// step cost used by the abstract layer (matches the usual tile move cost)
+#define HPA_STEP_COST 10
+
+static int chunk_of(int x, int y) {
+  return (y / MAP_CHUNK_HEIGHT) * HPA_CHUNKS_X + (x / MAP_CHUNK_WIDTH);
+}
+
+// tile of portal p that lies inside chunk c
+static Position portal_tile_in(const HPAPortal *p, int c) {
+  if (chunk_of(p->a.x, p->a.y) == c) {
+    return p->a;
+  }
+  assert(chunk_of(p->b.x, p->b.y) == c);
+  return p->b;
+}
+
+static void chunk_add_portal(HPAChunk *chunk, uint16_t portal_idx) {
+  assert(chunk->count < HPA_CHUNK_PORTALS_MAX);
+  chunk->portal[chunk->count++] = portal_idx;
+}
+
+static void add_portal(Position a, Position b) {
+  HPAState *hpa = &WORLD.hpa;
+  assert(hpa->portal_count < HPA_PORTALS_MAX);
+  uint16_t idx = hpa->portal_count++;
+  hpa->portals[idx] = (HPAPortal){a, b};
+  chunk_add_portal(&hpa->chunks[chunk_of(a.x, a.y)], idx);
+  chunk_add_portal(&hpa->chunks[chunk_of(b.x, b.y)], idx);
+}
+
+// uniform-cost BFS over the passable tiles of one chunk, distances in
+// multiples of HPA_STEP_COST. out_dist is indexed by local (x, y)
+static void chunk_bfs(int chunk, Position from,
+                      uint16_t out_dist[MAP_CHUNK_WIDTH * MAP_CHUNK_HEIGHT]) {
+  int x0 = (chunk % HPA_CHUNKS_X) * MAP_CHUNK_WIDTH;
+  int y0 = (chunk / HPA_CHUNKS_X) * MAP_CHUNK_HEIGHT;
+
+  for (int i = 0; i < MAP_CHUNK_WIDTH * MAP_CHUNK_HEIGHT; i++) {
+    out_dist[i] = HPA_COST_INFINITE;
+  }
+
+  Position queue[MAP_CHUNK_WIDTH * MAP_CHUNK_HEIGHT];
+  int head = 0, tail = 0;
+  out_dist[(from.y - y0) * MAP_CHUNK_WIDTH + (from.x - x0)] = 0;
+  queue[tail++] = from;
+
+  while (head < tail) {
+    Position pos = queue[head++];
+    uint16_t dist = out_dist[(pos.y - y0) * MAP_CHUNK_WIDTH + (pos.x - x0)];
+    for (Direction dir = 0; dir < 4; dir++) {
+      int nx = pos.x + dir_dx(dir);
+      int ny = pos.y + dir_dy(dir);
+      if (nx < x0 || ny < y0 || nx >= x0 + MAP_CHUNK_WIDTH ||
+          ny >= y0 + MAP_CHUNK_HEIGHT) {
+        continue;
+      }
+      if (!MAP_PASSABLE(nx, ny)) {
+        continue;
+      }
+      uint16_t *ndist = &out_dist[(ny - y0) * MAP_CHUNK_WIDTH + (nx - x0)];
+      if (*ndist != HPA_COST_INFINITE) {
+        continue;
+      }
+      *ndist = dist + HPA_STEP_COST;
+      queue[tail++] = (Position){nx, ny};
+    }
+  }
+}
+
+static uint16_t chunk_dist_at(int chunk, const uint16_t *dist, Position pos) {
+  int x0 = (chunk % HPA_CHUNKS_X) * MAP_CHUNK_WIDTH;
+  int y0 = (chunk / HPA_CHUNKS_X) * MAP_CHUNK_HEIGHT;
+  return dist[(pos.y - y0) * MAP_CHUNK_WIDTH + (pos.x - x0)];
+}
+
+// scan one border for contiguous runs of mutually-passable tile pairs and
+// place a portal at the midpoint of each run. vertical=true walks a column
+// pair (crossing east-west), otherwise a row pair (crossing north-south)
+static void build_border(int ax, int ay, bool vertical) {
+  int run_start = -1;
+  for (int i = 0; i <= MAP_CHUNK_HEIGHT; i++) {
+    bool open = false;
+    int x = vertical ? ax : ax + i;
+    int y = vertical ? ay + i : ay;
+    if (i < MAP_CHUNK_HEIGHT) {
+      int bx = vertical ? x + 1 : x;
+      int by = vertical ? y : y + 1;
+      open = MAP_PASSABLE(x, y) && MAP_PASSABLE(bx, by);
+    }
+    if (open && run_start < 0) {
+      run_start = i;
+    } else if (!open && run_start >= 0) {
+      int mid = (run_start + i - 1) / 2;
+      int mx = vertical ? ax : ax + mid;
+      int my = vertical ? ay + mid : ay;
+      Position a = {mx, my};
+      Position b = {vertical ? mx + 1 : mx, vertical ? my : my + 1};
+      add_portal(a, b);
+      run_start = -1;
+    }
+  }
+}
+
+static void hpa_build(void) {
+  HPAState *hpa = &WORLD.hpa;
+  hpa->portal_count = 0;
+  memset(hpa->chunks, 0, sizeof(hpa->chunks));
+
+  // vertical borders (between horizontally adjacent chunks)
+  for (int cy = 0; cy < HPA_CHUNKS_Y; cy++) {
+    for (int cx = 0; cx + 1 < HPA_CHUNKS_X; cx++) {
+      build_border((cx + 1) * MAP_CHUNK_WIDTH - 1, cy * MAP_CHUNK_HEIGHT, true);
+    }
+  }
+  // horizontal borders (between vertically adjacent chunks)
+  for (int cy = 0; cy + 1 < HPA_CHUNKS_Y; cy++) {
+    for (int cx = 0; cx < HPA_CHUNKS_X; cx++) {
+      build_border(cx * MAP_CHUNK_WIDTH, (cy + 1) * MAP_CHUNK_HEIGHT - 1,
+                   false);
+    }
+  }
+
+  // precompute intra-chunk portal-to-portal distances with one BFS per
+  // portal per touched chunk
+  for (int c = 0; c < HPA_CHUNK_COUNT; c++) {
+    HPAChunk *chunk = &hpa->chunks[c];
+    uint16_t dist[MAP_CHUNK_WIDTH * MAP_CHUNK_HEIGHT];
+    for (uint16_t i = 0; i < chunk->count; i++) {
+      chunk_bfs(c, portal_tile_in(&hpa->portals[chunk->portal[i]], c), dist);
+      for (uint16_t j = 0; j < chunk->count; j++) {
+        chunk->cost[i][j] = chunk_dist_at(
+            c, dist, portal_tile_in(&hpa->portals[chunk->portal[j]], c));
+      }
+    }
+  }
+
+  hpa->dirty = false;
+}
+
+void hpa_invalidate(void) { WORLD.hpa.dirty = true; }
+
+// cost function wrapper that confines refinement to one chunk's bounds
+typedef struct {
+  void *ctx;
+  AStarCostFunction cost_func;
+  int min_x, min_y, max_x, max_y;
+} BoundedCost;
+
+static int32_t bounded_cost(void *ctx, int sx, int sy, int tx, int ty) {
+  BoundedCost *b = ctx;
+  if (tx < b->min_x || ty < b->min_y || tx > b->max_x || ty > b->max_y) {
+    return ASTAR_COST_INFINITE;
+  }
+  return b->cost_func(b->ctx, sx, sy, tx, ty);
+}
+
+// refine one leg within a single chunk, appending to moves_out at *move_count.
+// returns false if no leg path exists or the move buffer would overflow
+static bool refine_leg(void *ctx, AStarCostFunction cost_func, int chunk,
+                       Position from, Position to, Direction *moves_out,
+                       int *move_count) {
+  BoundedCost bounded = {
+      .ctx = ctx,
+      .cost_func = cost_func,
+      .min_x = (chunk % HPA_CHUNKS_X) * MAP_CHUNK_WIDTH,
+      .min_y = (chunk / HPA_CHUNKS_X) * MAP_CHUNK_HEIGHT,
+  };
+  bounded.max_x = bounded.min_x + MAP_CHUNK_WIDTH - 1;
+  bounded.max_y = bounded.min_y + MAP_CHUNK_HEIGHT - 1;
+
+  Direction leg[ASTAR_PATH_MAX_LENGTH];
+  int leg_len = astar_find_path(&bounded, bounded_cost, WORLD.map.width,
+                                WORLD.map.height, from.x, from.y, to.x, to.y,
+                                leg);
+  if (leg_len < 0 || *move_count + leg_len > ASTAR_PATH_MAX_LENGTH) {
+    return false;
+  }
+  for (int i = 0; i < leg_len; i++) {
+    moves_out[(*move_count)++] = leg[i];
+  }
+  return true;
+}
+
+static Direction dir_between(Position from, Position to) {
+  for (Direction dir = 0; dir < 4; dir++) {
+    if (from.x + dir_dx(dir) == to.x && from.y + dir_dy(dir) == to.y) {
+      return dir;
+    }
+  }
+  assert(0 && "positions not adjacent");
+  return 0;
+}
+
+int hpa_find_path(void *ctx, AStarCostFunction cost_func, int sx, int sy,
+                  int tx, int ty, Direction *moves_out) {
+  if (sx < 0 || sy < 0 || tx < 0 || ty < 0 || sx >= WORLD.map.width ||
+      sy >= WORLD.map.height || tx >= WORLD.map.width ||
+      ty >= WORLD.map.height) {
+    return -1;
+  }
+
+  // Two region-label lookups reject unreachable goals before any search
+  if (!flood_same_region(sx, sy, tx, ty)) {
+    return -1;
+  }
+  if (sx == tx && sy == ty) {
+    return 0;
+  }
+
+  HPAState *hpa = &WORLD.hpa;
+  if (hpa->dirty) {
+    hpa_build();
+  }
+
+  int start_chunk = chunk_of(sx, sy);
+  int goal_chunk = chunk_of(tx, ty);
+
+  // same chunk: try a direct bounded refinement first
+  if (start_chunk == goal_chunk) {
+    int move_count = 0;
+    if (refine_leg(ctx, cost_func, start_chunk, (Position){sx, sy},
+                   (Position){tx, ty}, moves_out, &move_count)) {
+      return move_count;
+    }
+    // blocked inside the chunk; the path may leave and re-enter, so fall
+    // through to the abstract search
+  }
+
+  // Dijkstra over portal nodes plus virtual start/goal nodes
+  enum { NODE_MAX = HPA_PORTALS_MAX + 2 };
+  int node_count = hpa->portal_count + 2;
+  int start_node = hpa->portal_count;
+  int goal_node = hpa->portal_count + 1;
+  uint32_t dist[NODE_MAX];
+  int16_t prev[NODE_MAX];
+  bool done[NODE_MAX];
+  for (int i = 0; i < node_count; i++) {
+    dist[i] = UINT32_MAX;
+    prev[i] = -1;
+    done[i] = false;
+  }
+  dist[start_node] = 0;
+
+  uint16_t start_dist[MAP_CHUNK_WIDTH * MAP_CHUNK_HEIGHT];
+  uint16_t goal_dist[MAP_CHUNK_WIDTH * MAP_CHUNK_HEIGHT];
+  chunk_bfs(start_chunk, (Position){sx, sy}, start_dist);
+  chunk_bfs(goal_chunk, (Position){tx, ty}, goal_dist);
+
+  for (;;) {
+    // pick nearest unvisited node (node_count <= 130, a scan is fine)
+    int u = -1;
+    for (int i = 0; i < node_count; i++) {
+      if (!done[i] && dist[i] != UINT32_MAX && (u < 0 || dist[i] < dist[u])) {
+        u = i;
+      }
+    }
+    if (u < 0 || u == goal_node) {
+      break;
+    }
+    done[u] = true;
+
+    if (u == start_node) {
+      HPAChunk *chunk = &hpa->chunks[start_chunk];
+      for (uint16_t i = 0; i < chunk->count; i++) {
+        uint16_t p = chunk->portal[i];
+        Position tile = portal_tile_in(&hpa->portals[p], start_chunk);
+        uint16_t d = chunk_dist_at(start_chunk, start_dist, tile);
+        if (d != HPA_COST_INFINITE && dist[start_node] + d + HPA_STEP_COST <
+                                          dist[p]) {
+          dist[p] = dist[start_node] + d + HPA_STEP_COST;
+          prev[p] = (int16_t)start_node;
+        }
+      }
+      continue;
+    }
+
+    // portal node: relax within both chunks it touches
+    HPAPortal *portal = &hpa->portals[u];
+    int touched[2] = {chunk_of(portal->a.x, portal->a.y),
+                      chunk_of(portal->b.x, portal->b.y)};
+    for (int t = 0; t < 2; t++) {
+      int c = touched[t];
+      HPAChunk *chunk = &hpa->chunks[c];
+      uint16_t u_local = 0;
+      while (chunk->portal[u_local] != u) {
+        u_local++;
+      }
+      for (uint16_t i = 0; i < chunk->count; i++) {
+        uint16_t p = chunk->portal[i];
+        if (p == u) {
+          continue;
+        }
+        uint16_t d = chunk->cost[u_local][i];
+        if (d != HPA_COST_INFINITE && dist[u] + d + HPA_STEP_COST < dist[p]) {
+          dist[p] = dist[u] + d + HPA_STEP_COST;
+          prev[p] = (int16_t)u;
+        }
+      }
+      if (c == goal_chunk) {
+        Position tile = portal_tile_in(portal, c);
+        uint16_t d = chunk_dist_at(c, goal_dist, tile);
+        if (d != HPA_COST_INFINITE && dist[u] + d < dist[goal_node]) {
+          dist[goal_node] = dist[u] + d;
+          prev[goal_node] = (int16_t)u;
+        }
+      }
+    }
+  }
+
+  if (dist[goal_node] == UINT32_MAX) {
+    return -1;
+  }
+
+  // collect the portal sequence (prev chain is goal -> start)
+  uint16_t sequence[HPA_PORTALS_MAX];
+  int sequence_len = 0;
+  for (int16_t n = prev[goal_node]; n >= 0 && n != start_node; n = prev[n]) {
+    sequence[sequence_len++] = (uint16_t)n;
+  }
+
+  // refine the traversed chunks: walk portal to portal, crossing borders
+  // with a single step, and consult the real cost function only here. a
+  // portal's crossing is only taken if the next waypoint needs the far
+  // side (the abstract path can pass a portal without changing chunks)
+  int move_count = 0;
+  Position cur = {sx, sy};
+  int cur_chunk = start_chunk;
+  for (int i = sequence_len - 1; i >= 0; i--) {
+    HPAPortal *portal = &hpa->portals[sequence[i]];
+    Position exit_tile = portal_tile_in(portal, cur_chunk);
+    if (!refine_leg(ctx, cost_func, cur_chunk, cur, exit_tile, moves_out,
+                    &move_count)) {
+      return -1;
+    }
+    cur = exit_tile;
+
+    // which chunk does the next waypoint need?
+    int next_chunk;
+    if (i > 0) {
+      HPAPortal *next = &hpa->portals[sequence[i - 1]];
+      int na = chunk_of(next->a.x, next->a.y);
+      int nb = chunk_of(next->b.x, next->b.y);
+      int other = chunk_of(portal->a.x, portal->a.y) == cur_chunk
+                      ? chunk_of(portal->b.x, portal->b.y)
+                      : chunk_of(portal->a.x, portal->a.y);
+      next_chunk = (na == other || nb == other) ? other : cur_chunk;
+    } else {
+      next_chunk = goal_chunk;
+    }
+    if (next_chunk != cur_chunk) {
+      Position enter_tile =
+          cur.x == portal->a.x && cur.y == portal->a.y ? portal->b : portal->a;
+      if (move_count >= ASTAR_PATH_MAX_LENGTH) {
+        return -1;
+      }
+      moves_out[move_count++] = dir_between(cur, enter_tile);
+      cur = enter_tile;
+      cur_chunk = chunk_of(cur.x, cur.y);
+    }
+  }
+  if (!refine_leg(ctx, cost_func, goal_chunk, cur, (Position){tx, ty},
+                  moves_out, &move_count)) {
+    return -1;
+  }
+  return move_count;
+}
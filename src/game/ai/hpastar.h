@@ -0,0 +1,55 @@
+#pragma once
+
+#include "../common.h"
+#include "astar.h"
+
+// ============================================================================
+// Hierarchical pathfinding (HPA*) over the 3x3 chunk window
+// ============================================================================
+//
+// The tile grid is abstracted into portals: one node per contiguous run of
+// mutually-passable tile pairs along each chunk border. Abstract search runs
+// over the portal graph (intra-chunk costs precomputed by BFS), and only the
+// chunks actually traversed get refined into tile moves with a bounded A*,
+// so long paths stop scaling with raw tile count.
+
+#define HPA_CHUNKS_X MAP_CHUNK_WINDOW_X
+#define HPA_CHUNKS_Y MAP_CHUNK_WINDOW_Y
+#define HPA_CHUNK_COUNT (HPA_CHUNKS_X * HPA_CHUNKS_Y)
+
+// worst case is a portal every other tile along each border
+#define HPA_CHUNK_PORTALS_MAX 32
+#define HPA_PORTALS_MAX 128
+#define HPA_COST_INFINITE UINT16_MAX
+
+typedef struct {
+  Position a; // tile on the lower-coordinate chunk's side of the border
+  Position b; // adjacent tile just across the border
+} HPAPortal;
+
+typedef struct {
+  uint16_t count;                          // portals touching this chunk
+  uint16_t portal[HPA_CHUNK_PORTALS_MAX];  // global portal indices
+  // BFS tile distance between portal tiles inside this chunk
+  uint16_t cost[HPA_CHUNK_PORTALS_MAX][HPA_CHUNK_PORTALS_MAX];
+} HPAChunk;
+
+typedef struct {
+  bool dirty; // graph must be rebuilt before the next query
+  uint16_t portal_count;
+  HPAPortal portals[HPA_PORTALS_MAX];
+  HPAChunk chunks[HPA_CHUNK_COUNT];
+} HPAState;
+
+// mark the portal graph stale (call whenever map passability changes:
+// chunk generation, deserialization, window shifts). the rebuild happens
+// lazily on the next hpa_find_path call
+void hpa_invalidate(void);
+
+// hierarchical variant of astar_find_path with the same contract: finds a
+// path from (sx,sy) to (tx,ty) into moves_out (at least
+// ASTAR_PATH_MAX_LENGTH long), returning the move count or -1. the cost
+// function is only consulted while refining the traversed chunks; the
+// abstract layer uses terrain passability
+int hpa_find_path(void *ctx, AStarCostFunction cost_func, int sx, int sy,
+                  int tx, int ty, Direction *moves_out);
@@ -36,6 +36,8 @@ typedef enum {
   INPUT_CMD_PERIOD,
   INPUT_CMD_R,
   INPUT_CMD_D,
+  INPUT_CMD_P,
+  INPUT_CMD_T,
 } InputCommand;
 
 // ============================================================================
@@ -51,6 +53,24 @@ typedef HOST_LOG_SIG((*HostLogFn));
   void name(const Vertex *vertices, int vertex_count)
 typedef HOST_SUBMIT_GEOMETRY_SIG((*HostSubmitGeometryFn));
 
+// Static geometry layers for host_submit_layer. Hosts may keep one
+// rasterized cache per layer (render-target texture), redrawing it only
+// when the submitted version changes and otherwise just blitting it
+typedef enum {
+  RENDER_LAYER_MAP,
+  RENDER_LAYER_GHOSTS, // remembered entities on explored-but-dark tiles
+  RENDER_LAYER_MAX,
+} RenderLayerId;
+
+// Like host_submit_geometry, but for a layer whose vertices are in
+// layer-local coordinates and only change when version changes; the host
+// draws the (possibly cached) layer translated by (offset_x, offset_y)
+#define HOST_SUBMIT_LAYER_NAME host_submit_layer
+#define HOST_SUBMIT_LAYER_SIG(name)                                            \
+  void name(int layer_id, uint32_t version, const Vertex *vertices,            \
+            int vertex_count, float offset_x, float offset_y)
+typedef HOST_SUBMIT_LAYER_SIG((*HostSubmitLayerFn));
+
 #define HOST_LOAD_CHUNK_NAME host_load_chunk
 #define HOST_LOAD_CHUNK_SIG(name) void name(uint64_t chunk_key)
 typedef HOST_LOAD_CHUNK_SIG((*HostLoadChunkFn));
@@ -60,19 +80,77 @@ typedef HOST_LOAD_CHUNK_SIG((*HostLoadChunkFn));
   void name(uint64_t chunk_key, const void *data, size_t data_size)
 typedef HOST_STORE_CHUNK_SIG((*HostStoreChunkFn));
 
+// Task callback for host_parallel_for: invoked once per index with the
+// shared context. Tasks run concurrently, so they must only read game
+// state (or write disjoint per-index slots)
+typedef void (*ParallelForTask)(int index, void *ctx);
+
+#define HOST_PARALLEL_FOR_NAME host_parallel_for
+#define HOST_PARALLEL_FOR_SIG(name)                                            \
+  void name(ParallelForTask task, int count, void *ctx)
+typedef HOST_PARALLEL_FOR_SIG((*HostParallelForFn));
+
+// General jobs, for work that doesn't fit the parallel-for shape (e.g.
+// background mapgen overlapping the frame). host_job_submit hands the
+// task to the host's worker pool and returns an opaque handle; every
+// handle MUST be passed to host_job_wait exactly once, which blocks
+// until the job has run and reclaims the handle. Jobs follow the same
+// aliasing rules as ParallelForTask and must not submit jobs themselves.
+// Hosts without a pool run the task synchronously inside submit
+typedef void (*JobTask)(void *ctx);
+
+#define HOST_JOB_SUBMIT_NAME host_job_submit
+#define HOST_JOB_SUBMIT_SIG(name) uint32_t name(JobTask task, void *ctx)
+typedef HOST_JOB_SUBMIT_SIG((*HostJobSubmitFn));
+
+#define HOST_JOB_WAIT_NAME host_job_wait
+#define HOST_JOB_WAIT_SIG(name) void name(uint32_t job)
+typedef HOST_JOB_WAIT_SIG((*HostJobWaitFn));
+
+// Monotonic high-resolution time in microseconds, for profiling only
+// (game logic must stay deterministic and use dt/ticks). Returned as a
+// double so the WASM import avoids 64-bit integer crossings into JS
+#define HOST_TIME_US_NAME host_time_us
+#define HOST_TIME_US_SIG(name) double name(void)
+typedef HOST_TIME_US_SIG((*HostTimeUsFn));
+
 #ifdef __wasm__
 // for WASM the interface to the Host will be imported as externs from JS:
 extern HOST_LOG_SIG(HOST_LOG_NAME);
 extern HOST_SUBMIT_GEOMETRY_SIG(HOST_SUBMIT_GEOMETRY_NAME);
+extern HOST_SUBMIT_LAYER_SIG(HOST_SUBMIT_LAYER_NAME);
 extern HOST_LOAD_CHUNK_SIG(HOST_LOAD_CHUNK_NAME);
 extern HOST_STORE_CHUNK_SIG(HOST_STORE_CHUNK_NAME);
+extern HOST_TIME_US_SIG(HOST_TIME_US_NAME);
+
+// the WASM build is single-threaded, so parallel-for degrades to a
+// serial loop without crossing into JS
+static inline HOST_PARALLEL_FOR_SIG(HOST_PARALLEL_FOR_NAME) {
+  for (int i = 0; i < count; i++) {
+    task(i, ctx);
+  }
+}
+
+// likewise jobs run synchronously at submit; wait is a no-op on the
+// already-completed handle
+static inline HOST_JOB_SUBMIT_SIG(HOST_JOB_SUBMIT_NAME) {
+  task(ctx);
+  return 0;
+}
+
+static inline HOST_JOB_WAIT_SIG(HOST_JOB_WAIT_NAME) { (void)job; }
 #else
 // when compiled for native, the interface to the Host will be provided by the
 // host (in a call to game_set_host_functions):
 extern HostLogFn HOST_LOG_NAME;
 extern HostSubmitGeometryFn HOST_SUBMIT_GEOMETRY_NAME;
+extern HostSubmitLayerFn HOST_SUBMIT_LAYER_NAME;
 extern HostLoadChunkFn HOST_LOAD_CHUNK_NAME;
 extern HostStoreChunkFn HOST_STORE_CHUNK_NAME;
+extern HostParallelForFn HOST_PARALLEL_FOR_NAME;
+extern HostJobSubmitFn HOST_JOB_SUBMIT_NAME;
+extern HostJobWaitFn HOST_JOB_WAIT_NAME;
+extern HostTimeUsFn HOST_TIME_US_NAME;
 #endif
 
 // ============================================================================
@@ -84,8 +162,13 @@ extern HostStoreChunkFn HOST_STORE_CHUNK_NAME;
 #define GAME_SET_HOST_FUNCTIONS_SIG(name)                                      \
   void name(HostLogFn host_log_fn,                                             \
             HostSubmitGeometryFn host_submit_geometry_fn,                      \
+            HostSubmitLayerFn host_submit_layer_fn,                            \
             HostLoadChunkFn host_load_chunk_fn,                                \
-            HostStoreChunkFn host_store_chunk_fn)
+            HostStoreChunkFn host_store_chunk_fn,                              \
+            HostParallelForFn host_parallel_for_fn,                            \
+            HostJobSubmitFn host_job_submit_fn,                                \
+            HostJobWaitFn host_job_wait_fn,                                    \
+            HostTimeUsFn host_time_us_fn)
 typedef GAME_SET_HOST_FUNCTIONS_SIG((*GameSetHostFunctionsFn));
 #endif
 
@@ -105,8 +188,11 @@ typedef GAME_INIT_SIG((*GameInitFn));
 #define GAME_INPUT_SIG(name) void name(InputCommand command)
 typedef GAME_INPUT_SIG((*GameInputFn));
 
+// Returns true when anything visible changed this frame; hosts skip the
+// clear/render/present cycle entirely when it returns false, so an idle
+// game keeps showing the last presented frame instead of redrawing it
 #define GAME_FRAME_NAME game_frame
-#define GAME_FRAME_SIG(name) void name(double dt)
+#define GAME_FRAME_SIG(name) bool name(double dt)
 typedef GAME_FRAME_SIG((*GameFrameFn));
 
 #define GAME_RENDER_NAME game_render
@@ -115,6 +201,19 @@ typedef GAME_FRAME_SIG((*GameFrameFn));
             int atlas_width_px, int atlas_height_px)
 typedef GAME_RENDER_SIG((*GameRenderFn));
 
+// Input session recording / deterministic replay (see replay.h). The
+// game records every session; game_get_replay returns the recorded bytes
+// (valid until the next game_frame), and game_start_replay restarts the
+// world and re-executes a recording. Hosts own the file I/O.
+#define GAME_GET_REPLAY_NAME game_get_replay
+#define GAME_GET_REPLAY_SIG(name) size_t name(const void **data)
+typedef GAME_GET_REPLAY_SIG((*GameGetReplayFn));
+
+#define GAME_START_REPLAY_NAME game_start_replay
+#define GAME_START_REPLAY_SIG(name)                                            \
+  void name(const void *data, size_t data_size)
+typedef GAME_START_REPLAY_SIG((*GameStartReplayFn));
+
 #define GAME_CHUNK_STORED_NAME game_chunk_stored
 #define GAME_CHUNK_STORED_SIG(name) void name(uint64_t chunk_key, bool ok)
 typedef GAME_CHUNK_STORED_SIG((*GameChunkStoredFn));
@@ -0,0 +1,181 @@
+#include "autosave.h"
+#include "api.h"
+#include "chunk_dict.h"
+#include "utils/bbuf.h"
+#include "utils/sdefl.h"
+#include "world.h"
+
+// Record layout in host storage. Map chunk keys pack small (y << 32 | x)
+// coordinates (see calc_chunk_key in map.c), so a tag in the top byte
+// keeps the autosave key range disjoint from them
+#define AUTOSAVE_KEY_TAG (0xA5ull << 56)
+#define AUTOSAVE_KEY_MANIFEST AUTOSAVE_KEY_TAG
+#define AUTOSAVE_KEY_BASELINE (AUTOSAVE_KEY_TAG | 1)
+#define AUTOSAVE_KEY_DELTA(i) (AUTOSAVE_KEY_TAG | (2ull + (i)))
+
+#define AUTOSAVE_VERSION 1
+
+// Serialization scratch (matches CHUNK_BUFFER_SIZE in map.c)
+#define AUTOSAVE_BUFFER_SIZE (512 * 1024)
+
+// Records snapshot whole entities, so mark flips (marks have no dirty
+// bitsets) are captured whenever a data part of the same entity is
+// dirtied in the same turn -- true for every current mark site (combat
+// dirties Health alongside IsDead). A loader replays the baseline, then
+// the manifest's delta_count deltas in order; the last snapshot of an
+// entity wins, and a snapshot with an empty part bitset is a tombstone
+
+void autosave_accumulate_dirty(void) {
+  uint64_t *pending = WORLD.autosave.pending;
+#define DO_OR_DIRTY(name, type)                                                \
+  for (int w = 0; w < ENTITY_BITSET_WORDS; w++) {                              \
+    pending[w] |= WORLD.parts.name##DirtyBitset[w];                            \
+  }
+  FOREACH_PART(DO_OR_DIRTY)
+#undef DO_OR_DIRTY
+}
+
+void autosave_mark_entity(EntityIndex entity) {
+  bitset_set(WORLD.autosave.pending, entity);
+}
+
+void autosave_request_baseline(void) {
+  WORLD.autosave.baseline_written = false;
+}
+
+// One entity snapshot: index and generation (so handles stay valid across
+// a restore), then the part data via the X-macro serializer. A freed
+// entity has no part bits left and packs as a natural tombstone
+static void pack_entity_record(ByteBuffer *buf, EntityIndex entity) {
+  bbuf_pack_varint(buf, entity, "entity_index");
+  bbuf_pack_varint(buf, ENTITIES.generation[entity], "entity_generation");
+  entity_pack(entity, buf);
+}
+
+// Allocate a record scratch buffer with the preset dictionary placed
+// contiguously in front, so store_record can compress against it. The
+// caller brackets the arena allocations
+static ByteBuffer record_buffer(void) {
+  uint8_t *buffer =
+      arena_alloc(&WORLD.turn_arena, CHUNK_DICT_SIZE + AUTOSAVE_BUFFER_SIZE);
+  memcpy(buffer, chunk_dict(), CHUNK_DICT_SIZE);
+  return (ByteBuffer){.capacity = AUTOSAVE_BUFFER_SIZE,
+                      .data = buffer + CHUNK_DICT_SIZE};
+}
+
+// Compress and hand one record to the host (same sdefl pipeline as chunk
+// page-out in map.c; buf came from record_buffer, so the dictionary sits
+// right before buf->data)
+static void store_record(uint64_t key, const ByteBuffer *buf) {
+  int max_compressed_size = sdefl_bound(buf->size);
+  uint8_t *compressed = arena_alloc(&WORLD.turn_arena, max_compressed_size);
+  struct sdefl *sdefl_ctx = arena_alloc(&WORLD.turn_arena, sizeof(struct sdefl));
+  int compressed_size =
+      sdeflate_dict(sdefl_ctx, compressed, buf->data - CHUNK_DICT_SIZE,
+                    CHUNK_DICT_SIZE, buf->size, SDEFL_LVL_DEF);
+  host_store_chunk(key, compressed, compressed_size);
+}
+
+// The manifest names the consistent state to load: which baseline epoch
+// is current and how many deltas follow it. It is written after every
+// record, so stale deltas left over from before a rebaseline are simply
+// never replayed. Small and hot, so it is stored uncompressed
+static void store_manifest(void) {
+  uint8_t data[16];
+  ByteBuffer buf = {.capacity = sizeof(data), .data = data};
+  bbuf_pack_u32(&buf, AUTOSAVE_VERSION, "autosave_version");
+  bbuf_pack_u32(&buf, WORLD.autosave.baseline_epoch, "baseline_epoch");
+  bbuf_pack_u32(&buf, WORLD.autosave.delta_count, "delta_count");
+  host_store_chunk(AUTOSAVE_KEY_MANIFEST, buf.data, buf.size);
+}
+
+static void write_baseline(void) {
+  AutosaveState *as = &WORLD.autosave;
+  as->baseline_epoch++;
+  as->delta_count = 0;
+  as->baseline_written = true;
+  memset(as->pending, 0, sizeof(as->pending)); // superseded by the baseline
+
+  ArenaCheckpoint checkpoint = arena_checkpoint(&WORLD.turn_arena);
+  ByteBuffer buf = record_buffer();
+
+  bbuf_pack_u32(&buf, AUTOSAVE_VERSION, "autosave_version");
+  bbuf_pack_u32(&buf, as->baseline_epoch, "baseline_epoch");
+  bbuf_pack_u64(&buf, WORLD.rng_state, "rng_state");
+  bbuf_pack_u64(&buf, WORLD.world_seed, "world_seed");
+  bbuf_pack_u64(&buf, WORLD.tick_counter, "tick_counter");
+  bbuf_pack_u32(&buf, ENTITIES.count, "entities_count");
+  bbuf_pack_varint(&buf, ENTITIES.player._generation, "player_generation");
+  bbuf_pack_varint(&buf, ENTITIES.player._index, "player_index");
+  bbuf_pack_varint(&buf, ENTITIES.turn._generation, "turn_generation");
+  bbuf_pack_varint(&buf, ENTITIES.turn._index, "turn_index");
+
+  // every entity holding at least one part gets a record; freed and never
+  // allocated slots are implied by their absence
+  uint64_t present[ENTITY_BITSET_WORDS] = {0};
+#define DO_OR_BITSET(name)                                                     \
+  for (int w = 0; w < ENTITY_BITSET_WORDS; w++) {                              \
+    present[w] |= WORLD.parts.name##Bitset[w];                                 \
+  }
+#define DO_OR_PART(name, type) DO_OR_BITSET(name)
+  FOREACH_MARK(DO_OR_BITSET)
+  FOREACH_PART(DO_OR_PART)
+#undef DO_OR_BITSET
+#undef DO_OR_PART
+
+  uint32_t record_count = 0;
+  for (int w = 0; w < ENTITY_BITSET_WORDS; w++) {
+    record_count += (uint32_t)__builtin_popcountll(present[w]);
+  }
+  bbuf_pack_varint(&buf, record_count, "record_count");
+  BITSET_QUERY(i, present) { pack_entity_record(&buf, i); }
+
+  store_record(AUTOSAVE_KEY_BASELINE, &buf);
+  arena_restore(&WORLD.turn_arena, checkpoint);
+}
+
+static void write_delta(void) {
+  AutosaveState *as = &WORLD.autosave;
+
+  ArenaCheckpoint checkpoint = arena_checkpoint(&WORLD.turn_arena);
+  ByteBuffer buf = record_buffer();
+
+  bbuf_pack_u32(&buf, AUTOSAVE_VERSION, "autosave_version");
+  bbuf_pack_u32(&buf, as->baseline_epoch, "baseline_epoch");
+
+  uint32_t record_count = 0;
+  for (int w = 0; w < ENTITY_BITSET_WORDS; w++) {
+    record_count += (uint32_t)__builtin_popcountll(as->pending[w]);
+  }
+  bbuf_pack_varint(&buf, record_count, "record_count");
+  BITSET_QUERY(i, as->pending) { pack_entity_record(&buf, i); }
+
+  store_record(AUTOSAVE_KEY_DELTA(as->delta_count), &buf);
+  arena_restore(&WORLD.turn_arena, checkpoint);
+
+  as->delta_count++;
+  memset(as->pending, 0, sizeof(as->pending));
+}
+
+void autosave_turn(void) {
+  AutosaveState *as = &WORLD.autosave;
+
+  // pick up changes made earlier this frame (the turn's own actions);
+  // dirty bits stay set until the next frame start, so an entity already
+  // snapshotted here just packs one redundant record in the next delta
+  autosave_accumulate_dirty();
+
+  if (!as->baseline_written || as->delta_count >= AUTOSAVE_REBASE_DELTAS) {
+    write_baseline();
+  } else {
+    uint64_t any = 0;
+    for (int w = 0; w < ENTITY_BITSET_WORDS; w++) {
+      any |= as->pending[w];
+    }
+    if (any == 0) {
+      return; // quiet turn, no record
+    }
+    write_delta();
+  }
+  store_manifest();
+}
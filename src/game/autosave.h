@@ -0,0 +1,45 @@
+#pragma once
+
+#include "common.h"
+
+// Incremental autosave built on the per-part dirty bitsets: instead of
+// re-serializing the whole world every save, a baseline record holding
+// every live entity is written once, then each turn appends a small delta
+// record holding only the entities whose parts changed that turn. After
+// AUTOSAVE_REBASE_DELTAS deltas a fresh baseline is written and the delta
+// chain restarts, bounding how many records a load has to replay. Records
+// go through host_store_chunk under a reserved key range, so per-turn cost
+// scales with what actually changed -- usually a handful of entities --
+// not with MAX_ENTITIES
+
+// Delta records written against a baseline before a fresh one is taken
+#define AUTOSAVE_REBASE_DELTAS 64
+
+typedef struct {
+  // entities touched since the last record: every part dirty bitset is
+  // ORed in once per frame before parts_clear_dirty wipes them, plus
+  // freed entities reported through on_entity_free (freeing clears part
+  // bits without flagging them dirty)
+  uint64_t pending[ENTITY_BITSET_WORDS];
+
+  uint32_t delta_count;    // deltas written against the current baseline
+  uint32_t baseline_epoch; // bumped per baseline; stamped into every record
+  bool baseline_written;
+} AutosaveState;
+
+// fold the current part dirty bitsets into the pending set. called at the
+// start of each frame, before parts_clear_dirty
+void autosave_accumulate_dirty(void);
+
+// flag one entity as needing a snapshot in the next delta record (used by
+// on_entity_free, since freed entities leave no dirty bits behind)
+void autosave_mark_entity(EntityIndex entity);
+
+// force a fresh baseline on the next autosave_turn. used after bulk
+// rewrites that bypass per-entity dirty tracking (like window shifts)
+void autosave_request_baseline(void);
+
+// write this turn's autosave record: a delta of the pending entities, or
+// a fresh baseline when none exists yet or the delta chain is full.
+// called once per turn from process_turn_entity
+void autosave_turn(void);
@@ -0,0 +1,38 @@
+#include "chunk_dict.h"
+#include "map.h"
+#include "render_api.h"
+
+// Hand-assembled from the byte runs that dominate serialized records (see
+// serialize_chunk in map.c and pack_entity_record in autosave.c):
+//   - zero runs: empty part structs, tombstone part bitsets, zero water
+//     depth, small varints
+//   - the default cell + water unit that untouched tiles serialize as
+// Patterns the payload actually repeats internally still win via normal
+// in-stream matches; the dictionary only helps the first occurrence, which
+// is what small records consist of.
+//
+// Lives in a plain static like the geometry builder in game.c: losing it
+// on hot-reload just costs one rebuild, and the build is deterministic so
+// every reload (and both hosts) produce identical bytes
+static uint8_t dict[CHUNK_DICT_SIZE];
+static bool dict_ready;
+
+const uint8_t *chunk_dict(void) {
+  if (!dict_ready) {
+    // back half: repeating default-cell delta unit (MapCell + water byte),
+    // placed closest to the payload so its match distances stay short
+    MapCell cell = {.passable = 1, .tile = TILE_NONE};
+    uint8_t unit[sizeof(MapCell) + 1];
+    memcpy(unit, &cell, sizeof(cell));
+    unit[sizeof(cell)] = 0;
+
+    uint32_t pos = CHUNK_DICT_SIZE / 2;
+    while (pos + sizeof(unit) <= CHUNK_DICT_SIZE) {
+      memcpy(&dict[pos], unit, sizeof(unit));
+      pos += sizeof(unit);
+    }
+    // front half stays zero: one maximal run covering zeroed part data
+    dict_ready = true;
+  }
+  return dict;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "common.h"
+
+// Preset deflate dictionary shared by every serialized record in chunk
+// storage. Each record compresses in isolation, so small records (sparse
+// chunk deltas, autosave deltas) have no history to match against; priming
+// the window with the byte patterns that dominate serialized records gives
+// them back-references from the first byte. The dictionary is fixed per
+// format version: both sides must prime with the identical bytes, and
+// streams compressed without it still decode unchanged (they never reach
+// back into the history)
+#define CHUNK_DICT_SIZE 1024
+
+// the dictionary bytes (built deterministically on first use)
+const uint8_t *chunk_dict(void);
@@ -95,6 +95,7 @@ static inline float clamp_float(float x, float min, float max) {
 }
 
 void output_message(const char *text);
+const char *message_get(uint32_t index); // 0 = oldest, count-1 = newest
 
 // ============================================================================
 // Static max Map dimensions
@@ -1,8 +1,24 @@
 #include "../world.h"
 
 void on_entity_free(EntityIndex entity) {
+  // freeing clears part bits without flagging them dirty, so report the
+  // entity to the autosave pending set directly (packs as a tombstone)
+  autosave_mark_entity(entity);
+
   // Part:TurnSchedule Event:on_entity_free
   if (HAS_PART(TurnSchedule, entity)) {
     turn_queue_remove(entity);
   }
+
+  // Part:Position Event:on_entity_free
+  if (HAS_PART(Position, entity)) {
+    spatial_index_remove(entity);
+  }
+
+  // Part:Parent Event:on_entity_free
+  if (HAS_PART(Parent, entity)) {
+    // descendants are freed along with their ancestors, so every freed
+    // entity's child list empties out as the children unlink themselves
+    hierarchy_remove_parent(entity);
+  }
 }
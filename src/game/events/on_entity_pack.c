@@ -1,3 +1,10 @@
 #include "../world.h" // IWYU pragma: keep
 
-void on_entity_pack(EntityIndex entity) { (void)entity; }
+void on_entity_pack(EntityIndex entity) {
+  // Part:EffectiveAttributes Event:on_entity_pack
+  // derived cache keyed to this session's attributes_epoch, so it must
+  // not persist; dropped here and recomputed on demand after unpacking
+  if (HAS_PART(EffectiveAttributes, entity)) {
+    REMOVE_PART(EffectiveAttributes, entity);
+  }
+}
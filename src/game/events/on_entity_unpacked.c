@@ -7,4 +7,9 @@ void on_entity_unpacked(EntityIndex entity) {
     DISABLE_PART(TurnSchedule, entity);
     turn_queue_insert(entity, delay);
   }
+
+  // Part:Position Event:on_entity_unpacked
+  if (HAS_PART(Position, entity)) {
+    spatial_index_insert(entity);
+  }
 }
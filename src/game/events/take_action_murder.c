@@ -1,8 +1,42 @@
+#include "../actions/actions.h"
 #include "../world.h"
 
+static int32_t chase_cost(void *ctx, int sx, int sy, int tx, int ty) {
+  (void)ctx, (void)sx, (void)sy; // Unused
+  return MAP_PASSABLE(tx, ty) ? 10 : ASTAR_COST_INFINITE;
+}
+
 void entity_event_take_action_murder(EntityIndex entity, Goal *goal) {
-  if (entity_is_alive(goal->target_entity)) {
+  if (!entity_is_alive(goal->target_entity)) {
+    goal->is_finished = true;
+    return;
+  }
+
+  EntityIndex target = entity_handle_to_index(goal->target_entity);
+  if (!HAS_PART(Position, entity) || !HAS_PART(Position, target)) {
     goal->is_finished = true;
     return;
   }
-}
\ No newline at end of file
+
+  Position *pos = &PART(Position, entity);
+  Position target_pos = PART(Position, target);
+
+  // Replay the cached path while it is still valid
+  int dir = goal_path_next(goal, target_pos);
+  if (dir < 0) {
+    // Cache miss: repath and refill the cache with the leading moves
+    Direction moves[ASTAR_PATH_MAX_LENGTH];
+    int count = hpa_find_path(NULL, chase_cost, pos->x, pos->y, target_pos.x,
+                              target_pos.y, moves);
+    if (count <= 0) {
+      return; // no path this turn; stand still
+    }
+    goal_path_store(goal, target_pos, moves, count);
+    dir = goal_path_next(goal, target_pos);
+  }
+
+  if (dir >= 0) {
+    // action_move resolves into an attack when we bump the target
+    action_move(entity, (Direction)dir);
+  }
+}
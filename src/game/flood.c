@@ -1,5 +1,6 @@
 #include "flood.h"
 #include "random.h"
+#include "world.h"
 
 #define MAX_DEPTH 255
 #define BOUNDARY_DEPTH 199
@@ -11,7 +12,7 @@ static uint8_t temp_depth[MAP_WIDTH_MAX * MAP_HEIGHT_MAX];
 
 // Helper to check if a cell is solid (impassable)
 static inline bool is_solid(Map *map, int x, int y) {
-  return !map->cells[IX(x, y)].passable;
+  return !map_is_passable(map, x, y);
 }
 
 void flood_simulate_step(Map *map) {
@@ -114,3 +115,104 @@ void flood_simulate_step(Map *map) {
   // Copy back
   memcpy(map->water_depth, temp_depth, sizeof(temp_depth));
 }
+
+// ============================================================================
+// Connected-region labels
+// ============================================================================
+
+// Horizontal span of tiles queued by the scanline fill
+typedef struct {
+  int x1, x2; // inclusive span on row y
+  int y;
+  int dy; // row direction to scan from this span (+1 or -1)
+} FillSpan;
+
+// A tile joins the fill if it is passable and not yet labeled
+static inline bool fill_inside(RegionLabels *regions, int x, int y) {
+  return x >= 0 && x < WORLD.map.width && y >= 0 && y < WORLD.map.height &&
+         map_is_passable(&WORLD.map, x, y) &&
+         regions->labels[IX(x, y)] == REGION_NONE;
+}
+
+// Scanline flood fill: labels whole horizontal runs at a time and only
+// queues spans for the rows above and below, instead of visiting every
+// tile through a per-cell queue
+static void fill_region(RegionLabels *regions, int seed_x, int seed_y,
+                        uint16_t label) {
+  ArenaCheckpoint checkpoint = arena_checkpoint(&WORLD.frame_arena);
+  FillSpan *stack = arena_alloc(
+      &WORLD.frame_arena, 2 * MAP_WIDTH_MAX * MAP_HEIGHT_MAX * sizeof(FillSpan));
+  int top = 0;
+
+  stack[top++] = (FillSpan){seed_x, seed_x, seed_y, 1};
+  stack[top++] = (FillSpan){seed_x, seed_x, seed_y - 1, -1};
+
+  while (top > 0) {
+    FillSpan span = stack[--top];
+    int x = span.x1;
+    if (fill_inside(regions, x, span.y)) {
+      // Extend left past the parent span's edge
+      while (fill_inside(regions, x - 1, span.y)) {
+        regions->labels[IX(x - 1, span.y)] = label;
+        x--;
+      }
+      if (x < span.x1) {
+        stack[top++] = (FillSpan){x, span.x1 - 1, span.y - span.dy, -span.dy};
+      }
+    }
+    while (span.x1 <= span.x2) {
+      // Label one run and queue the row ahead of it
+      while (fill_inside(regions, span.x1, span.y)) {
+        regions->labels[IX(span.x1, span.y)] = label;
+        span.x1++;
+      }
+      if (span.x1 > x) {
+        stack[top++] = (FillSpan){x, span.x1 - 1, span.y + span.dy, span.dy};
+      }
+      if (span.x1 - 1 > span.x2) {
+        stack[top++] =
+            (FillSpan){span.x2 + 1, span.x1 - 1, span.y - span.dy, -span.dy};
+      }
+      // Skip the blocked gap to the next run inside the parent span
+      span.x1++;
+      while (span.x1 < span.x2 && !fill_inside(regions, span.x1, span.y)) {
+        span.x1++;
+      }
+      x = span.x1;
+    }
+  }
+
+  arena_restore(&WORLD.frame_arena, checkpoint);
+}
+
+static void rebuild_regions(void) {
+  RegionLabels *regions = &WORLD.regions;
+  memset(regions->labels, 0, sizeof(regions->labels));
+  regions->count = 0;
+  regions->map_counter = WORLD.map.change_counter;
+  regions->valid = true;
+
+  for (int y = 0; y < WORLD.map.height; y++) {
+    for (int x = 0; x < WORLD.map.width; x++) {
+      if (fill_inside(regions, x, y)) {
+        fill_region(regions, x, y, ++regions->count);
+      }
+    }
+  }
+}
+
+uint16_t flood_region_label(int x, int y) {
+  if (x < 0 || y < 0 || x >= WORLD.map.width || y >= WORLD.map.height) {
+    return REGION_NONE;
+  }
+  RegionLabels *regions = &WORLD.regions;
+  if (!regions->valid || regions->map_counter != WORLD.map.change_counter) {
+    rebuild_regions();
+  }
+  return regions->labels[IX(x, y)];
+}
+
+bool flood_same_region(int ax, int ay, int bx, int by) {
+  uint16_t label = flood_region_label(ax, ay);
+  return label != REGION_NONE && label == flood_region_label(bx, by);
+}
@@ -4,3 +4,28 @@
 
 // Simulate one timestep of water flow
 void flood_simulate_step(Map *map);
+
+// ============================================================================
+// Connected-region labels (scanline flood fill over the passable plane)
+// ============================================================================
+//
+// Every connected group of passable tiles shares one label, so
+// connectivity queries like "can A reach B" are two O(1) lookups
+// instead of a fresh flood fill. The labels rebuild lazily when the
+// map change counter moves.
+
+#define REGION_NONE 0
+
+typedef struct {
+  bool valid;
+  uint32_t map_counter; // map change counter the labels were built at
+  uint16_t count;       // number of regions (labels 1..count)
+  uint16_t labels[MAP_WIDTH_MAX * MAP_HEIGHT_MAX];
+} RegionLabels;
+
+// Label of the passable region containing (x, y), or REGION_NONE for
+// impassable or out-of-bounds tiles
+uint16_t flood_region_label(int x, int y);
+
+// True when both tiles lie in the same connected passable region
+bool flood_same_region(int ax, int ay, int bx, int by);
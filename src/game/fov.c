@@ -1,5 +1,6 @@
 #include "fov.h"
 #include "common.h"
+#include "world.h"
 
 // Adapted from: http://www.roguebasin.com/index.php?title=Spiral_Path_FOV
 
@@ -187,13 +188,26 @@ void fov_compute(Map *map, int origin_x, int origin_y, int radius) {
     radius = MAX_RADIUS - 1;
   }
 
-  // Clear all visible flags
-  for (int y = 0; y < map->height; ++y) {
-    for (int x = 0; x < map->width; ++x) {
-      map->cells[y * MAP_WIDTH_MAX + x].visible = 0;
-    }
+  // Skip the recompute entirely when nothing it depends on changed
+  // (e.g. the player bumped a wall or spent a turn waiting)
+  FovCache *cache = &WORLD.fov_cache;
+  if (cache->valid && cache->origin_x == origin_x &&
+      cache->origin_y == origin_y && cache->radius == radius &&
+      cache->map_counter == map->change_counter) {
+    return;
   }
 
+  // Clearing the visible plane is a few dozen word writes
+  memset(map->visible_bits, 0, sizeof(map->visible_bits));
+
+  *cache = (FovCache){
+      .valid = true,
+      .origin_x = origin_x,
+      .origin_y = origin_y,
+      .radius = radius,
+      .map_counter = map->change_counter,
+  };
+
   int arc_start = 0;
   int arc_end = MAX_ANGLE;
 
@@ -203,7 +217,7 @@ void fov_compute(Map *map, int origin_x, int origin_y, int radius) {
   // Origin is always visible
   if (origin_x >= 0 && origin_x < map->width && origin_y >= 0 &&
       origin_y < map->height) {
-    map->cells[origin_y * MAP_WIDTH_MAX + origin_x].visible = 1;
+    map_set_visible(map, origin_x, origin_y);
   }
 
   // Starting set: 4 squares at manhattan distance 1
@@ -241,14 +255,14 @@ void fov_compute(Map *map, int origin_x, int origin_y, int radius) {
       int world_y = origin_y + cur_y;
       if (world_x >= 0 && world_x < map->width && world_y >= 0 &&
           world_y < map->height) {
-        map->cells[world_y * MAP_WIDTH_MAX + world_x].visible = 1;
+        map_set_visible(map, world_x, world_y);
       }
 
       // Check if blocked (use passable flag inverted)
       bool blocked = false;
       if (world_x >= 0 && world_x < map->width && world_y >= 0 &&
           world_y < map->height) {
-        blocked = !map->cells[world_y * MAP_WIDTH_MAX + world_x].passable;
+        blocked = !map_is_passable(map, world_x, world_y);
       }
 
       if (!blocked) {
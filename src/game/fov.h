@@ -8,6 +8,17 @@
 #define PLAYER_FOV_RADIUS 20
 #define PLAYER_TORCH_RADIUS 20
 
+// What the last fov_compute ran against, so unchanged recomputes can be
+// skipped and the stale visible flags cleared region-wise instead of
+// wiping the whole map (validated lazily against map.change_counter)
+typedef struct {
+  bool valid;
+  int origin_x;
+  int origin_y;
+  int radius;
+  uint32_t map_counter;
+} FovCache;
+
 // Compute field of view from origin position
 // Sets the visible flag on all tiles within line of sight
 // Uses the passable flag to determine blocking (non-passable blocks sight)
@@ -2,6 +2,7 @@
 #include "ai/ai.h"
 #include "ai/astar.h"
 #include "api.h"
+#include "autosave.h"
 #include "common.h"
 #include "flood.h"
 #include "fov.h"
@@ -10,6 +11,7 @@
 #include "parts.h"
 #include "random.h"
 #include "render_api.h"
+#include "replay.h"
 #include "turn_queue.h"
 #include "utils/print.h"
 #include "world.h"
@@ -31,23 +33,43 @@ HostLogFn host_log;
 HostSubmitGeometryFn host_submit_geometry;
 HostLoadChunkFn host_load_chunk;
 HostStoreChunkFn host_store_chunk;
+HostParallelForFn host_parallel_for;
+HostJobSubmitFn host_job_submit;
+HostJobWaitFn host_job_wait;
+HostTimeUsFn host_time_us;
+HostSubmitLayerFn host_submit_layer;
 
 GAME_SET_HOST_FUNCTIONS_SIG(GAME_SET_HOST_FUNCTIONS_NAME) {
   host_log = host_log_fn;
   host_submit_geometry = host_submit_geometry_fn;
+  host_submit_layer = host_submit_layer_fn;
   host_load_chunk = host_load_chunk_fn;
   host_store_chunk = host_store_chunk_fn;
+  host_parallel_for = host_parallel_for_fn;
+  host_job_submit = host_job_submit_fn;
+  host_job_wait = host_job_wait_fn;
+  host_time_us = host_time_us_fn;
 }
 
 #endif
 
 GAME_GET_MEMORY_SIZE_SIG(GAME_GET_MEMORY_SIZE_NAME) {
-  return sizeof(WorldState);
+  // world struct plus the arena backing stores appended after it
+  return sizeof(WorldState) + FRAME_ARENA_SIZE + TURN_ARENA_SIZE;
 }
 
 GAME_SET_MEMORY_SIG(GAME_SET_MEMORY_NAME) {
-  assert(size >= sizeof(WorldState));
+  assert(size >= sizeof(WorldState) + FRAME_ARENA_SIZE + TURN_ARENA_SIZE);
   active_world = (WorldState *)buf;
+
+  // rebind the arena backing stores on every (re)load: they sit past the
+  // world struct in host memory, and the block can move when the host
+  // reallocates it (offsets and high-water marks persist in the struct)
+  uint8_t *scratch = (uint8_t *)(active_world + 1);
+  WORLD.frame_arena.buffer = scratch;
+  WORLD.frame_arena.capacity = FRAME_ARENA_SIZE;
+  WORLD.turn_arena.buffer = scratch + FRAME_ARENA_SIZE;
+  WORLD.turn_arena.capacity = TURN_ARENA_SIZE;
 }
 
 GAME_CHUNK_LOADED_SIG(GAME_CHUNK_LOADED_NAME) {
@@ -90,7 +112,7 @@ GAME_CHUNK_LOADED_SIG(GAME_CHUNK_LOADED_NAME) {
     output_message(msg.data);
 
     WORLD.worldmap.chunks[world_chunk_idx].state = CHUNK_UNLOADED;
-    generate_chunk(chunk_x, chunk_y);
+    map_queue_generate_chunk(chunk_x, chunk_y);
   }
 }
 
@@ -110,12 +132,13 @@ GAME_CHUNK_STORED_SIG(GAME_CHUNK_STORED_NAME) {
 static int32_t test_pathfinding_cost(void *ctx, int sx, int sy, int tx,
                                      int ty) {
   (void)ctx, (void)sx, (void)sy; // Unused
-  return MAP(tx, ty).passable ? 10 : ASTAR_COST_INFINITE;
+  return MAP_PASSABLE(tx, ty) ? 10 : ASTAR_COST_INFINITE;
 }
 // ========================================================================
 
 static void particle_emit_system_tick() {
-  WORLD_QUERY(i, BITS(ParticleEmitter)) {
+  CachedQuery *emitters = query_cache_get1(PART_TYPE_ParticleEmitter);
+  CACHED_QUERY(i, emitters) {
     EntityIndex pos_index = get_position_ancestor(i);
     if (!pos_index) {
       // can't spawn without position
@@ -129,7 +152,8 @@ static void particle_emit_system_tick() {
       float x = (float)pos->x + 0.5f;
       float y = (float)pos->y + 0.5f;
       particles_spawn(&WORLD.particles, pe->particle_type, x, y);
-      pe->countdown_ticks = particles_gen_spawn_interval(pe->particle_type);
+      pe->countdown_ticks =
+          particles_gen_spawn_interval(&WORLD.particles, pe->particle_type);
     }
   }
 }
@@ -145,34 +169,67 @@ static EntityIndex spawn_player(void) {
 
   EntityIndex player = entity_alloc();
   ADD_PART(Position, player, pos);
+  spatial_index_insert(player);
   ADD_PART(Health, player, HEALTH_FULL);
+  ADD_PART(LightSource, player, PLAYER_TORCH_RADIUS); // carried torch
   turn_queue_insert(player, 0);
   return player;
 }
 
-static EntityIndex spawn_monster(void) {
-  Position pos;
-  if (!map_get_random_passable(&WORLD.map, MAP_CHUNK_WIDTH, MAP_CHUNK_WIDTH,
-                               MAP_CHUNK_WIDTH, MAP_CHUNK_WIDTH, &pos, 100)) {
-    // Failed to find passable position, don't spawn
-    return 0;
+#define SPAWN_BATCH_MAX 16
+
+static void spawn_monsters(uint16_t count) {
+  assert(count <= SPAWN_BATCH_MAX);
+
+  // find positions first so failed placements just shrink the batch
+  Position positions[SPAWN_BATCH_MAX];
+  uint16_t placed = 0;
+  for (uint16_t i = 0; i < count; i++) {
+    if (map_get_random_passable(&WORLD.map, MAP_CHUNK_WIDTH, MAP_CHUNK_WIDTH,
+                                MAP_CHUNK_WIDTH, MAP_CHUNK_WIDTH,
+                                &positions[placed], 100)) {
+      placed++;
+    }
   }
 
-  EntityIndex monster = entity_alloc();
-  ADD_PART(Position, monster, pos);
-  ADD_PART(Health, monster, HEALTH_FULL);
-  turn_queue_insert(monster, 0);
-  return monster;
+  // reserve a contiguous index range, fill part arrays directly, then
+  // commit each part's bits for the whole range in one pass
+  EntityBatch batch = entity_batch_alloc(placed);
+  for (uint16_t i = 0; i < placed; i++) {
+    EntityIndex monster = batch.first + i;
+    PART(Position, monster) = positions[i];
+    PART(Health, monster) = HEALTH_FULL;
+  }
+  ENTITY_BATCH_ENABLE_PART(Position, batch);
+  ENTITY_BATCH_ENABLE_PART(Health, batch);
+
+  for (uint16_t i = 0; i < placed; i++) {
+    EntityIndex monster = batch.first + i;
+    spatial_index_insert(monster);
+    turn_queue_insert(monster, 0);
+  }
 }
 
 GAME_INIT_SIG(GAME_INIT_NAME) {
-  WORLD.rng_state = rng_seed;
+  // capture the session for deterministic replay (no-op when a replay is
+  // the one driving this init)
+  replay_record_start(rng_seed);
 
-  // Initialize arena allocator
-  WORLD.arena = (Arena){
-      .buffer = WORLD.arena_buffer,
-      .capacity = sizeof(WORLD.arena_buffer),
-      .offset = 0,
+  WORLD.rng_state = rng_seed;
+  WORLD.world_seed = rng_seed;
+  WORLD.frame_damage = true; // always draw the first frame
+  WORLD.particles.rng_key = random_key(rng_seed, 'P');
+
+  // Initialize the scratch arenas (backing stores sit past the world
+  // struct; rebind here too since a replay restart memsets the world)
+  uint8_t *scratch = (uint8_t *)(active_world + 1);
+  WORLD.frame_arena = (Arena){
+      .buffer = scratch,
+      .capacity = FRAME_ARENA_SIZE,
+  };
+  WORLD.turn_arena = (Arena){
+      .buffer = scratch + FRAME_ARENA_SIZE,
+      .capacity = TURN_ARENA_SIZE,
   };
 
   // entity at index 0 should not be used (index 0 means "no entity")
@@ -200,14 +257,13 @@ GAME_INIT_SIG(GAME_INIT_NAME) {
       WORLD.map.cells[y * MAP_WIDTH_MAX + x].tile = TILE_NONE;
     }
   }
+  map_mark_changed(); // sync the bit planes before spawn placement reads them
 
   // Spawn player and monsters in random passable positions
   ENTITIES.player = entity_handle_from_index(spawn_player());
 
 #if 1
-  spawn_monster();
-  spawn_monster();
-  spawn_monster();
+  spawn_monsters(3);
 #endif
 
   // Force terrain generation and initial FOV calculation
@@ -222,6 +278,10 @@ static void game_tick(uint64_t tick) {
   flood_simulate_step(&WORLD.map);
 }
 
+// Minimum freelist size before a between-turns compaction is worth the
+// remap cost (it also has to be at least a quarter of the populated range)
+#define COMPACT_MIN_FREE_SLOTS 64
+
 static void process_turn_entity(void) {
   EntityIndex entity = entity_handle_to_index(ENTITIES.turn);
   turn_queue_add_delay(entity, TURN_INTERVAL);
@@ -230,16 +290,36 @@ static void process_turn_entity(void) {
   // delay just growing endlessly. it would work even if it did grow endlessly,
   // since we just always schedule the entity with the lowest delay (remember
   // actions add their cost to the entity's delay)
-  WORLD_QUERY(i, BITS(TurnSchedule)) {
+  CachedQuery *scheduled = query_cache_get1(PART_TYPE_TurnSchedule);
+  CACHED_QUERY(i, scheduled) {
     PART(TurnSchedule, i).delay -= TURN_INTERVAL;
   }
+  // a uniform shift keeps relative order, so the calendar queue just
+  // moves its anchor instead of rebucketing anything
+  turn_queue_rebase(-TURN_INTERVAL);
 
   // TODO: per-turn logic (regen, DOTs, cooldowns, etc.)
+
+  // Dead NPCs and paged-out chunks leave freelist holes that queries and
+  // batch scans keep paying for; compact once a meaningful fraction of
+  // the populated range is free. Runs before the autosave so the fresh
+  // baseline it requests is written this same turn
+  if (ENTITIES.freelist_count >= COMPACT_MIN_FREE_SLOTS &&
+      ENTITIES.freelist_count * 4 >= ENTITIES.count) {
+    entities_compact();
+  }
+
+  // Incremental autosave: snapshot only the entities this turn touched
+  autosave_turn();
 }
 
 static void execute_player_action(InputCommand command) {
   EntityIndex player = entity_handle_to_index(ENTITIES.player);
 
+  // The player is about to change the world; NPC decisions made against
+  // the old state are stale
+  memset(WORLD.npc_plan, 0, sizeof(WORLD.npc_plan));
+
   // TODO: implement actual actions
   // For now, just basic movement/wait
   switch (command) {
@@ -260,19 +340,286 @@ static void execute_player_action(InputCommand command) {
     WORLD.debug_show_light_values = !WORLD.debug_show_light_values;
     break;
 
+  case INPUT_CMD_P:
+    // Toggle part stats overlay (and dump a full report to the log)
+    WORLD.debug_show_part_stats = !WORLD.debug_show_part_stats;
+    if (WORLD.debug_show_part_stats) {
+      parts_debug_dump();
+    }
+    break;
+
+  case INPUT_CMD_T:
+    // Toggle profiler overlay; dump the collected trace when turning it
+    // off (the session between toggles is what was being inspected)
+    WORLD.debug_show_profile = !WORLD.debug_show_profile;
+    if (!WORLD.debug_show_profile) {
+      profile_dump_trace();
+    }
+    break;
+
   default:
     break;
   }
 }
 
+// AI level of detail: NPCs farther than this (manhattan) from the player
+// drop to coarse simulation, well outside PLAYER_FOV_RADIUS so the player
+// never sees the difference. They promote back to full simulation
+// automatically the next time they come up inside the radius.
+#define AI_LOD_RADIUS (PLAYER_FOV_RADIUS + 8)
+
+// Coarse-tier NPCs act once per this many turns, catching up in bulk
+#define AI_LOD_TURNS 4
+
+// Aggregate AI_LOD_TURNS moves into one scheduling slot: walk several
+// flow field steps at once without animating (teleport-along-path).
+// This keeps turn resolution flat as entity counts grow, since distant
+// entities hit the queue AI_LOD_TURNS times less often.
+static void process_npc_turn_coarse(EntityIndex entity) {
+  Position pos = PART(Position, entity);
+  for (int step = 0; step < AI_LOD_TURNS; step++) {
+    int dir = flowfield_direction(pos.x, pos.y);
+    if (dir < 0) {
+      break; // unreachable or stale field; idle in place
+    }
+    int x = pos.x + dir_dx((Direction)dir);
+    int y = pos.y + dir_dy((Direction)dir);
+    if (!MAP_PASSABLE(x, y)) {
+      break;
+    }
+    bool occupied = false;
+    TILE_ENTITIES_QUERY(i, x, y) { occupied = true; }
+    if (occupied) {
+      break; // no combat at coarse distance; resolve when promoted
+    }
+    pos = (Position){x, y};
+    spatial_index_move(entity, pos);
+  }
+  turn_queue_add_delay(entity, AI_LOD_TURNS * TURN_INTERVAL);
+}
+
+static void ensure_flowfield(void) {
+  if (!WORLD.flowfield.valid) {
+    // Field went stale (map change) without a player move; rebuild once
+    EntityIndex player_idx = entity_handle_to_index(ENTITIES.player);
+    if (HAS_PART(Position, player_idx)) {
+      Position *player_pos = &PART(Position, player_idx);
+      flowfield_build(player_pos->x, player_pos->y);
+    }
+  }
+}
+
+// Decide phase task: pick a move for one NPC. Runs concurrently across
+// host worker threads, so it only reads world state and writes its own
+// npc_plan slot. The random-wander fallback stays in the serial apply
+// phase since the RNG state is shared.
+static void npc_decide_task(int index, void *ctx) {
+  EntityIndex *batch = ctx;
+  EntityIndex entity = batch[index];
+  Position *pos = &PART(Position, entity);
+  int dir = flowfield_direction(pos->x, pos->y);
+  WORLD.npc_plan[entity] = dir < 0 ? 0 : (uint8_t)(dir + 1);
+}
+
+// Fan the move decision for every NPC due this round out across host
+// worker threads. Application stays serial in turn order
+// (process_npc_turn), so actions still resolve deterministically; a
+// decision can be one apply out of date, which the bump-resolution in
+// action_move absorbs.
+static void npc_decide_phase(void) {
+  // everything due this round shares the head's delay, which in the
+  // calendar queue means they all sit in the cursor bucket (peek just
+  // advanced the cursor to the minimum)
+  turn_queue_peek();
+  EntityIndex player = entity_handle_to_index(ENTITIES.player);
+  EntityIndex turn = entity_handle_to_index(ENTITIES.turn);
+
+  ArenaCheckpoint checkpoint = arena_checkpoint(&WORLD.frame_arena);
+  EntityIndex *batch = arena_alloc(&WORLD.frame_arena,
+                                   WORLD.turn_queue.count * sizeof(EntityIndex));
+  int batch_count = 0;
+  for (EntityIndex entity =
+           WORLD.turn_queue.bucket_head[WORLD.turn_queue.cursor];
+       entity != 0; entity = WORLD.turn_queue.next[entity]) {
+    if (entity == player || entity == turn || !HAS_PART(Position, entity)) {
+      continue;
+    }
+    batch[batch_count++] = entity;
+  }
+
+  if (batch_count > 0) {
+    ensure_flowfield(); // build serially before the tasks read it
+    host_parallel_for(npc_decide_task, batch_count, batch);
+  }
+  arena_restore(&WORLD.frame_arena, checkpoint);
+}
+
 static void process_npc_turn(EntityIndex entity) {
-  // TODO: AI logic for NPCs
-  // For now, just wait
+  if (HAS_PART(Position, entity)) {
+    ensure_flowfield();
+
+    Position *pos = &PART(Position, entity);
+
+    // Coarse tier for NPCs far outside the player's view
+    EntityIndex player_idx = entity_handle_to_index(ENTITIES.player);
+    if (HAS_PART(Position, player_idx)) {
+      Position *player_pos = &PART(Position, player_idx);
+      int dx = pos->x > player_pos->x ? pos->x - player_pos->x
+                                      : player_pos->x - pos->x;
+      int dy = pos->y > player_pos->y ? pos->y - player_pos->y
+                                      : player_pos->y - pos->y;
+      if (dx + dy > AI_LOD_RADIUS) {
+        WORLD.npc_plan[entity] = 0; // coarse tier walks the field itself
+        process_npc_turn_coarse(entity);
+        return;
+      }
+    }
+
+    // Use the move from the decide phase, falling back to an inline
+    // lookup for entities that were not due when the phase ran
+    int dir;
+    uint8_t plan = WORLD.npc_plan[entity];
+    if (plan) {
+      WORLD.npc_plan[entity] = 0;
+      dir = plan - 1;
+    } else {
+      dir = flowfield_direction(pos->x, pos->y);
+    }
+    if (dir >= 0) {
+      action_move(entity, (Direction)dir);
+      return;
+    }
+  }
+
+  // No path to the player; wander randomly
   action_move(entity, random64() % 8);
 }
 
+// Capture everything the renderer consumes from this frame into the
+// back snapshot buffer, then flip it to the front (see RenderSnapshot).
+// Sprites are gated on the FOV plane: an out-of-sight entity costs one
+// bit test here and nothing downstream. The same pass maintains the
+// remembered-ghost plane (see GhostsState)
+static void render_snapshot_capture(void) {
+  RenderSnapshot *snap = &WORLD.snapshot[WORLD.snapshot_front ^ 1];
+
+  EntityIndex player_idx = entity_handle_to_index(ENTITIES.player);
+  snap->player = HAS_PART(Position, player_idx) ? player_idx : 0;
+  if (snap->player != 0) {
+    snap->player_pos = PART(Position, player_idx);
+  }
+
+  snap->anim = WORLD.anim;
+  snap->attack_target_valid = false;
+  if (WORLD.anim.type == ACTION_ANIM_ATTACK) {
+    EntityIndex target = entity_handle_to_index(WORLD.anim.attack.target);
+    if (HAS_PART(Position, target)) {
+      snap->attack_target_valid = true;
+      snap->attack_target_pos = PART(Position, target);
+    }
+  }
+
+  GhostsState *ghosts = &WORLD.ghosts;
+
+  // The window scroll remaps tile coordinates, so position-keyed ghosts
+  // go stale wholesale (same policy as lighting_update's full relight)
+  if (!ghosts->map_stamp_valid ||
+      ghosts->map_stamp != WORLD.map.change_counter) {
+    memset(ghosts->tiles, 0, sizeof(ghosts->tiles));
+    memset(ghosts->prev_visible, 0, sizeof(ghosts->prev_visible));
+    ghosts->counter++;
+    ghosts->map_stamp = WORLD.map.change_counter;
+    ghosts->map_stamp_valid = true;
+  }
+
+  // The ghost layer only draws on non-visible tiles, so its content can
+  // change exactly when the visible plane does (ghost cells under FOV
+  // are invisible until their tile goes dark)
+  if (memcmp(ghosts->prev_visible, WORLD.map.visible_bits,
+             sizeof(ghosts->prev_visible)) != 0) {
+    memcpy(ghosts->prev_visible, WORLD.map.visible_bits,
+           sizeof(ghosts->prev_visible));
+    ghosts->counter++;
+  }
+
+  // The player sees the truth on visible tiles: clear remembered ghosts
+  // there, then re-stamp the ones with an entity actually present below
+  for (uint32_t w = 0; w < MAP_BITSET_WORDS; w++) {
+    uint64_t bits = WORLD.map.visible_bits[w];
+    while (bits) {
+      uint32_t idx = w * 64 + (uint32_t)__builtin_ctzll(bits);
+      bits &= bits - 1;
+      ghosts->tiles[idx] = 0;
+    }
+  }
+
+  snap->sprite_count = 0;
+  WORLD_QUERY(i, BITS(Position)) {
+    Position pos = PART(Position, i);
+    // FOV gate: skip out-of-sight entities before any per-entity work
+    // (the player's own tile is always visible)
+    if (!MAP_VISIBLE(pos.x, pos.y)) {
+      continue;
+    }
+    // For now, all entities are rendered as TILE_PLAYER
+    // TODO: Use glyph part or similar to determine tile
+    snap->sprites[snap->sprite_count++] = (SnapshotSprite){
+        .entity = (EntityIndex)i, .pos = pos, .tile = TILE_PLAYER};
+    ghosts->tiles[pos.y * MAP_WIDTH_MAX + pos.x] = TILE_PLAYER + 1;
+  }
+
+  ParticlesState *ps = &WORLD.particles;
+  snap->particles_time = ps->time;
+  snap->particle_count = ps->count;
+  for (uint32_t i = 0; i < ps->count; i++) {
+    snap->particles[i] =
+        (SnapshotParticle){.x = ps->x[i],
+                           .y = ps->y[i],
+                           .type = ps->type[i],
+                           .fade = (uint8_t)(255.0f * ps->ttl[i] /
+                                             ps->lifetime[i])};
+  }
+
+  uint32_t lines = WORLD.messages.count;
+  if (lines > SNAPSHOT_MESSAGE_LINES) {
+    lines = SNAPSHOT_MESSAGE_LINES;
+  }
+  for (uint32_t i = 0; i < lines; i++) {
+    const char *text = message_get(WORLD.messages.count - lines + i);
+    size_t length = strlen(text);
+    memcpy(snap->messages[i], text, length + 1);
+  }
+  snap->message_count = lines;
+
+  snap->fps = WORLD.fps;
+
+  WORLD.snapshot_front ^= 1;
+}
+
 GAME_FRAME_SIG(GAME_FRAME_NAME) {
-  assert(WORLD.arena.offset == 0);
+  assert(WORLD.frame_arena.offset == 0);
+  assert(WORLD.turn_arena.offset == 0);
+
+  // Recording quantizes dt (and the frame runs on the quantized value);
+  // replaying substitutes the recorded dt and input for the host's
+  dt = replay_frame(dt);
+
+  // An action animation in flight at frame start means progress will
+  // advance below; either way the frame needs a redraw
+  bool anim_was_active = WORLD.anim.type != ACTION_ANIM_NONE;
+
+  // Fold last frame's dirty bits into the autosave pending set before
+  // they are wiped below
+  autosave_accumulate_dirty();
+
+  // Reset dirty tracking so this frame's part changes stay flagged until
+  // the start of the next frame (render runs after frame and sees them)
+  parts_clear_dirty();
+
+  // Deferred chunk generation: at most one chunk per frame, so border
+  // crossings spread their mapgen cost across frames instead of
+  // stalling one
+  PROFILE_SCOPE(MAPGEN) { map_generate_pending(); }
 
   // FPS calculation (update every second)
   WORLD.frame_time_accumulator += dt;
@@ -281,24 +628,27 @@ GAME_FRAME_SIG(GAME_FRAME_NAME) {
     WORLD.fps = WORLD.frame_count / WORLD.frame_time_accumulator;
     WORLD.frame_time_accumulator = 0.0;
     WORLD.frame_count = 0;
+    WORLD.frame_damage = true; // FPS counter text changed
   }
 
   // tick handling
-  WORLD.tick_accumulator += dt;
-  const double TICK_INTERVAL = 0.1; // 100ms = 10Hz
-  while (WORLD.tick_accumulator >= TICK_INTERVAL) {
-    game_tick(WORLD.tick_counter++);
-    WORLD.tick_accumulator -= TICK_INTERVAL;
+  PROFILE_SCOPE(TICKS) {
+    WORLD.tick_accumulator += dt;
+    const double TICK_INTERVAL = 0.1; // 100ms = 10Hz
+    while (WORLD.tick_accumulator >= TICK_INTERVAL) {
+      game_tick(WORLD.tick_counter++);
+      WORLD.tick_accumulator -= TICK_INTERVAL;
+    }
   }
 
-  particles_update(&WORLD.particles, dt);
+  PROFILE_SCOPE(PARTICLES) { particles_update(&WORLD.particles, dt); }
 
   if (WORLD.anim.type != ACTION_ANIM_NONE) {
     EntityIndex actor = entity_handle_to_index(WORLD.anim.actor);
     if (HAS_PART(Position, actor)) {
       int x = PART(Position, actor).x;
       int y = PART(Position, actor).y;
-      if (!MAP(x, y).visible) {
+      if (!MAP_VISIBLE(x, y)) {
         memset(&WORLD.anim, 0, sizeof(WORLD.anim));
       }
     }
@@ -321,60 +671,87 @@ GAME_FRAME_SIG(GAME_FRAME_NAME) {
   }
 
   // If no animation playing, process the turn queue
-  if (WORLD.anim.type == ACTION_ANIM_NONE && WORLD.turn_queue.count > 0) {
-    EntityHandle next = turn_queue_peek();
-
-    if (entity_handle_equals(next, ENTITIES.player)) {
-      // Player's turn - do we have input?
-      if (WORLD.next_player_input != INPUT_CMD_NONE) {
-        execute_player_action(WORLD.next_player_input);
-        WORLD.next_player_input = INPUT_CMD_NONE;
+  PROFILE_SCOPE(TURNS) {
+    if (WORLD.anim.type == ACTION_ANIM_NONE && WORLD.turn_queue.count > 0) {
+      EntityHandle next = turn_queue_peek();
+
+      if (entity_handle_equals(next, ENTITIES.player)) {
+        // Player's turn - do we have input?
+        if (WORLD.next_player_input != INPUT_CMD_NONE) {
+          execute_player_action(WORLD.next_player_input);
+          WORLD.next_player_input = INPUT_CMD_NONE;
+        }
+        // No input? Just wait (don't pop from queue)
+      } else if (entity_handle_equals(next, ENTITIES.turn)) {
+        process_turn_entity();
+      } else {
+        // NPC turn - will set anim if needed. When the head NPC has no
+        // decision yet, run the parallel decide phase for every NPC due
+        // this round before applying serially
+        EntityIndex npc = entity_handle_to_index(next);
+        if (WORLD.npc_plan[npc] == 0) {
+          npc_decide_phase();
+        }
+        process_npc_turn(npc);
       }
-      // No input? Just wait (don't pop from queue)
-    } else if (entity_handle_equals(next, ENTITIES.turn)) {
-      process_turn_entity();
-    } else {
-      // NPC turn - will set anim if needed
-      process_npc_turn(entity_handle_to_index(next));
     }
   }
+
+  // Map changes can land on frames without a player move (deferred chunk
+  // completion, window shifts), and those invalidate the FovCache; rerun
+  // FOV here so the render never sees a stale visible plane. The cache
+  // makes this a no-op on quiet frames
+  EntityIndex fov_player = entity_handle_to_index(ENTITIES.player);
+  if (HAS_PART(Position, fov_player)) {
+    Position *fov_pos = &PART(Position, fov_player);
+    fov_compute(&WORLD.map, fov_pos->x, fov_pos->y, PLAYER_FOV_RADIUS);
+  }
+
+  // Re-propagate light around sources that moved this frame (cheap
+  // no-op otherwise); runs after turns so the render reads fresh levels
+  lighting_update();
+
+  // Publish this frame's render state (see RenderSnapshot)
+  render_snapshot_capture();
+
+  // Decide whether the hosts need to redraw at all. Animation progress,
+  // live particles, and any part mutation this frame all damage the frame;
+  // input, messages, and map changes set WORLD.frame_damage directly.
+  // Torch flicker is time-driven inside render, so it freezes while idle —
+  // an accepted trade for not burning a core on redundant redraws
+  bool damaged = WORLD.frame_damage || anim_was_active ||
+                 WORLD.anim.type != ACTION_ANIM_NONE ||
+                 WORLD.particles.count > 0 || parts_any_dirty() ||
+                 WORLD.debug_show_profile; // overlay numbers update live
+  WORLD.frame_damage = false;
+  return damaged;
 }
 
 GAME_INPUT_SIG(GAME_INPUT_NAME) {
+  if (WORLD.replay.mode == REPLAY_REPLAYING) {
+    return; // input comes from the recording; stray keys must not perturb it
+  }
   // Just record the input - game_frame will process it
   WORLD.next_player_input = command;
+  WORLD.frame_damage = true;
 }
 
-// Helper to calculate light at a tile for torch lighting
-static uint8_t calc_tile_light(Map *map, int tile_x, int tile_y, int player_x,
-                               int player_y) {
+// Helper to read the light level at a tile: the plane is maintained
+// incrementally by lighting_update, and visibility gates it so light
+// behind the player never tints unexplored tiles
+static uint8_t calc_tile_light(Map *map, int tile_x, int tile_y) {
   // Out of bounds
   if (tile_x < 0 || tile_x >= map->width || tile_y < 0 ||
       tile_y >= map->height) {
-    return 63; // Full darkness (255 - 192)
-  }
-
-  if (!map->cells[tile_y * MAP_WIDTH_MAX + tile_x].visible) {
-    return 63; // Non-visible: full darkness
-  }
-
-  // Visible - calculate torch lighting based on distance
-  int dx = tile_x - player_x;
-  int dy = tile_y - player_y;
-  int dist_sq = dx * dx + dy * dy;
-
-  if (dist_sq == 0) {
-    return 255; // At player position - full brightness
+    return LIGHT_DARK;
   }
 
-  float dist = 1.0f / rsqrt((float)dist_sq);
-
-  if (dist < PLAYER_TORCH_RADIUS) {
-    float fade = dist / PLAYER_TORCH_RADIUS;
-    return (uint8_t)(255.0f - fade * 192.0f);
+  if (!map_is_visible(map, tile_x, tile_y)) {
+    return LIGHT_DARK; // Non-visible: full darkness
   }
 
-  return 63; // Beyond torch radius - full darkness
+  uint8_t light = map->light[tile_y * MAP_WIDTH_MAX + tile_x];
+  return light > LIGHT_DARK ? light : LIGHT_DARK;
 }
 
 // Helper to get water depth at a tile position
@@ -385,7 +762,7 @@ static inline uint8_t get_water_depth(Map *map, int tile_x, int tile_y,
       tile_y >= map->height) {
     return fallback;
   }
-  if (!map->cells[tile_y * MAP_WIDTH_MAX + tile_x].passable) {
+  if (!map_is_passable(map, tile_x, tile_y)) {
     return fallback;
   }
   return map->water_depth[tile_y * MAP_WIDTH_MAX + tile_x];
@@ -418,7 +795,7 @@ static uint8_t calc_corner_water_depth(Map *map, int tile_x, int tile_y,
 
 // Helper to calculate light at a corner by taking minimum of surrounding tiles
 static uint8_t calc_corner_light(Map *map, int tile_x, int tile_y, int corner_x,
-                                 int corner_y, int player_x, int player_y) {
+                                 int corner_y) {
   // Sample the 4 neighboring tiles around this corner
   // corner_x and corner_y are 0 or 1, indicating which corner of the tile
   int nx0 = tile_x + corner_x - 1;
@@ -430,10 +807,10 @@ static uint8_t calc_corner_light(Map *map, int tile_x, int tile_y, int corner_x,
   int nx3 = tile_x + corner_x;
   int ny3 = tile_y + corner_y;
 
-  uint8_t l0 = calc_tile_light(map, nx0, ny0, player_x, player_y);
-  uint8_t l1 = calc_tile_light(map, nx1, ny1, player_x, player_y);
-  uint8_t l2 = calc_tile_light(map, nx2, ny2, player_x, player_y);
-  uint8_t l3 = calc_tile_light(map, nx3, ny3, player_x, player_y);
+  uint8_t l0 = calc_tile_light(map, nx0, ny0);
+  uint8_t l1 = calc_tile_light(map, nx1, ny1);
+  uint8_t l2 = calc_tile_light(map, nx2, ny2);
+  uint8_t l3 = calc_tile_light(map, nx3, ny3);
 
   // Find minimum and average
   uint8_t min = l0;
@@ -450,8 +827,129 @@ static uint8_t calc_corner_light(Map *map, int tile_x, int tile_y, int corner_x,
   return (uint8_t)((min + avg * 3) / 4);
 }
 
+static Color particle_color(ParticleType type) {
+  switch (type) {
+  case PARTICLE_TYPE_BLOOD:
+    return (Color){160, 20, 20, 255};
+  case PARTICLE_TYPE_FOG:
+    return (Color){180, 180, 190, 90};
+  case PARTICLE_TYPE_SNOW:
+    return (Color){240, 240, 255, 220};
+  case PARTICLE_TYPE_RAIN:
+    return (Color){100, 140, 220, 180};
+  case PARTICLE_TYPE_TORCH_SMOKE:
+    return (Color){90, 90, 90, 120};
+  case PARTICLE_TYPE_TORCH_SPARK:
+    return (Color){255, 200, 80, 255};
+  }
+  return (Color){255, 255, 255, 255};
+}
+
+// Draw a single entity, interpolating its position if it is animating
+static void render_entity(GeometryBuilder *geom, const RenderSnapshot *snap,
+                          const SnapshotSprite *sprite, int tile_size,
+                          float viewport_left_px, float viewport_top_px,
+                          int viewport_width_px, int viewport_height_px) {
+  // Start with entity's actual position (in tile coordinates)
+  float world_x = (float)sprite->pos.x;
+  float world_y = (float)sprite->pos.y;
+
+  // If this entity is animating, interpolate between from and to positions
+  if (snap->anim.type == ACTION_ANIM_MOVE &&
+      entity_handle_to_index(snap->anim.actor) == sprite->entity) {
+    float t = snap->anim.progress;
+    world_x = snap->anim.move.from.x +
+              (snap->anim.move.to.x - snap->anim.move.from.x) * t;
+    world_y = snap->anim.move.from.y +
+              (snap->anim.move.to.y - snap->anim.move.from.y) * t;
+  } else if (snap->anim.type == ACTION_ANIM_ATTACK &&
+             entity_handle_to_index(snap->anim.actor) == sprite->entity &&
+             snap->attack_target_valid) {
+    // Move slightly toward target and back (bump animation)
+    // Calculate direction to target
+    float dx = snap->attack_target_pos.x - sprite->pos.x;
+    float dy = snap->attack_target_pos.y - sprite->pos.y;
+
+    // Normalize
+    float len2 = dx * dx + dy * dy;
+    if (len2 > 0.001f) {
+      float s = rsqrt(len2);
+      dx *= s;
+      dy *= s;
+    }
+
+    // Bump distance: 0.3 tiles
+    float t = snap->anim.progress;
+    // Ease out and back: move forward in first half, back in second half
+    float bump_amount = (t < 0.5f) ? t * 2.0f : (1.0f - t) * 2.0f;
+    bump_amount *= 0.3f;
+
+    world_x += dx * bump_amount;
+    world_y += dy * bump_amount;
+  }
+
+  // Convert world position to pixels, then to screen coordinates
+  float world_px = world_x * tile_size;
+  float world_py = world_y * tile_size;
+  int screen_x = (int)(world_px - viewport_left_px);
+  int screen_y = (int)(world_py - viewport_top_px);
+
+  // Cull to the viewport (one tile margin covers animation overshoot)
+  if (screen_x + 2 * tile_size < 0 || screen_x - tile_size >= viewport_width_px ||
+      screen_y + 2 * tile_size < 0 || screen_y - tile_size >= viewport_height_px) {
+    return;
+  }
+
+  geobuilder_tile(geom, sprite->tile, screen_x, screen_y);
+}
+
+// Cached vertex data for the static map tile layer. The layer only changes
+// when the camera crosses a tile boundary, the viewport changes, or the map
+// change counter moves; on every other frame the cached vertices are
+// replayed shifted by the sub-tile camera fraction. Lives in a plain static
+// (not WorldState) like the geometry builder: losing it on hot-reload just
+// costs one rebuild
+#define MAP_LAYER_CACHE_MAX_VERTICES (64 * 1024)
+
+static struct {
+  bool valid;
+  int start_tile_x;
+  int start_tile_y;
+  int tile_size;
+  int viewport_w;
+  int viewport_h;
+  uint32_t map_counter;
+  uint32_t revision; // bumped per rebuild; keys the host's layer cache
+  int count;
+  Vertex vertices[MAP_LAYER_CACHE_MAX_VERTICES];
+} map_layer_cache;
+
+// Same idea for the remembered-entity ghost layer: its content is keyed
+// by WORLD.ghosts.counter, which only moves when the FOV or the chunk
+// window changes, so most frames replay the cached rasterization.
+// Ghosts are at most one per tile, so a quarter of the map cache is
+// already generous
+#define GHOST_LAYER_CACHE_MAX_VERTICES (16 * 1024)
+
+static struct {
+  bool valid;
+  int start_tile_x;
+  int start_tile_y;
+  int tile_size;
+  int viewport_w;
+  int viewport_h;
+  uint32_t ghost_counter;
+  uint32_t revision;
+  int count;
+  Vertex vertices[GHOST_LAYER_CACHE_MAX_VERTICES];
+} ghost_layer_cache;
+
 GAME_RENDER_SIG(GAME_RENDER_NAME) {
-  assert(WORLD.arena.offset == 0);
+  assert(WORLD.frame_arena.offset == 0);
+
+  // Whole-render timing (the body is too large for a scoped block); the
+  // profiler overlay below shows last frame's numbers as a result
+  double render_start_us = host_time_us();
 
   RenderContext ctx = {
       .viewport_width_px = viewport_width_px,
@@ -465,28 +963,31 @@ GAME_RENDER_SIG(GAME_RENDER_NAME) {
   static GeometryBuilder geom;
   geobuilder_init(&geom, &ctx);
 
+  // Everything simulation mutates per frame is read from the front
+  // snapshot buffer (see RenderSnapshot); map planes are read live
+  const RenderSnapshot *snap = &WORLD.snapshot[WORLD.snapshot_front];
+
   // Get player position for camera centering
-  EntityIndex player_idx = entity_handle_to_index(ENTITIES.player);
+  EntityIndex player_idx = snap->player;
   float camera_center_x = 0.0f;
   float camera_center_y = 0.0f;
   int player_tile_x = 0;
   int player_tile_y = 0;
 
-  if (HAS_PART(Position, player_idx)) {
-    Position *pos = &PART(Position, player_idx);
-    camera_center_x = (float)pos->x;
-    camera_center_y = (float)pos->y;
-    player_tile_x = pos->x;
-    player_tile_y = pos->y;
+  if (player_idx != 0) {
+    camera_center_x = (float)snap->player_pos.x;
+    camera_center_y = (float)snap->player_pos.y;
+    player_tile_x = snap->player_pos.x;
+    player_tile_y = snap->player_pos.y;
 
     // If player is animating, use interpolated position for camera only
-    if (WORLD.anim.type == ACTION_ANIM_MOVE &&
-        entity_handle_to_index(WORLD.anim.actor) == player_idx) {
-      float t = WORLD.anim.progress;
-      camera_center_x = WORLD.anim.move.from.x +
-                        (WORLD.anim.move.to.x - WORLD.anim.move.from.x) * t;
-      camera_center_y = WORLD.anim.move.from.y +
-                        (WORLD.anim.move.to.y - WORLD.anim.move.from.y) * t;
+    if (snap->anim.type == ACTION_ANIM_MOVE &&
+        entity_handle_to_index(snap->anim.actor) == player_idx) {
+      float t = snap->anim.progress;
+      camera_center_x = snap->anim.move.from.x +
+                        (snap->anim.move.to.x - snap->anim.move.from.x) * t;
+      camera_center_y = snap->anim.move.from.y +
+                        (snap->anim.move.to.y - snap->anim.move.from.y) * t;
     }
   }
 
@@ -506,7 +1007,7 @@ GAME_RENDER_SIG(GAME_RENDER_NAME) {
   int offset_y = (int)(viewport_top_px - start_tile_y * tile_size);
 
   // Calculate chaotic torch flicker using combined non-linear waves
-  float t = WORLD.particles.time;
+  float t = snap->particles_time;
   float s1 = sinf(t * 3.1f);
   float s2 = sinf(t * 7.3f);
   float s3 = sinf(t * 13.7f);
@@ -515,78 +1016,167 @@ GAME_RENDER_SIG(GAME_RENDER_NAME) {
                   0.04f * s2 * s2 + // Squared for non-linearity
                   0.03f * s1 * s3;  // Cross-product for chaos
 
-  // Draw visible tiles
-  int screen_y = -offset_y;
-  for (int tile_y = start_tile_y; screen_y < viewport_height_px; tile_y++) {
-    int screen_x = -offset_x;
-    for (int tile_x = start_tile_x; screen_x < viewport_width_px; tile_x++) {
-      // Check if tile is within map bounds
-      if (tile_x >= 0 && tile_x < (int)WORLD.map.width && tile_y >= 0 &&
-          tile_y < (int)WORLD.map.height) {
-
-        int tile = WORLD.map.cells[tile_y * MAP_WIDTH_MAX + tile_x].tile;
-        geobuilder_tile(&geom, tile, screen_x, screen_y);
+  // Draw visible tiles from the cached layer, rebuilding it only when the
+  // camera's tile origin, the viewport, or the map changed. The cache holds
+  // one extra row and column so it covers every sub-tile offset
+  if (!map_layer_cache.valid ||
+      map_layer_cache.start_tile_x != start_tile_x ||
+      map_layer_cache.start_tile_y != start_tile_y ||
+      map_layer_cache.tile_size != tile_size ||
+      map_layer_cache.viewport_w != viewport_width_px ||
+      map_layer_cache.viewport_h != viewport_height_px ||
+      map_layer_cache.map_counter != WORLD.map.change_counter) {
+    map_layer_cache.count = 0;
+    bool overflow = false;
+    for (int tile_y = start_tile_y;
+         !overflow &&
+         (tile_y - start_tile_y) * tile_size < viewport_height_px + tile_size;
+         tile_y++) {
+      for (int tile_x = start_tile_x;
+           (tile_x - start_tile_x) * tile_size < viewport_width_px + tile_size;
+           tile_x++) {
+        // Check if tile is within map bounds
+        if (tile_x >= 0 && tile_x < (int)WORLD.map.width && tile_y >= 0 &&
+            tile_y < (int)WORLD.map.height) {
+          if (map_layer_cache.count + 4 > MAP_LAYER_CACHE_MAX_VERTICES) {
+            overflow = true;
+            break;
+          }
+          int tile = WORLD.map.cells[tile_y * MAP_WIDTH_MAX + tile_x].tile;
+          map_layer_cache.count += geometry_emit_tile(
+              &ctx, &map_layer_cache.vertices[map_layer_cache.count], tile,
+              (tile_x - start_tile_x) * tile_size,
+              (tile_y - start_tile_y) * tile_size);
+        }
       }
-      screen_x += tile_size;
     }
-    screen_y += tile_size;
+    map_layer_cache.valid = !overflow;
+    map_layer_cache.revision++;
+    map_layer_cache.start_tile_x = start_tile_x;
+    map_layer_cache.start_tile_y = start_tile_y;
+    map_layer_cache.tile_size = tile_size;
+    map_layer_cache.viewport_w = viewport_width_px;
+    map_layer_cache.viewport_h = viewport_height_px;
+    map_layer_cache.map_counter = WORLD.map.change_counter;
   }
 
-  // Draw entities with position
-  WORLD_QUERY(i, BITS(Position)) {
-    Position *pos = &PART(Position, i);
-
-    // Start with entity's actual position (in tile coordinates)
-    float world_x = (float)pos->x;
-    float world_y = (float)pos->y;
-
-    // If this entity is animating, interpolate between from and to positions
-    if (WORLD.anim.type == ACTION_ANIM_MOVE &&
-        entity_handle_to_index(WORLD.anim.actor) == i) {
-      float t = WORLD.anim.progress;
-      world_x = WORLD.anim.move.from.x +
-                (WORLD.anim.move.to.x - WORLD.anim.move.from.x) * t;
-      world_y = WORLD.anim.move.from.y +
-                (WORLD.anim.move.to.y - WORLD.anim.move.from.y) * t;
-    } else if (WORLD.anim.type == ACTION_ANIM_ATTACK &&
-               entity_handle_to_index(WORLD.anim.actor) == i) {
-      // Move slightly toward target and back (bump animation)
-      EntityIndex target_idx = entity_handle_to_index(WORLD.anim.attack.target);
-      if (HAS_PART(Position, target_idx)) {
-        Position *target_pos = &PART(Position, target_idx);
-
-        // Calculate direction to target
-        float dx = target_pos->x - pos->x;
-        float dy = target_pos->y - pos->y;
-
-        // Normalize
-        float len2 = dx * dx + dy * dy;
-        if (len2 > 0.001f) {
-          float s = rsqrt(len2);
-          dx *= s;
-          dy *= s;
+  int screen_y;
+  if (map_layer_cache.valid) {
+    // The host keeps a rasterized copy of the layer keyed by revision;
+    // unchanged frames cost one blit instead of a full vertex upload.
+    // Nothing has been drawn yet this frame, so ordering is preserved
+    host_submit_layer(RENDER_LAYER_MAP, map_layer_cache.revision,
+                      map_layer_cache.vertices, map_layer_cache.count,
+                      (float)-offset_x, (float)-offset_y);
+  } else {
+    // Viewport too large for the cache; emit tile quads directly
+    screen_y = -offset_y;
+    for (int tile_y = start_tile_y; screen_y < viewport_height_px; tile_y++) {
+      int screen_x = -offset_x;
+      for (int tile_x = start_tile_x; screen_x < viewport_width_px; tile_x++) {
+        if (tile_x >= 0 && tile_x < (int)WORLD.map.width && tile_y >= 0 &&
+            tile_y < (int)WORLD.map.height) {
+          int tile = WORLD.map.cells[tile_y * MAP_WIDTH_MAX + tile_x].tile;
+          geobuilder_tile(&geom, tile, screen_x, screen_y);
         }
+        screen_x += tile_size;
+      }
+      screen_y += tile_size;
+    }
+  }
 
-        // Bump distance: 0.3 tiles
-        float t = WORLD.anim.progress;
-        // Ease out and back: move forward in first half, back in second half
-        float bump_amount = (t < 0.5f) ? t * 2.0f : (1.0f - t) * 2.0f;
-        bump_amount *= 0.3f;
+  // Remembered-entity ghosts on explored-but-dark tiles, as a second
+  // cached layer (the darkness overlay below dims them like the map)
+  if (!ghost_layer_cache.valid ||
+      ghost_layer_cache.start_tile_x != start_tile_x ||
+      ghost_layer_cache.start_tile_y != start_tile_y ||
+      ghost_layer_cache.tile_size != tile_size ||
+      ghost_layer_cache.viewport_w != viewport_width_px ||
+      ghost_layer_cache.viewport_h != viewport_height_px ||
+      ghost_layer_cache.ghost_counter != WORLD.ghosts.counter) {
+    ghost_layer_cache.count = 0;
+    bool overflow = false;
+    for (int tile_y = start_tile_y;
+         !overflow &&
+         (tile_y - start_tile_y) * tile_size < viewport_height_px + tile_size;
+         tile_y++) {
+      for (int tile_x = start_tile_x;
+           (tile_x - start_tile_x) * tile_size < viewport_width_px + tile_size;
+           tile_x++) {
+        if (tile_x >= 0 && tile_x < (int)WORLD.map.width && tile_y >= 0 &&
+            tile_y < (int)WORLD.map.height &&
+            !MAP_VISIBLE(tile_x, tile_y)) {
+          uint16_t ghost = WORLD.ghosts.tiles[tile_y * MAP_WIDTH_MAX + tile_x];
+          if (ghost) {
+            if (ghost_layer_cache.count + 4 > GHOST_LAYER_CACHE_MAX_VERTICES) {
+              overflow = true;
+              break;
+            }
+            ghost_layer_cache.count += geometry_emit_tile(
+                &ctx, &ghost_layer_cache.vertices[ghost_layer_cache.count],
+                ghost - 1, (tile_x - start_tile_x) * tile_size,
+                (tile_y - start_tile_y) * tile_size);
+          }
+        }
+      }
+    }
+    ghost_layer_cache.valid = !overflow;
+    ghost_layer_cache.revision++;
+    ghost_layer_cache.start_tile_x = start_tile_x;
+    ghost_layer_cache.start_tile_y = start_tile_y;
+    ghost_layer_cache.tile_size = tile_size;
+    ghost_layer_cache.viewport_w = viewport_width_px;
+    ghost_layer_cache.viewport_h = viewport_height_px;
+    ghost_layer_cache.ghost_counter = WORLD.ghosts.counter;
+  }
 
-        world_x += dx * bump_amount;
-        world_y += dy * bump_amount;
+  if (ghost_layer_cache.valid) {
+    host_submit_layer(RENDER_LAYER_GHOSTS, ghost_layer_cache.revision,
+                      ghost_layer_cache.vertices, ghost_layer_cache.count,
+                      (float)-offset_x, (float)-offset_y);
+  } else {
+    screen_y = -offset_y;
+    for (int tile_y = start_tile_y; screen_y < viewport_height_px; tile_y++) {
+      int screen_x = -offset_x;
+      for (int tile_x = start_tile_x; screen_x < viewport_width_px; tile_x++) {
+        if (tile_x >= 0 && tile_x < (int)WORLD.map.width && tile_y >= 0 &&
+            tile_y < (int)WORLD.map.height &&
+            !MAP_VISIBLE(tile_x, tile_y)) {
+          uint16_t ghost = WORLD.ghosts.tiles[tile_y * MAP_WIDTH_MAX + tile_x];
+          if (ghost) {
+            geobuilder_tile(&geom, ghost - 1, screen_x, screen_y);
+          }
+        }
+        screen_x += tile_size;
       }
+      screen_y += tile_size;
     }
+  }
 
-    // Convert world position to pixels, then to screen coordinates
-    float world_px = world_x * tile_size;
-    float world_py = world_y * tile_size;
-    int screen_x = (int)(world_px - viewport_left_px);
-    int screen_y = (int)(world_py - viewport_top_px);
+  // Draw entities from the snapshot sprite list; render_entity culls to
+  // the viewport (one tile margin covers move/bump animation overshoot)
+  for (uint32_t s = 0; s < snap->sprite_count; s++) {
+    render_entity(&geom, snap, &snap->sprites[s], tile_size, viewport_left_px,
+                  viewport_top_px, viewport_width_px, viewport_height_px);
+  }
 
-    // For now, all entities are rendered as TILE_PLAYER
-    // TODO: Use glyph part or similar to determine tile
-    geobuilder_tile(&geom, TILE_PLAYER, screen_x, screen_y);
+  // Draw particles as small colored rects fading with age, culled to the
+  // viewport before any geometry is emitted (weather effects can cover
+  // far more of the map than is visible)
+  {
+    int psize = tile_size / 3;
+    for (uint32_t i = 0; i < snap->particle_count; i++) {
+      const SnapshotParticle *p = &snap->particles[i];
+      int sx = (int)(p->x * tile_size - viewport_left_px) - psize / 2;
+      int sy = (int)(p->y * tile_size - viewport_top_px) - psize / 2;
+      if (sx + psize < 0 || sx >= viewport_width_px || sy + psize < 0 ||
+          sy >= viewport_height_px) {
+        continue;
+      }
+      Color c = particle_color((ParticleType)p->type);
+      c.a = (uint8_t)(c.a * p->fade / 255);
+      geobuilder_rect(&geom, sx, sy, psize, psize, c);
+    }
   }
 
   // ========================================================================
@@ -598,7 +1188,8 @@ GAME_RENDER_SIG(GAME_RENDER_NAME) {
   // Recalculate path every frame (updates when entities move)
   // Find first non-player entity with position
   EntityIndex target = 0;
-  WORLD_QUERY(i, BITS(Position)) {
+  CachedQuery *positioned = query_cache_get1(PART_TYPE_Position);
+  CACHED_QUERY(i, positioned) {
     if (i != player_idx) {
       target = i;
       break;
@@ -609,9 +1200,9 @@ GAME_RENDER_SIG(GAME_RENDER_NAME) {
     Position *player_pos = &PART(Position, player_idx);
     Position *target_pos = &PART(Position, target);
 
-    path_len = astar_find_path(NULL, test_pathfinding_cost, WORLD.map.width,
-                               WORLD.map.height, player_pos->x, player_pos->y,
-                               target_pos->x, target_pos->y, path_test);
+    path_len =
+        hpa_find_path(NULL, test_pathfinding_cost, player_pos->x, player_pos->y,
+                      target_pos->x, target_pos->y, path_test);
   }
 
   // Draw the path with '*' character
@@ -708,25 +1299,23 @@ GAME_RENDER_SIG(GAME_RENDER_NAME) {
         }
 
         // Check if this tile is visible
-        bool tile_visible =
-            WORLD.map.cells[tile_y * MAP_WIDTH_MAX + tile_x].visible;
+        bool tile_visible = MAP_VISIBLE(tile_x, tile_y);
 
         if (tile_visible) {
           // Check if this tile has any lighting (to decide if we need expensive
           // corner sampling)
-          uint8_t tile_light = calc_tile_light(&WORLD.map, tile_x, tile_y,
-                                               player_tile_x, player_tile_y);
+          uint8_t tile_light = calc_tile_light(&WORLD.map, tile_x, tile_y);
 
           if (tile_light > 63) {
             // Tile has some lighting - do full corner interpolation
-            uint8_t tl_light = calc_corner_light(
-                &WORLD.map, tile_x, tile_y, 0, 0, player_tile_x, player_tile_y);
-            uint8_t tr_light = calc_corner_light(
-                &WORLD.map, tile_x, tile_y, 1, 0, player_tile_x, player_tile_y);
-            uint8_t bl_light = calc_corner_light(
-                &WORLD.map, tile_x, tile_y, 0, 1, player_tile_x, player_tile_y);
-            uint8_t br_light = calc_corner_light(
-                &WORLD.map, tile_x, tile_y, 1, 1, player_tile_x, player_tile_y);
+            uint8_t tl_light =
+                calc_corner_light(&WORLD.map, tile_x, tile_y, 0, 0);
+            uint8_t tr_light =
+                calc_corner_light(&WORLD.map, tile_x, tile_y, 1, 0);
+            uint8_t bl_light =
+                calc_corner_light(&WORLD.map, tile_x, tile_y, 0, 1);
+            uint8_t br_light =
+                calc_corner_light(&WORLD.map, tile_x, tile_y, 1, 1);
 
             // Apply flicker to light values (only in lit areas)
             tl_light = tl_light > 63 ? (uint8_t)(63 + (tl_light - 63) * flicker)
@@ -769,37 +1358,62 @@ GAME_RENDER_SIG(GAME_RENDER_NAME) {
     screen_y += tile_size;
   }
 
-// Draw message log at bottom of screen
-#define MESSAGE_DISPLAY_LINES 10
-
-  // Get the most recent N messages
-  int messages_to_show = MESSAGE_DISPLAY_LINES;
-  if (messages_to_show > (int)WORLD.messages.count) {
-    messages_to_show = WORLD.messages.count;
-  }
-
+  // Draw message log at bottom of screen (most recent lines, already
+  // copied into the snapshot)
+  int messages_to_show = (int)snap->message_count;
   for (int i = 0; i < messages_to_show; i++) {
-    // Get the i-th most recent message (counting from end)
-    int offset = (int)WORLD.messages.count - messages_to_show + i;
-    int msg_idx = (WORLD.messages.first + offset) % MESSAGE_COUNT_MAX;
-    const char *text = WORLD.messages.buffer[msg_idx].text;
-
     // Position from bottom up
     int y = viewport_height_px - (messages_to_show - i) * tile_size;
 
-    geobuilder_text(&geom, 0, y, 1.0f, TEXT_ALIGN_LEFT, (Color){.a = 192},
-                    text);
+    geobuilder_text_cached(&geom, 0, y, 1.0f, TEXT_ALIGN_LEFT,
+                           (Color){.a = 192}, snap->messages[i]);
   }
 
   // Draw FPS in upper right corner
-  if (WORLD.fps > 0.0f) {
+  if (snap->fps > 0.0f) {
     PRINT(text, 16, "");
-    print_uint(&text, (uint64_t)WORLD.fps);
+    print_uint(&text, (uint64_t)snap->fps);
     print_str(&text, " FPS");
-    geobuilder_text(&geom, viewport_width_px, 0, 1.0f, TEXT_ALIGN_RIGHT,
-                    (Color){.a = 192}, text.data);
+    geobuilder_text_cached(&geom, viewport_width_px, 0, 1.0f, TEXT_ALIGN_RIGHT,
+                           (Color){.a = 192}, text.data);
+  }
+
+  // Part stats overlay under the FPS counter: population and bytes
+  // touched this frame (from the dirty bitsets) per part
+  if (WORLD.debug_show_part_stats) {
+    PartStats stats[PART_TYPE_MAX];
+    uint32_t stat_count = parts_debug_stats(stats);
+    for (uint32_t i = 0; i < stat_count; i++) {
+      PRINT(text, 64, "");
+      print_str(&text, stats[i].name);
+      print_str(&text, " ");
+      print_uint(&text, stats[i].population);
+      if (stats[i].elem_size) {
+        print_str(&text, " ~");
+        print_uint(&text, stats[i].dirty * stats[i].elem_size);
+        print_str(&text, "B");
+      }
+      geobuilder_text_cached(&geom, viewport_width_px, (int)(i + 1) * tile_size,
+                             1.0f, TEXT_ALIGN_RIGHT, (Color){.a = 192},
+                             text.data);
+    }
+  }
+
+  // Profiler overlay: per-phase p95 over the recent sample window
+  if (WORLD.debug_show_profile) {
+    for (int i = 0; i < PROFILE_PHASE_MAX; i++) {
+      PRINT(text, 64, "");
+      print_str(&text, profile_phase_name((ProfilePhase)i));
+      print_str(&text, " p95 ");
+      print_uint(&text, (uint64_t)profile_phase_p95((ProfilePhase)i));
+      print_str(&text, "us");
+      geobuilder_text(&geom, 0, i * tile_size, 1.0f, TEXT_ALIGN_LEFT,
+                      (Color){.a = 192}, text.data);
+    }
   }
 
   // Flush any remaining vertices
   geobuilder_flush(&geom);
+
+  profile_record(PROFILE_PHASE_GEOMETRY, render_start_us, host_time_us());
 }
@@ -0,0 +1,184 @@
+#include "world.h"
+
+// ============================================================================
+// Incremental tile lighting (see lighting.h for the scheme)
+// ============================================================================
+
+// Dirty region accumulator in tile coordinates (x1 < x0 means empty)
+typedef struct {
+  int x0, y0, x1, y1;
+} LightRect;
+
+static void light_rect_add_disc(LightRect *rect, int x, int y, int radius) {
+  int x0 = clamp_int(x - radius, 0, WORLD.map.width - 1);
+  int y0 = clamp_int(y - radius, 0, WORLD.map.height - 1);
+  int x1 = clamp_int(x + radius, 0, WORLD.map.width - 1);
+  int y1 = clamp_int(y + radius, 0, WORLD.map.height - 1);
+  if (rect->x1 < rect->x0) {
+    *rect = (LightRect){x0, y0, x1, y1};
+    return;
+  }
+  if (x0 < rect->x0) {
+    rect->x0 = x0;
+  }
+  if (y0 < rect->y0) {
+    rect->y0 = y0;
+  }
+  if (x1 > rect->x1) {
+    rect->x1 = x1;
+  }
+  if (y1 > rect->y1) {
+    rect->y1 = y1;
+  }
+}
+
+// Same torch falloff the renderer always used: full at the source,
+// fading to the darkness floor at the radius edge. Precomputed per
+// (radius, distance) on first use, following the fov.c table pattern:
+// it's a pure function of two small ints, and the table read replaces a
+// divide on every tile visited during propagation
+static uint8_t falloff_table[LIGHT_RADIUS_MAX + 1][LIGHT_RADIUS_MAX + 1];
+static bool falloff_initialized;
+
+const uint8_t *lighting_falloff(int radius) {
+  assert(radius >= 0 && radius <= LIGHT_RADIUS_MAX);
+  if (!falloff_initialized) {
+    falloff_table[0][0] = LIGHT_FULL;
+    for (int r = 1; r <= LIGHT_RADIUS_MAX; r++) {
+      for (int d = 0; d <= r; d++) {
+        falloff_table[r][d] =
+            (uint8_t)(LIGHT_FULL - d * (LIGHT_FULL - LIGHT_DARK) / r);
+      }
+    }
+    falloff_initialized = true;
+  }
+  return falloff_table[radius];
+}
+
+typedef struct {
+  uint8_t x, y;
+  uint8_t dist;
+} LightNode;
+
+// Bounded BFS from one source, max-combining levels into the plane so
+// overlapping sources compose without ordering concerns
+static void propagate_source(Map *map, int sx, int sy, int radius) {
+  if (radius <= 0) {
+    return;
+  }
+  if (radius > LIGHT_RADIUS_MAX) {
+    radius = LIGHT_RADIUS_MAX;
+  }
+
+  const uint8_t *falloff = lighting_falloff(radius);
+
+  enum { SPAN = 2 * LIGHT_RADIUS_MAX + 1 };
+  bool seen[SPAN * SPAN] = {false}; // disc-local visited flags
+  LightNode queue[SPAN * SPAN];
+  int head = 0;
+  int tail = 0;
+
+  seen[LIGHT_RADIUS_MAX * SPAN + LIGHT_RADIUS_MAX] = true;
+  queue[tail++] = (LightNode){(uint8_t)sx, (uint8_t)sy, 0};
+
+  while (head < tail) {
+    LightNode node = queue[head++];
+    int idx = node.y * MAP_WIDTH_MAX + node.x;
+    uint8_t level = falloff[node.dist];
+    if (level > map->light[idx]) {
+      map->light[idx] = level;
+    }
+
+    // walls catch light but don't pass it on; the source tile always
+    // expands so a torch in a doorway lights both sides
+    if (node.dist >= radius ||
+        (node.dist > 0 && !map_is_passable(map, node.x, node.y))) {
+      continue;
+    }
+
+    for (int dy = -1; dy <= 1; dy++) {
+      for (int dx = -1; dx <= 1; dx++) {
+        int x = node.x + dx;
+        int y = node.y + dy;
+        if ((dx == 0 && dy == 0) || x < 0 || y < 0 || x >= map->width ||
+            y >= map->height) {
+          continue;
+        }
+        int local = (y - sy + LIGHT_RADIUS_MAX) * SPAN + (x - sx + LIGHT_RADIUS_MAX);
+        if (seen[local]) {
+          continue;
+        }
+        seen[local] = true;
+        queue[tail++] =
+            (LightNode){(uint8_t)x, (uint8_t)y, (uint8_t)(node.dist + 1)};
+      }
+    }
+  }
+}
+
+void lighting_update(void) {
+  Map *map = &WORLD.map;
+  LightingState *ls = &WORLD.lighting;
+
+  // passability changes and chunk window shifts invalidate everything
+  bool full = false;
+  if (!ls->map_stamp_valid || ls->map_stamp != map->change_counter) {
+    ls->map_stamp = map->change_counter;
+    ls->map_stamp_valid = true;
+    full = true;
+  }
+
+  // diff current sources against the previous update's snapshot; any
+  // source that appeared, moved or re-tuned dirties its disc(s)
+  LightRect dirty = {0, 0, -1, -1};
+  uint64_t now_bits[ENTITY_BITSET_WORDS] = {0};
+  WORLD_QUERY(i, BITS(LightSource) & BITS(Position)) {
+    bitset_set(now_bits, i);
+    Position pos = PART(Position, i);
+    uint8_t radius = PART(LightSource, i);
+    if (!bitset_test(ls->prev_bits, i)) {
+      light_rect_add_disc(&dirty, pos.x, pos.y, radius);
+    } else if (ls->prev_pos[i].x != pos.x || ls->prev_pos[i].y != pos.y ||
+               ls->prev_radius[i] != radius) {
+      light_rect_add_disc(&dirty, ls->prev_pos[i].x, ls->prev_pos[i].y,
+                          ls->prev_radius[i]);
+      light_rect_add_disc(&dirty, pos.x, pos.y, radius);
+    }
+    ls->prev_pos[i] = pos;
+    ls->prev_radius[i] = radius;
+  }
+
+  // vanished sources dirty their last known disc
+  for (int w = 0; w < ENTITY_BITSET_WORDS; w++) {
+    uint64_t gone = ls->prev_bits[w] & ~now_bits[w];
+    while (gone) {
+      EntityIndex i = (EntityIndex)(w * 64 + __builtin_ctzll(gone));
+      gone &= gone - 1;
+      light_rect_add_disc(&dirty, ls->prev_pos[i].x, ls->prev_pos[i].y,
+                          ls->prev_radius[i]);
+    }
+  }
+  bitset_copy(ls->prev_bits, now_bits);
+
+  if (full) {
+    dirty = (LightRect){0, 0, map->width - 1, map->height - 1};
+  } else if (dirty.x1 < dirty.x0) {
+    return; // nothing changed
+  }
+
+  // clear the dirty rect, then re-propagate every source whose disc
+  // touches it (max-combine makes overlapping rewrites harmless)
+  for (int y = dirty.y0; y <= dirty.y1; y++) {
+    memset(&map->light[y * MAP_WIDTH_MAX + dirty.x0], 0,
+           (size_t)(dirty.x1 - dirty.x0 + 1));
+  }
+  WORLD_QUERY(i, BITS(LightSource) & BITS(Position)) {
+    Position pos = PART(Position, i);
+    int radius = PART(LightSource, i);
+    if (pos.x + radius < dirty.x0 || pos.x - radius > dirty.x1 ||
+        pos.y + radius < dirty.y0 || pos.y - radius > dirty.y1) {
+      continue;
+    }
+    propagate_source(map, pos.x, pos.y, radius);
+  }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "map.h"
+
+// Incremental tile lighting
+//
+// Per-tile light levels live in a byte plane (Map.light, alongside
+// water_depth) produced by bounded BFS propagation from entities with
+// the LightSource part: light spreads through passable tiles only, so
+// it hugs corridors instead of bleeding through walls, while a blocking
+// wall tile still catches light for rendering. Values use the render
+// scale directly (LIGHT_DARK at the radius edge up to LIGHT_FULL at the
+// source), so the draw loop reads the plane as-is.
+//
+// Propagation is incremental: lighting_update diffs the current sources
+// against the previous update's snapshot and only re-propagates the
+// union rect of discs that appeared, vanished or moved. Map changes
+// (dug walls, chunk window shifts) fall back to a full relight via
+// Map.change_counter, so the plane never needs serializing.
+
+#define LIGHT_RADIUS_MAX 20 // bounds the per-source BFS working set
+#define LIGHT_FULL 255
+#define LIGHT_DARK 63 // render floor: unlit (and non-visible) tiles
+
+typedef struct {
+  // sources as of the last update, for change detection
+  uint64_t prev_bits[ENTITY_BITSET_WORDS];
+  Position prev_pos[MAX_ENTITIES];
+  uint8_t prev_radius[MAX_ENTITIES];
+
+  // Map.change_counter at the last full relight
+  uint32_t map_stamp;
+  bool map_stamp_valid;
+} LightingState;
+
+// Re-propagate light around sources that changed since the last call;
+// a cheap no-op when nothing moved. Called once per frame
+void lighting_update(void);
+
+// Precomputed torch falloff for one radius: LIGHT_FULL at distance 0
+// down to LIGHT_DARK at distance == radius, valid for indices
+// 0..radius. Shared so anything tinting by distance (render effects,
+// future source shapes) uses the exact same curve as propagation
+const uint8_t *lighting_falloff(int radius);
@@ -1,5 +1,6 @@
 #include "map.h"
 #include "api.h"
+#include "chunk_dict.h"
 #include "mapgen/mapgen.h"
 #include "random.h"
 #include "render_api.h"
@@ -11,6 +12,27 @@
 
 #define CHUNK_BUFFER_SIZE (512 * 1024)
 
+void map_rebuild_bitplanes(Map *map) {
+  // only the passable plane derives from the cells; the visible plane is
+  // owned by fov_compute and must survive map changes that land between
+  // player moves (deferred chunk completion), or fog-of-war flickers
+  memset(map->passable_bits, 0, sizeof(map->passable_bits));
+  for (int i = 0; i < MAP_WIDTH_MAX * MAP_HEIGHT_MAX; i++) {
+    if (map->cells[i].passable) {
+      map->passable_bits[i >> 6] |= 1ull << (i & 63);
+    }
+  }
+}
+
+void map_mark_changed(void) {
+  WORLD.map.change_counter++;
+  WORLD.frame_damage = true;
+  map_rebuild_bitplanes(&WORLD.map);
+  WORLD.fov_cache.valid = false; // new terrain can block or open sightlines
+  hpa_invalidate();
+  flowfield_invalidate();
+}
+
 bool map_get_random_passable(Map *map, int region_x, int region_y,
                              int region_width, int region_height,
                              Position *out_pos, int max_attempts) {
@@ -18,7 +40,7 @@ bool map_get_random_passable(Map *map, int region_x, int region_y,
     int x = region_x + random64() % region_width;
     int y = region_y + random64() % region_height;
 
-    if (map->cells[y * MAP_WIDTH_MAX + x].passable) {
+    if (map_is_passable(map, x, y)) {
       out_pos->x = x;
       out_pos->y = y;
       return true;
@@ -28,51 +50,222 @@ bool map_get_random_passable(Map *map, int region_x, int region_y,
   return false;
 }
 
-// Generate a single chunk with boundary constraints from neighbors
-// chunk_x, chunk_y are local window coordinates (0-2)
-void generate_chunk(int chunk_x, int chunk_y) {
+static uint64_t calc_chunk_key(int world_chunk_x, int world_chunk_y) {
+  // Pack chunk coordinates into a 64-bit key
+  // Upper 32 bits: world_chunk_y, Lower 32 bits: world_chunk_x
+  return ((uint64_t)world_chunk_y << 32) | (uint64_t)world_chunk_x;
+}
+
+// Parameters every chunk is generated with (also what the deferred task
+// in map_generate_pending uses, so baselines match across both paths)
+static const CSPGenParams chunk_csp_params = {
+    .iterations = 100000,
+    .attempts_per_tile = 5,
+};
+
+static uint64_t chunk_gen_seed(int world_chunk_x, int world_chunk_y) {
+  return random_key(WORLD.world_seed,
+                    calc_chunk_key(world_chunk_x, world_chunk_y));
+}
+
+// Copy a finished baseline into the window region
+// (chunk_x, chunk_y are local window coordinates)
+static void copy_baseline_into_window(const Map *baseline, int chunk_x,
+                                      int chunk_y) {
+  int region_x = chunk_x * MAP_CHUNK_WIDTH;
+  int region_y = chunk_y * MAP_CHUNK_HEIGHT;
+  for (int y = 0; y < MAP_CHUNK_HEIGHT; y++) {
+    int dst_idx = (region_y + y) * MAP_WIDTH_MAX + region_x;
+    int src_idx = y * MAP_WIDTH_MAX;
+    memcpy(&WORLD.map.cells[dst_idx], &baseline->cells[src_idx],
+           MAP_CHUNK_WIDTH * sizeof(MapCell));
+    memcpy(&WORLD.map.water_depth[dst_idx], &baseline->water_depth[src_idx],
+           MAP_CHUNK_WIDTH);
+  }
+}
+
+// Claim the least-recently-used cache slot for a new baseline
+static BaselineCacheEntry *baseline_cache_evict(uint64_t key) {
+  BaselineCache *cache = &WORLD.baseline_cache;
+  BaselineCacheEntry *victim = &cache->entries[0];
+  for (int i = 1; i < BASELINE_CACHE_SLOTS; i++) {
+    if (cache->entries[i].stamp < victim->stamp) {
+      victim = &cache->entries[i];
+    }
+  }
+  victim->key = key;
+  victim->stamp = ++cache->counter;
+  return victim;
+}
+
+// Densely pack a baseline produced in a window-strided scratch map
+static void baseline_cache_fill(BaselineCacheEntry *entry,
+                                const Map *baseline) {
+  for (int y = 0; y < MAP_CHUNK_HEIGHT; y++) {
+    memcpy(&entry->cells[y * MAP_CHUNK_WIDTH],
+           &baseline->cells[y * MAP_WIDTH_MAX],
+           MAP_CHUNK_WIDTH * sizeof(MapCell));
+    memcpy(&entry->water_depth[y * MAP_CHUNK_WIDTH],
+           &baseline->water_depth[y * MAP_WIDTH_MAX], MAP_CHUNK_WIDTH);
+  }
+}
+
+// The chunk's deterministic baseline: the generator runs on its own RNG
+// stream seeded from the world seed and the chunk key, so the result
+// depends on nothing but (seed, chunk coordinates) -- which is what lets
+// serialization store only deltas against it. Recent baselines come from
+// the LRU cache (seeded by deferred generation and by this miss path);
+// only a cold chunk pays for the full CSP solve here
+static const BaselineCacheEntry *chunk_baseline_get(int world_chunk_x,
+                                                    int world_chunk_y) {
+  uint64_t key = chunk_gen_seed(world_chunk_x, world_chunk_y);
+
+  BaselineCache *cache = &WORLD.baseline_cache;
+  for (int i = 0; i < BASELINE_CACHE_SLOTS; i++) {
+    BaselineCacheEntry *entry = &cache->entries[i];
+    if (entry->stamp != 0 && entry->key == key) {
+      entry->stamp = ++cache->counter;
+      return entry;
+    }
+  }
+
+  ArenaCheckpoint checkpoint = arena_checkpoint(&WORLD.turn_arena);
+  Map *baseline = arena_alloc(&WORLD.turn_arena, sizeof(Map));
+  baseline->width = MAP_CHUNK_WIDTH;
+  baseline->height = MAP_CHUNK_HEIGHT;
+  CSPGenTask task;
+  mapgen_csp_task_begin(&task, baseline, 0, 0, MAP_CHUNK_WIDTH,
+                        MAP_CHUNK_HEIGHT, &chunk_csp_params, key);
+  mapgen_csp_task_step(&task, chunk_csp_params.iterations);
+
+  BaselineCacheEntry *entry = baseline_cache_evict(key);
+  baseline_cache_fill(entry, baseline);
+  arena_restore(&WORLD.turn_arena, checkpoint);
+  return entry;
+}
+
+// Copy a cached baseline into the window region
+// (chunk_x, chunk_y are local window coordinates)
+static void apply_chunk_baseline(int chunk_x, int chunk_y) {
+  int world_chunk_x = WORLD.worldmap.curr_chunk_x + (chunk_x - 1);
+  int world_chunk_y = WORLD.worldmap.curr_chunk_y + (chunk_y - 1);
+
+  const BaselineCacheEntry *baseline =
+      chunk_baseline_get(world_chunk_x, world_chunk_y);
+  int region_x = chunk_x * MAP_CHUNK_WIDTH;
+  int region_y = chunk_y * MAP_CHUNK_HEIGHT;
+  for (int y = 0; y < MAP_CHUNK_HEIGHT; y++) {
+    int dst_idx = (region_y + y) * MAP_WIDTH_MAX + region_x;
+    memcpy(&WORLD.map.cells[dst_idx], &baseline->cells[y * MAP_CHUNK_WIDTH],
+           MAP_CHUNK_WIDTH * sizeof(MapCell));
+    memcpy(&WORLD.map.water_depth[dst_idx],
+           &baseline->water_depth[y * MAP_CHUNK_WIDTH], MAP_CHUNK_WIDTH);
+  }
+}
+
+void map_queue_generate_chunk(int chunk_x, int chunk_y) {
   assert(chunk_x >= 0 && chunk_x < MAP_CHUNK_WINDOW_X);
   assert(chunk_y >= 0 && chunk_y < MAP_CHUNK_WINDOW_Y);
 
-  // Calculate world chunk coordinates
   int world_chunk_x = WORLD.worldmap.curr_chunk_x + (chunk_x - 1);
   int world_chunk_y = WORLD.worldmap.curr_chunk_y + (chunk_y - 1);
-  assert(world_chunk_x >= 0 && world_chunk_x < MAP_CHUNK_TOTAL_X);
-  assert(world_chunk_y >= 0 && world_chunk_y < MAP_CHUNK_TOTAL_Y);
-
   int world_chunk_idx = world_chunk_y * MAP_CHUNK_TOTAL_X + world_chunk_x;
 
-  // Don't regenerate if already loaded or currently loading
   ChunkState state = WORLD.worldmap.chunks[world_chunk_idx].state;
-  if (state == CHUNK_LOADED || state == CHUNK_LOADING) {
+  if (state == CHUNK_LOADED) {
     return;
   }
 
-  CSPGenParams csp_params = {
-      .iterations = 100000,
-      .attempts_per_tile = 5,
-  };
+  // Already queued?
+  for (int i = 0; i < WORLD.worldmap.pending_gen_count; i++) {
+    if (WORLD.worldmap.pending_gen[i] == world_chunk_idx) {
+      return;
+    }
+  }
 
-  int region_x = chunk_x * MAP_CHUNK_WIDTH;
-  int region_y = chunk_y * MAP_CHUNK_HEIGHT;
+  assert(WORLD.worldmap.pending_gen_count <
+         (int)(MAP_CHUNK_WINDOW_X * MAP_CHUNK_WINDOW_Y));
+  WORLD.worldmap.chunks[world_chunk_idx].state = CHUNK_LOADING;
+  WORLD.worldmap.pending_gen[WORLD.worldmap.pending_gen_count++] =
+      world_chunk_idx;
+}
 
-  mapgen_csp_region(&WORLD.map, region_x, region_y, MAP_CHUNK_WIDTH,
-                    MAP_CHUNK_HEIGHT, &csp_params);
+// Refinement iterations spent per frame on the in-progress chunk task
+// (a full chunk is 100000 iterations, so a fresh chunk completes in a
+// handful of frames instead of stalling one)
+#define CSP_ITERATIONS_PER_FRAME 15000
 
-  WORLD.worldmap.chunks[world_chunk_idx].state = CHUNK_LOADED;
+void map_generate_pending(void) {
+  WorldMap *wm = &WORLD.worldmap;
 
-  PRINT(msg, 64, "Generated chunk (");
-  print_int(&msg, world_chunk_x);
-  print_str(&msg, ", ");
-  print_int(&msg, world_chunk_y);
-  print_char(&msg, ')');
-  output_message(msg.data);
-}
+  // Drive the in-progress generation task within this frame's budget
+  if (WORLD.gen_task_active) {
+    if (!mapgen_csp_task_step(&WORLD.gen_task, CSP_ITERATIONS_PER_FRAME)) {
+      return; // Budget spent, resume next frame
+    }
+    WORLD.gen_task_active = false;
+
+    int world_chunk_idx = WORLD.gen_world_chunk_idx;
+    int world_chunk_x = world_chunk_idx % MAP_CHUNK_TOTAL_X;
+    int world_chunk_y = world_chunk_idx / MAP_CHUNK_TOTAL_X;
+
+    // Seed the baseline cache with the finished solve, so the eventual
+    // page-out delta (and a later page-in) reuse it instead of
+    // re-solving synchronously
+    baseline_cache_fill(
+        baseline_cache_evict(chunk_gen_seed(world_chunk_x, world_chunk_y)),
+        &WORLD.gen_scratch);
+
+    int chunk_x = world_chunk_x - wm->curr_chunk_x + 1;
+    int chunk_y = world_chunk_y - wm->curr_chunk_y + 1;
+    if (chunk_x < 0 || chunk_x >= MAP_CHUNK_WINDOW_X || chunk_y < 0 ||
+        chunk_y >= MAP_CHUNK_WINDOW_Y) {
+      // Left the window mid-generation; drop the result (generation is
+      // deterministic, so nothing is lost if the player comes back)
+      wm->chunks[world_chunk_idx].state = CHUNK_UNLOADED;
+    } else {
+      copy_baseline_into_window(&WORLD.gen_scratch, chunk_x, chunk_y);
+      wm->chunks[world_chunk_idx].state = CHUNK_LOADED;
+      map_mark_changed();
+
+      PRINT(msg, 64, "Generated chunk (");
+      print_int(&msg, world_chunk_x);
+      print_str(&msg, ", ");
+      print_int(&msg, world_chunk_y);
+      print_char(&msg, ')');
+      output_message(msg.data);
+    }
+  }
 
-static uint64_t calc_chunk_key(int world_chunk_x, int world_chunk_y) {
-  // Pack chunk coordinates into a 64-bit key
-  // Upper 32 bits: world_chunk_y, Lower 32 bits: world_chunk_x
-  return ((uint64_t)world_chunk_y << 32) | (uint64_t)world_chunk_x;
+  // Start the next queued chunk
+  while (wm->pending_gen_count > 0) {
+    int world_chunk_idx = wm->pending_gen[0];
+    wm->pending_gen_count--;
+    memmove(&wm->pending_gen[0], &wm->pending_gen[1],
+            wm->pending_gen_count * sizeof(wm->pending_gen[0]));
+
+    // The window may have shifted since this chunk was queued
+    int world_chunk_x = world_chunk_idx % MAP_CHUNK_TOTAL_X;
+    int world_chunk_y = world_chunk_idx / MAP_CHUNK_TOTAL_X;
+    int chunk_x = world_chunk_x - wm->curr_chunk_x + 1;
+    int chunk_y = world_chunk_y - wm->curr_chunk_y + 1;
+    if (chunk_x < 0 || chunk_x >= MAP_CHUNK_WINDOW_X || chunk_y < 0 ||
+        chunk_y >= MAP_CHUNK_WINDOW_Y) {
+      // Left the window before its turn came up; let page-in re-request
+      // it if the player comes back
+      wm->chunks[world_chunk_idx].state = CHUNK_UNLOADED;
+      continue;
+    }
+
+    WORLD.gen_scratch.width = MAP_CHUNK_WIDTH;
+    WORLD.gen_scratch.height = MAP_CHUNK_HEIGHT;
+    mapgen_csp_task_begin(&WORLD.gen_task, &WORLD.gen_scratch, 0, 0,
+                          MAP_CHUNK_WIDTH, MAP_CHUNK_HEIGHT, &chunk_csp_params,
+                          chunk_gen_seed(world_chunk_x, world_chunk_y));
+    WORLD.gen_task_active = true;
+    WORLD.gen_world_chunk_idx = world_chunk_idx;
+    return;
+  }
 }
 
 // Serialize a chunk's map data and entities into a buffer
@@ -82,21 +275,71 @@ static void serialize_chunk(int chunk_x, int chunk_y, ByteBuffer *buf,
   int region_x = chunk_x * MAP_CHUNK_WIDTH;
   int region_y = chunk_y * MAP_CHUNK_HEIGHT;
 
-  // Pack chunk format version (for future compatibility)
-  bbuf_pack_u32(buf, 1, "chunk_version");
+  // Pack chunk format version (3 = RLE delta runs + bulk arrays,
+  // 2 was per-delta records, 1 was full rows)
+  bbuf_pack_u32(buf, 3, "chunk_version");
+
+  // Fetch the deterministic baseline (cached, see chunk_baseline_get)
+  // and store only the tiles that differ from it (dug walls, altered
+  // terrain, changed water); untouched chunks serialize to a handful of
+  // bytes
+  int world_chunk_x = WORLD.worldmap.curr_chunk_x + (chunk_x - 1);
+  int world_chunk_y = WORLD.worldmap.curr_chunk_y + (chunk_y - 1);
+  const BaselineCacheEntry *baseline =
+      chunk_baseline_get(world_chunk_x, world_chunk_y);
 
-  // Pack map cells for this chunk region (row by row)
+  uint16_t delta_idx[MAP_CHUNK_WIDTH * MAP_CHUNK_HEIGHT];
+  uint32_t delta_count = 0;
   for (int y = 0; y < MAP_CHUNK_HEIGHT; y++) {
-    int map_y = region_y + y;
-    int start_idx = map_y * MAP_WIDTH_MAX + region_x;
+    for (int x = 0; x < MAP_CHUNK_WIDTH; x++) {
+      int map_idx = (region_y + y) * MAP_WIDTH_MAX + region_x + x;
+      int base_idx = y * MAP_CHUNK_WIDTH + x;
+      if (memcmp(&WORLD.map.cells[map_idx], &baseline->cells[base_idx],
+                 sizeof(MapCell)) != 0 ||
+          WORLD.map.water_depth[map_idx] != baseline->water_depth[base_idx]) {
+        delta_idx[delta_count++] = (uint16_t)(y * MAP_CHUNK_WIDTH + x);
+      }
+    }
+  }
 
-    // Copy entire row of cells and water depth
-    bbuf_pack_bytes(buf, &WORLD.map.cells[start_idx],
-                    MAP_CHUNK_WIDTH * sizeof(MapCell), "map_cells_row");
-    bbuf_pack_bytes(buf, &WORLD.map.water_depth[start_idx], MAP_CHUNK_WIDTH,
-                    "water_depth_row");
+  // Delta positions as run-length pairs (digging and water changes make
+  // contiguous runs), then the cells and water depths as two bulk
+  // arrays: a touched chunk costs a few varints and two memcpy-sized
+  // writes instead of three calls per delta
+  uint32_t run_count = 0;
+  for (uint32_t i = 0; i < delta_count; i++) {
+    if (i == 0 || delta_idx[i] != delta_idx[i - 1] + 1) {
+      run_count++;
+    }
+  }
+  bbuf_pack_varint(buf, run_count, "cell_delta_runs");
+  uint32_t prev_end = 0;
+  for (uint32_t i = 0; i < delta_count;) {
+    uint32_t start = delta_idx[i];
+    uint32_t length = 1;
+    while (i + length < delta_count &&
+           delta_idx[i + length] == start + length) {
+      length++;
+    }
+    bbuf_pack_varint(buf, start - prev_end, "cell_delta_gap");
+    bbuf_pack_varint(buf, length, "cell_delta_run_length");
+    prev_end = start + length;
+    i += length;
   }
 
+  MapCell delta_cells[MAP_CHUNK_WIDTH * MAP_CHUNK_HEIGHT];
+  uint8_t delta_water[MAP_CHUNK_WIDTH * MAP_CHUNK_HEIGHT];
+  for (uint32_t i = 0; i < delta_count; i++) {
+    int local = delta_idx[i];
+    int map_idx = (region_y + local / MAP_CHUNK_WIDTH) * MAP_WIDTH_MAX +
+                  region_x + local % MAP_CHUNK_WIDTH;
+    delta_cells[i] = WORLD.map.cells[map_idx];
+    delta_water[i] = WORLD.map.water_depth[map_idx];
+  }
+  bbuf_pack_bytes(buf, delta_cells, delta_count * sizeof(MapCell),
+                  "cell_deltas");
+  bbuf_pack_u8_array(buf, delta_water, delta_count, "water_deltas");
+
   // Collect all entities in this chunk region
   *out_entities = (EntitySet){0};
 
@@ -112,12 +355,12 @@ static void serialize_chunk(int chunk_x, int chunk_y, ByteBuffer *buf,
   entityset_expand_descendants(out_entities);
 
   // Pack entity count
-  bbuf_pack_u32(buf, out_entities->count, "entity_count");
+  bbuf_pack_varint(buf, out_entities->count, "entity_count");
 
   // Pack each entity with its original index (for parent remapping)
   for (uint32_t i = 0; i < out_entities->count; i++) {
-    EntityIndex entity = out_entities->entities[i];
-    bbuf_pack_u16(buf, entity, "entity_old_index");
+    EntityIndex entity = entityset_get(out_entities, i);
+    bbuf_pack_varint(buf, entity, "entity_old_index");
     entity_pack(entity, buf);
   }
 }
@@ -125,11 +368,18 @@ static void serialize_chunk(int chunk_x, int chunk_y, ByteBuffer *buf,
 // Deserialize a chunk's map data and entities from a buffer
 void deserialize_chunk(int chunk_x, int chunk_y, const void *data,
                        size_t data_size) {
-  ArenaCheckpoint checkpoint = arena_checkpoint(&WORLD.arena);
-  uint8_t *decompressed_buffer = arena_alloc(&WORLD.arena, CHUNK_BUFFER_SIZE);
-
-  int decompressed_size =
-      sinflate(decompressed_buffer, (const uint8_t *)data, data_size);
+  ArenaCheckpoint checkpoint = arena_checkpoint(&WORLD.turn_arena);
+
+  // prime the decompression history with the preset dictionary; the
+  // payload lands after it (streams from before the dictionary never
+  // reference it and decode unchanged)
+  uint8_t *decompressed_buffer =
+      arena_alloc(&WORLD.turn_arena, CHUNK_DICT_SIZE + CHUNK_BUFFER_SIZE);
+  memcpy(decompressed_buffer, chunk_dict(), CHUNK_DICT_SIZE);
+
+  int decompressed_size = sinflate_dict(decompressed_buffer,
+                                        (const uint8_t *)data, data_size,
+                                        CHUNK_DICT_SIZE);
   assert(decompressed_size > 0 && "Decompression failed");
   assert(decompressed_size <= CHUNK_BUFFER_SIZE);
 
@@ -137,29 +387,79 @@ void deserialize_chunk(int chunk_x, int chunk_y, const void *data,
       .size = decompressed_size,
       .read_pos = 0,
       .capacity = decompressed_size,
-      .data = decompressed_buffer,
+      .data = decompressed_buffer + CHUNK_DICT_SIZE,
   };
 
   // Unpack version
   uint32_t version = bbuf_unpack_u32(&buf, "chunk_version");
-  (void)version; // Unused for now, but could check compatibility
 
   int region_x = chunk_x * MAP_CHUNK_WIDTH;
   int region_y = chunk_y * MAP_CHUNK_HEIGHT;
 
-  // Unpack map cells (row by row)
-  for (int y = 0; y < MAP_CHUNK_HEIGHT; y++) {
-    int map_y = region_y + y;
-    int start_idx = map_y * MAP_WIDTH_MAX + region_x;
+  if (version >= 3) {
+    // Rebuild the deterministic baseline, expand the delta runs back
+    // into local indices, then scatter the two bulk arrays
+    apply_chunk_baseline(chunk_x, chunk_y);
+
+    uint16_t delta_idx[MAP_CHUNK_WIDTH * MAP_CHUNK_HEIGHT];
+    uint32_t delta_count = 0;
+    uint32_t run_count = (uint32_t)bbuf_unpack_varint(&buf, "cell_delta_runs");
+    uint32_t prev_end = 0;
+    for (uint32_t r = 0; r < run_count; r++) {
+      uint32_t start =
+          prev_end + (uint32_t)bbuf_unpack_varint(&buf, "cell_delta_gap");
+      uint32_t length =
+          (uint32_t)bbuf_unpack_varint(&buf, "cell_delta_run_length");
+      assert(start + length <= MAP_CHUNK_WIDTH * MAP_CHUNK_HEIGHT);
+      for (uint32_t j = 0; j < length; j++) {
+        delta_idx[delta_count++] = (uint16_t)(start + j);
+      }
+      prev_end = start + length;
+    }
 
-    bbuf_unpack_bytes(&buf, &WORLD.map.cells[start_idx],
-                      MAP_CHUNK_WIDTH * sizeof(MapCell), "map_cells_row");
-    bbuf_unpack_bytes(&buf, &WORLD.map.water_depth[start_idx], MAP_CHUNK_WIDTH,
-                      "water_depth_row");
+    MapCell delta_cells[MAP_CHUNK_WIDTH * MAP_CHUNK_HEIGHT];
+    uint8_t delta_water[MAP_CHUNK_WIDTH * MAP_CHUNK_HEIGHT];
+    bbuf_unpack_bytes(&buf, delta_cells, delta_count * sizeof(MapCell),
+                      "cell_deltas");
+    bbuf_unpack_u8_array(&buf, delta_water, delta_count, "water_deltas");
+    for (uint32_t i = 0; i < delta_count; i++) {
+      int local = delta_idx[i];
+      int map_idx = (region_y + local / MAP_CHUNK_WIDTH) * MAP_WIDTH_MAX +
+                    region_x + local % MAP_CHUNK_WIDTH;
+      WORLD.map.cells[map_idx] = delta_cells[i];
+      WORLD.map.water_depth[map_idx] = delta_water[i];
+    }
+  } else if (version == 2) {
+    // Version 2: baseline plus one record per delta
+    apply_chunk_baseline(chunk_x, chunk_y);
+
+    uint32_t delta_count =
+        (uint32_t)bbuf_unpack_varint(&buf, "cell_delta_count");
+    for (uint32_t i = 0; i < delta_count; i++) {
+      int local = (int)bbuf_unpack_varint(&buf, "cell_delta_index");
+      assert(local >= 0 && local < MAP_CHUNK_WIDTH * MAP_CHUNK_HEIGHT);
+      int map_idx = (region_y + local / MAP_CHUNK_WIDTH) * MAP_WIDTH_MAX +
+                    region_x + local % MAP_CHUNK_WIDTH;
+      bbuf_unpack_bytes(&buf, &WORLD.map.cells[map_idx], sizeof(MapCell),
+                        "cell_delta");
+      bbuf_unpack_bytes(&buf, &WORLD.map.water_depth[map_idx], 1,
+                        "water_delta");
+    }
+  } else {
+    // Version 1: full row snapshots
+    for (int y = 0; y < MAP_CHUNK_HEIGHT; y++) {
+      int map_y = region_y + y;
+      int start_idx = map_y * MAP_WIDTH_MAX + region_x;
+
+      bbuf_unpack_bytes(&buf, &WORLD.map.cells[start_idx],
+                        MAP_CHUNK_WIDTH * sizeof(MapCell), "map_cells_row");
+      bbuf_unpack_bytes(&buf, &WORLD.map.water_depth[start_idx],
+                        MAP_CHUNK_WIDTH, "water_depth_row");
+    }
   }
 
   // Unpack entity count
-  uint32_t entity_count = bbuf_unpack_u32(&buf, "entity_count");
+  uint32_t entity_count = (uint32_t)bbuf_unpack_varint(&buf, "entity_count");
 
   // Build old_index -> new_index remapping table
   // Use 0 as sentinel for "not mapped" (entity 0 is reserved/invalid)
@@ -168,7 +468,8 @@ void deserialize_chunk(int chunk_x, int chunk_y, const void *data,
 
   // Unpack each entity and build remap table
   for (uint32_t i = 0; i < entity_count; i++) {
-    EntityIndex old_index = bbuf_unpack_u16(&buf, "entity_old_index");
+    EntityIndex old_index =
+        (EntityIndex)bbuf_unpack_varint(&buf, "entity_old_index");
     EntityIndex new_index = entity_unpack(&buf);
     remap[old_index] = new_index;
   }
@@ -193,7 +494,12 @@ void deserialize_chunk(int chunk_x, int chunk_y, const void *data,
     }
   }
 
-  arena_restore(&WORLD.arena, checkpoint);
+  // Parent values were rewritten wholesale, so rebuild the child links
+  hierarchy_rebuild();
+
+  map_mark_changed();
+
+  arena_restore(&WORLD.turn_arena, checkpoint);
 }
 
 static void page_in_chunk(int chunk_x, int chunk_y) {
@@ -254,27 +560,33 @@ static void page_out_chunk(int chunk_x, int chunk_y) {
     return; // Not loaded, nothing to save
   }
 
-  // Save arena checkpoint
-  ArenaCheckpoint checkpoint = arena_checkpoint(&WORLD.arena);
+  // Save arena checkpoint. The entity set below spills into the frame
+  // arena when the chunk holds more than the inline capacity, so bracket
+  // that arena too
+  ArenaCheckpoint checkpoint = arena_checkpoint(&WORLD.turn_arena);
+  ArenaCheckpoint frame_checkpoint = arena_checkpoint(&WORLD.frame_arena);
 
-  // Allocate serialization buffer from arena
-  uint8_t *buffer = arena_alloc(&WORLD.arena, CHUNK_BUFFER_SIZE);
+  // Allocate serialization buffer from arena, with the preset dictionary
+  // placed contiguously in front so it primes the compression window
+  uint8_t *buffer = arena_alloc(&WORLD.turn_arena, CHUNK_DICT_SIZE + CHUNK_BUFFER_SIZE);
+  memcpy(buffer, chunk_dict(), CHUNK_DICT_SIZE);
   ByteBuffer buf = {
       .size = 0,
       .capacity = CHUNK_BUFFER_SIZE,
-      .data = buffer,
+      .data = buffer + CHUNK_DICT_SIZE,
   };
 
   EntitySet entities_to_free;
   serialize_chunk(chunk_x, chunk_y, &buf, &entities_to_free);
 
-  // Compress the serialized data
+  // Compress the serialized data against the dictionary
   int uncompressed_size = buf.size;
   int max_compressed_size = sdefl_bound(uncompressed_size);
-  uint8_t *compressed_buffer = arena_alloc(&WORLD.arena, max_compressed_size);
-  struct sdefl *sdefl_ctx = arena_alloc(&WORLD.arena, sizeof(struct sdefl));
-  int compressed_size = sdeflate(sdefl_ctx, compressed_buffer, buf.data,
-                                 uncompressed_size, SDEFL_LVL_DEF);
+  uint8_t *compressed_buffer = arena_alloc(&WORLD.turn_arena, max_compressed_size);
+  struct sdefl *sdefl_ctx = arena_alloc(&WORLD.turn_arena, sizeof(struct sdefl));
+  int compressed_size = sdeflate_dict(sdefl_ctx, compressed_buffer, buffer,
+                                      CHUNK_DICT_SIZE, uncompressed_size,
+                                      SDEFL_LVL_DEF);
 
   // Store compressed chunk to host storage
   uint64_t chunk_key = calc_chunk_key(world_chunk_x, world_chunk_y);
@@ -292,12 +604,14 @@ static void page_out_chunk(int chunk_x, int chunk_y) {
 
   host_store_chunk(chunk_key, compressed_buffer, compressed_size);
 
-  // Restore arena checkpoint to free compression buffers
-  arena_restore(&WORLD.arena, checkpoint);
-
-  // Free all entities that were saved (including descendants)
+  // Free all entities that were saved (including descendants). Must happen
+  // before the arena restore since the set may have spilled into the arena
   entityset_free(&entities_to_free);
 
+  // Restore arena checkpoints to free compression buffers and the set
+  arena_restore(&WORLD.frame_arena, frame_checkpoint);
+  arena_restore(&WORLD.turn_arena, checkpoint);
+
   // Mark as unloaded
   WORLD.worldmap.chunks[world_chunk_idx].state = CHUNK_UNLOADED;
 }
@@ -399,41 +713,96 @@ static void shift_map_window(int dx, int dy) {
       }
     }
   }
+
+  // All positions moved wholesale, so rebuild the tile -> entity index
+  spatial_index_rebuild();
+
+  // The bulk rewrite above bypassed per-entity dirty tracking, so the
+  // autosave delta chain is stale; take a fresh baseline next turn
+  autosave_request_baseline();
+
+  // The whole window shifted under the portal graph and the flow field
+  map_mark_changed();
+}
+
+// How many tiles before a chunk boundary the window shifts speculatively,
+// and how many consecutive steps toward it the player must have taken.
+// The margin doubles as hysteresis on the hard recenter so a predictive
+// shift is not undone by the very next check
+#define CHUNK_PREFETCH_MARGIN 4
+#define CHUNK_PREFETCH_MIN_RUN 3
+
+// Decide the window shift along one axis. pos is the player's window
+// coordinate, so the center chunk spans [chunk_size, 2 * chunk_size)
+static int window_shift_for_axis(int pos, int chunk_size, int heading_run) {
+  // Hard recenter once the player is well inside an edge chunk
+  if (pos >= 2 * chunk_size + CHUNK_PREFETCH_MARGIN) {
+    return 1;
+  }
+  if (pos < chunk_size - CHUNK_PREFETCH_MARGIN) {
+    return -1;
+  }
+  // Predictive shift: consistent heading toward a nearby boundary, so
+  // the incoming row/column starts loading before the player reaches it
+  if (heading_run >= CHUNK_PREFETCH_MIN_RUN &&
+      pos >= 2 * chunk_size - CHUNK_PREFETCH_MARGIN) {
+    return 1;
+  }
+  if (heading_run <= -CHUNK_PREFETCH_MIN_RUN &&
+      pos < chunk_size + CHUNK_PREFETCH_MARGIN) {
+    return -1;
+  }
+  return 0;
 }
 
-// Check if player entered a new chunk and generate neighbors if needed
+// Check if player entered (or is heading into) a new chunk and shift the
+// window / page chunks as needed
 void ensure_chunks_around_position(int player_x, int player_y) {
-  // Calculate which chunk the player is in (within the 3x3 window)
-  int player_chunk_x = player_x / MAP_CHUNK_WIDTH;  // 0, 1, or 2
-  int player_chunk_y = player_y / MAP_CHUNK_HEIGHT; // 0, 1, or 2
-  assert(player_chunk_x >= 0 && player_chunk_x <= MAP_CHUNK_WINDOW_X);
-  assert(player_chunk_y >= 0 && player_chunk_y <= MAP_CHUNK_WINDOW_Y);
-  // Calculate offset from center chunk
-  int dx = player_chunk_x - MAP_CHUNK_WINDOW_X / 2; // -1, 0, or +1
-  int dy = player_chunk_y - MAP_CHUNK_WINDOW_Y / 2; // -1, 0, or +1
-  assert(dx * dx <= 1);
-  assert(dy * dy <= 1);
+  WorldMap *wm = &WORLD.worldmap;
+  assert(player_x >= 0 && player_x < MAP_WIDTH_MAX);
+  assert(player_y >= 0 && player_y < MAP_HEIGHT_MAX);
+
+  // Update per-axis heading runs from the step since last call (prev is
+  // stored post-shift, so window shifts don't register as movement)
+  int step_x = player_x - wm->prev_player_x;
+  int step_y = player_y - wm->prev_player_y;
+  if (step_x > 0) {
+    wm->heading_run_x = wm->heading_run_x > 0 ? wm->heading_run_x + 1 : 1;
+  } else if (step_x < 0) {
+    wm->heading_run_x = wm->heading_run_x < 0 ? wm->heading_run_x - 1 : -1;
+  }
+  if (step_y > 0) {
+    wm->heading_run_y = wm->heading_run_y > 0 ? wm->heading_run_y + 1 : 1;
+  } else if (step_y < 0) {
+    wm->heading_run_y = wm->heading_run_y < 0 ? wm->heading_run_y - 1 : -1;
+  }
 
-  if (dx != 0 || dy != 0) {
-    int new_chunk_x = WORLD.worldmap.curr_chunk_x + dx;
-    int new_chunk_y = WORLD.worldmap.curr_chunk_y + dy;
-
-    // Ensure we stay within world bounds (with room for 3x3 window)
-    if (new_chunk_x < 1 || new_chunk_x >= MAP_CHUNK_TOTAL_X - 1 ||
-        new_chunk_y < 1 || new_chunk_y >= MAP_CHUNK_TOTAL_Y - 1) {
-      // Hit world edge - don't allow movement
-      host_log(LOG_WARN, "Cannot move - world boundary reached");
-      return;
-    }
+  int dx = window_shift_for_axis(player_x, MAP_CHUNK_WIDTH, wm->heading_run_x);
+  int dy = window_shift_for_axis(player_y, MAP_CHUNK_HEIGHT, wm->heading_run_y);
 
-    // Player crossed chunk boundary - shift the window
+  // Clamp each axis at the world edge (need room for the 3x3 window)
+  int new_chunk_x = wm->curr_chunk_x + dx;
+  int new_chunk_y = wm->curr_chunk_y + dy;
+  if (new_chunk_x < 1 || new_chunk_x >= MAP_CHUNK_TOTAL_X - 1) {
+    dx = 0;
+  }
+  if (new_chunk_y < 1 || new_chunk_y >= MAP_CHUNK_TOTAL_Y - 1) {
+    dy = 0;
+  }
+
+  if (dx != 0 || dy != 0) {
     shift_map_window(dx, dy);
+    wm->curr_chunk_x += dx;
+    wm->curr_chunk_y += dy;
 
-    // Update world chunk coordinates
-    WORLD.worldmap.curr_chunk_x = new_chunk_x;
-    WORLD.worldmap.curr_chunk_y = new_chunk_y;
+    // Positions (the player's included) just shifted under us
+    player_x -= dx * MAP_CHUNK_WIDTH;
+    player_y -= dy * MAP_CHUNK_HEIGHT;
   }
 
+  wm->prev_player_x = player_x;
+  wm->prev_player_y = player_y;
+
   // Generate only the chunk the player is standing on (center chunk)
   // Later we will make this ensure the 3x3 around the player is generated,
   // but for now only the single chunk so we can see them being generated
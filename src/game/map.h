@@ -4,18 +4,56 @@
 
 typedef struct {
   uint32_t passable : 1;
-  uint32_t visible : 1;
+  uint32_t visible : 1; // unused (always 0): visibility lives in the
+                        // visible_bits plane, owned by fov_compute; the
+                        // bit stays so serialized cells keep their layout
   uint32_t tile : 14;
   uint32_t category : 4;
 } MapCell;
 
+#define MAP_BITSET_WORDS ((MAP_WIDTH_MAX * MAP_HEIGHT_MAX + 63) / 64)
+
 typedef struct {
   int width;
   int height;
+  uint32_t change_counter; // bumped by map_mark_changed
+
+  // Bit planes so FOV, flood fill and path cost callbacks test one bit
+  // per tile instead of dragging the full cell array through cache, and
+  // so visibility clears are a handful of word writes. The passable
+  // plane is derived from the cells by map_mark_changed; the visible
+  // plane is owned by fov_compute
+  uint64_t passable_bits[MAP_BITSET_WORDS];
+  uint64_t visible_bits[MAP_BITSET_WORDS];
+
   MapCell cells[MAP_WIDTH_MAX * MAP_HEIGHT_MAX];
   uint8_t water_depth[MAP_WIDTH_MAX * MAP_HEIGHT_MAX];
+
+  // Per-tile light levels, owned by lighting_update (derived state:
+  // rebuilt from LightSource entities, never serialized)
+  uint8_t light[MAP_WIDTH_MAX * MAP_HEIGHT_MAX];
 } Map;
 
+static inline bool map_is_passable(const Map *map, int x, int y) {
+  int idx = y * MAP_WIDTH_MAX + x;
+  return (map->passable_bits[idx >> 6] >> (idx & 63)) & 1;
+}
+
+static inline bool map_is_visible(const Map *map, int x, int y) {
+  int idx = y * MAP_WIDTH_MAX + x;
+  return (map->visible_bits[idx >> 6] >> (idx & 63)) & 1;
+}
+
+static inline void map_set_visible(Map *map, int x, int y) {
+  int idx = y * MAP_WIDTH_MAX + x;
+  map->visible_bits[idx >> 6] |= 1ull << (idx & 63);
+}
+
+// Resync the passable plane from the cell array after bulk cell writes
+// (called by map_mark_changed; the visible plane is left alone -- only
+// fov_compute writes it)
+void map_rebuild_bitplanes(Map *map);
+
 typedef enum {
   CHUNK_UNLOADED,  // Not loaded, not loading
   CHUNK_LOADING,   // Load request sent, waiting for callback
@@ -31,8 +69,46 @@ typedef struct {
   int curr_chunk_x;
   int curr_chunk_y;
   MapChunk chunks[MAP_CHUNK_TOTAL_X * MAP_CHUNK_TOTAL_Y];
+
+  // World-chunk indices waiting for deferred generation, drained at one
+  // chunk per frame by map_generate_pending (queued chunks sit in
+  // CHUNK_LOADING until their turn)
+  int pending_gen[MAP_CHUNK_WINDOW_X * MAP_CHUNK_WINDOW_Y];
+  int pending_gen_count;
+
+  // Player heading tracked by ensure_chunks_around_position for
+  // predictive window shifts: signed run length of consecutive steps in
+  // the same direction, per axis
+  int prev_player_x;
+  int prev_player_y;
+  int heading_run_x;
+  int heading_run_y;
 } WorldMap;
 
+// Chunk baselines are pure functions of (world seed, chunk coordinates)
+// but cost a full CSP solve to regenerate, so page-out delta computation
+// and stored-chunk page-in keep recent results in a small LRU instead of
+// re-solving on the game thread. Entries store the chunk-local cells and
+// water densely; purely derived state, never serialized
+#define BASELINE_CACHE_SLOTS 32
+
+typedef struct {
+  uint64_t key;   // chunk generation seed; slot empty while stamp == 0
+  uint32_t stamp; // LRU clock value at last use
+  MapCell cells[MAP_CHUNK_WIDTH * MAP_CHUNK_HEIGHT];
+  uint8_t water_depth[MAP_CHUNK_WIDTH * MAP_CHUNK_HEIGHT];
+} BaselineCacheEntry;
+
+typedef struct {
+  uint32_t counter; // LRU clock
+  BaselineCacheEntry entries[BASELINE_CACHE_SLOTS];
+} BaselineCache;
+
+// Call after any passability change: bumps the map change counter and
+// drops every cache derived from passability (portal graph, flow field,
+// cached goal paths validate against the counter lazily)
+void map_mark_changed(void);
+
 // Get a random passable position on the map
 // Returns false if no passable position found after max_attempts
 bool map_get_random_passable(Map *map, int region_x, int region_y,
@@ -44,4 +120,11 @@ void ensure_chunks_around_position(int player_x, int player_y);
 // Chunk serialization (called from game callbacks)
 void deserialize_chunk(int chunk_x, int chunk_y, const void *data,
                        size_t data_size);
-void generate_chunk(int chunk_x, int chunk_y);
+
+// Queue a chunk for deferred generation instead of generating it
+// synchronously (chunk_x, chunk_y are local window coordinates)
+void map_queue_generate_chunk(int chunk_x, int chunk_y);
+
+// Advance deferred chunk generation by one frame's iteration budget;
+// called once per frame so mapgen cost is bounded per frame, not per chunk
+void map_generate_pending(void);
@@ -182,13 +182,14 @@ static int score_terrain(Map *map, int x, int y, TerrainType terrain,
 }
 
 // Generate random terrain according to weighted distribution
-static TerrainType random_weighted_terrain(const int *weights, int count) {
+static TerrainType random_weighted_terrain(uint64_t *rng_state,
+                                           const int *weights, int count) {
   int total_weight = 0;
   for (int i = 0; i < count; i++) {
     total_weight += weights[i];
   }
 
-  int roll = random64() % total_weight;
+  int roll = random64_state(rng_state) % total_weight;
   int cumulative = 0;
 
   for (int i = 0; i < count; i++) {
@@ -201,14 +202,26 @@ static TerrainType random_weighted_terrain(const int *weights, int count) {
   return 0; // Fallback
 }
 
-// Generate terrain using Constraint Satisfaction with Local Minimum Conflicts
-// Works directly on the map's category field within the specified region
-void mapgen_csp_region(Map *map, int region_x, int region_y, int region_width,
-                       int region_height, const CSPGenParams *params) {
+// Begin a resumable CSP task: validates the region and performs the cheap
+// random initialization, leaving the expensive refinement for task_step
+void mapgen_csp_task_begin(CSPGenTask *task, Map *map, int region_x,
+                           int region_y, int region_width, int region_height,
+                           const CSPGenParams *params, uint64_t rng_state) {
+  *task = (CSPGenTask){
+      .map = map,
+      .region_x = region_x,
+      .region_y = region_y,
+      .region_width = region_width,
+      .region_height = region_height,
+      .params = *params,
+      .rng_state = rng_state,
+  };
+
   // Validate region bounds
   if (region_x < 0 || region_y < 0 || region_x + region_width > map->width ||
       region_y + region_height > map->height) {
-    return; // Invalid region
+    task->finished = true; // Invalid region, nothing to do
+    return;
   }
 
   // Initialize affinity rules (only once)
@@ -222,19 +235,36 @@ void mapgen_csp_region(Map *map, int region_x, int region_y, int region_width,
   for (int y = region_y; y < region_y + region_height; y++) {
     for (int x = region_x; x < region_x + region_width; x++) {
       int map_idx = y * MAP_WIDTH_MAX + x;
-      TerrainType terrain =
-          random_weighted_terrain(default_weights, TERRAIN_COUNT);
+      TerrainType terrain = random_weighted_terrain(
+          &task->rng_state, default_weights, TERRAIN_COUNT);
       map->cells[map_idx].category = terrain;
     }
   }
+}
+
+// Run up to max_iterations of refinement; finalizes tile/passable/water
+// once the iteration target is reached. Returns true when finished
+bool mapgen_csp_task_step(CSPGenTask *task, int max_iterations) {
+  if (task->finished) {
+    return true;
+  }
+
+  Map *map = task->map;
 
   // Step 2: Iterative refinement - maximize affinity score
   const int check_radius = 2; // How far to check for neighbor affinities
 
-  for (int iter = 0; iter < params->iterations; iter++) {
+  int end = task->iterations_done + max_iterations;
+  if (end > task->params.iterations) {
+    end = task->params.iterations;
+  }
+
+  for (; task->iterations_done < end; task->iterations_done++) {
     // Pick a random tile within the region
-    int x = region_x + (random64() % region_width);
-    int y = region_y + (random64() % region_height);
+    int x = task->region_x +
+            (random64_state(&task->rng_state) % task->region_width);
+    int y = task->region_y +
+            (random64_state(&task->rng_state) % task->region_height);
     int map_idx = y * MAP_WIDTH_MAX + x;
 
     TerrainType current = (TerrainType)map->cells[map_idx].category;
@@ -244,9 +274,10 @@ void mapgen_csp_region(Map *map, int region_x, int region_y, int region_width,
     int best_score = current_score;
 
     // Try several random terrain types
-    for (int attempt = 0; attempt < params->attempts_per_tile; attempt++) {
-      TerrainType candidate =
-          random_weighted_terrain(default_weights, TERRAIN_COUNT);
+    for (int attempt = 0; attempt < task->params.attempts_per_tile;
+         attempt++) {
+      TerrainType candidate = random_weighted_terrain(
+          &task->rng_state, default_weights, TERRAIN_COUNT);
 
       int candidate_score = score_terrain(map, x, y, candidate, check_radius);
 
@@ -261,20 +292,38 @@ void mapgen_csp_region(Map *map, int region_x, int region_y, int region_width,
     map->cells[map_idx].category = best;
   }
 
+  if (task->iterations_done < task->params.iterations) {
+    return false; // Budget exhausted, resume later
+  }
+
   // Step 3: Set tile and passable based on category
-  for (int y = region_y; y < region_y + region_height; y++) {
-    for (int x = region_x; x < region_x + region_width; x++) {
+  for (int y = task->region_y; y < task->region_y + task->region_height; y++) {
+    for (int x = task->region_x; x < task->region_x + task->region_width;
+         x++) {
       int map_idx = y * MAP_WIDTH_MAX + x;
       TerrainType terrain = (TerrainType)map->cells[map_idx].category;
 
       map->cells[map_idx].tile = terrain_tiles[terrain];
       map->cells[map_idx].passable = terrain_passable[terrain];
-      map->cells[map_idx].visible = true;
 
       // Set water depth (all subsea terrain is underwater)
       map->water_depth[map_idx] = 255; // Deep water
     }
   }
+
+  task->finished = true;
+  return true;
+}
+
+// Generate terrain using Constraint Satisfaction with Local Minimum Conflicts
+// Works directly on the map's category field within the specified region
+// (run-to-completion wrapper around the task API)
+void mapgen_csp_region(Map *map, int region_x, int region_y, int region_width,
+                       int region_height, const CSPGenParams *params) {
+  CSPGenTask task;
+  mapgen_csp_task_begin(&task, map, region_x, region_y, region_width,
+                        region_height, params, random64());
+  mapgen_csp_task_step(&task, params->iterations);
 }
 
 // Full-map CSP generation
@@ -32,4 +32,28 @@ void mapgen_csp(Map *map, const CSPGenParams *params);
 // Generate CSP terrain in a specific rectangular region of the map
 void mapgen_csp_region(Map *map, int region_x, int region_y,
                        int region_width, int region_height,
-                       const CSPGenParams *params);
\ No newline at end of file
+                       const CSPGenParams *params);
+
+// Resumable CSP generation: begin a task, then drive it with a per-call
+// iteration budget so one chunk's refinement can be sliced across frames.
+// The task carries its own RNG stream, so slicing does not change the
+// result: any budget schedule produces the same terrain for the same seed
+typedef struct {
+  Map *map;
+  int region_x;
+  int region_y;
+  int region_width;
+  int region_height;
+  CSPGenParams params;
+  uint64_t rng_state;
+  int iterations_done;
+  bool finished;
+} CSPGenTask;
+
+void mapgen_csp_task_begin(CSPGenTask *task, Map *map, int region_x,
+                           int region_y, int region_width, int region_height,
+                           const CSPGenParams *params, uint64_t rng_state);
+
+// Run up to max_iterations refinement iterations; returns true once the
+// task has finished (finalization included)
+bool mapgen_csp_task_step(CSPGenTask *task, int max_iterations);
\ No newline at end of file
@@ -1,15 +1,24 @@
 #include "common.h"
 #include "random.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
 #define PI 3.14159265f
 
-static float randf(float min, float max) {
-  return min + (max - min) * randomf();
+// Spawn variation draws from the particle stream's counter, never from
+// the gameplay RNG
+static float randf(ParticlesState *ps, float min, float max) {
+  return min + (max - min) * randomf_at(ps->rng_key, ps->rng_counter++);
 }
 
-static int randi(int min, int max) {
+static int randi(ParticlesState *ps, int min, int max) {
   // Random integer in [min, max] (inclusive)
-  return min + (int)(random64() % (uint64_t)(max - min + 1));
+  return min + (int)(random64_at(ps->rng_key, ps->rng_counter++) %
+                     (uint64_t)(max - min + 1));
 }
 
 // Get type-specific TTL (correlated with expected travel distance)
@@ -33,20 +42,20 @@ static float get_ttl(ParticleType type) {
 
 // Returns spawn interval in ticks (1 tick = 0.1 seconds)
 // Result fits in uint8_t (max 255 ticks = 25.5 seconds)
-int particles_gen_spawn_interval(ParticleType type) {
+int particles_gen_spawn_interval(ParticlesState *ps, ParticleType type) {
   switch (type) {
   case PARTICLE_TYPE_BLOOD:
     return 0; // Not a continuous generator (spawned on events)
   case PARTICLE_TYPE_FOG:
-    return randi(8, 12); // Sparse fog every ~1 second
+    return randi(ps, 8, 12); // Sparse fog every ~1 second
   case PARTICLE_TYPE_SNOW:
-    return randi(1, 3); // Frequent snowflakes
+    return randi(ps, 1, 3); // Frequent snowflakes
   case PARTICLE_TYPE_RAIN:
-    return randi(1, 2); // Very frequent raindrops (0.1-0.2s)
+    return randi(ps, 1, 2); // Very frequent raindrops (0.1-0.2s)
   case PARTICLE_TYPE_TORCH_SMOKE:
-    return randi(2, 4); // Smoke puffs every ~0.3 seconds
+    return randi(ps, 2, 4); // Smoke puffs every ~0.3 seconds
   case PARTICLE_TYPE_TORCH_SPARK:
-    return randi(5, 10); // Occasional sparks every ~0.75 seconds
+    return randi(ps, 5, 10); // Occasional sparks every ~0.75 seconds
   }
   return 10; // Default: once per second
 }
@@ -76,103 +85,158 @@ void particles_spawn_directed(ParticlesState *ps, ParticleType type, float x,
   case PARTICLE_TYPE_BLOOD: {
     // Blood sprays in cone around direction with random spread
     float angle = atan2f(dy, dx);
-    angle += randf(-PI / 6, PI / 6); // ±30 degree cone
-    float speed = randf(1.5f, 2.5f);
+    angle += randf(ps, -PI / 6, PI / 6); // ±30 degree cone
+    float speed = randf(ps, 1.5f, 2.5f);
     vx = cosf(angle) * speed;
     vy = sinf(angle) * speed;
     break;
   }
   case PARTICLE_TYPE_TORCH_SPARK: {
     // Sparks fly in random direction (ignores hint for now)
-    float angle = randf(0, 2.0f * PI);
-    float speed = randf(2.0f, 4.0f);
+    float angle = randf(ps, 0, 2.0f * PI);
+    float speed = randf(ps, 2.0f, 4.0f);
     vx = cosf(angle) * speed;
     vy = sinf(angle) * speed;
     break;
   }
   case PARTICLE_TYPE_FOG:
-    vx = randf(-0.2f, 0.2f);
-    vy = randf(-0.2f, 0.2f);
+    vx = randf(ps, -0.2f, 0.2f);
+    vy = randf(ps, -0.2f, 0.2f);
     break;
   case PARTICLE_TYPE_SNOW:
-    vx = randf(-0.3f, 0.3f);
-    vy = randf(0.5f, 1.0f);
+    vx = randf(ps, -0.3f, 0.3f);
+    vy = randf(ps, 0.5f, 1.0f);
     break;
   case PARTICLE_TYPE_RAIN:
-    vx = randf(-0.1f, 0.1f);
-    vy = randf(5.0f, 7.0f);
+    vx = randf(ps, -0.1f, 0.1f);
+    vy = randf(ps, 5.0f, 7.0f);
     break;
   case PARTICLE_TYPE_TORCH_SMOKE:
-    vx = randf(-0.3f, 0.3f);
-    vy = randf(-2.0f, -1.0f);
+    vx = randf(ps, -0.3f, 0.3f);
+    vy = randf(ps, -2.0f, -1.0f);
     break;
   }
 
-  ps->buffer[ps->count++] = (Particle){.type = type,
-                                       .x = x,
-                                       .y = y,
-                                       .vx = vx,
-                                       .vy = vy,
-                                       .ttl = ttl,
-                                       .lifetime = ttl};
+  uint32_t i = ps->count++;
+  ps->type[i] = (uint8_t)type;
+  ps->x[i] = x;
+  ps->y[i] = y;
+  ps->vx[i] = vx;
+  ps->vy[i] = vy;
+  ps->ttl[i] = ttl;
+  ps->lifetime[i] = ttl;
 }
 
 void particles_spawn(ParticlesState *ps, ParticleType type, float x, float y) {
   particles_spawn_directed(ps, type, x, y, 1.0f, 0.0f);
 }
 
-static void particles_unspawn(ParticlesState *ps, uint32_t i) {
-  if (i == ps->count - 1) {
-    --ps->count;
-  } else {
-    ps->buffer[i] = ps->buffer[--ps->count];
+// Integrate-and-age kernel: x += vx*dt, y += vy*dt, ttl -= dt as pure
+// float streams. Like the bitset kernels in world.h this has AVX2 / WASM
+// SIMD128 / scalar variants selected by build flags; the vector variants
+// may process a few slots past count, which is safe because the arrays
+// are MAX_PARTICLES long and dead tail slots are never read
+#if defined(__AVX2__)
+
+static void particles_integrate(ParticlesState *ps, float dt) {
+  __m256 vdt = _mm256_set1_ps(dt);
+  for (uint32_t i = 0; i < ps->count; i += 8) {
+    __m256 x = _mm256_loadu_ps(ps->x + i);
+    __m256 y = _mm256_loadu_ps(ps->y + i);
+    __m256 ttl = _mm256_loadu_ps(ps->ttl + i);
+    x = _mm256_add_ps(x, _mm256_mul_ps(_mm256_loadu_ps(ps->vx + i), vdt));
+    y = _mm256_add_ps(y, _mm256_mul_ps(_mm256_loadu_ps(ps->vy + i), vdt));
+    ttl = _mm256_sub_ps(ttl, vdt);
+    _mm256_storeu_ps(ps->x + i, x);
+    _mm256_storeu_ps(ps->y + i, y);
+    _mm256_storeu_ps(ps->ttl + i, ttl);
+  }
+}
+
+#elif defined(__wasm_simd128__)
+
+static void particles_integrate(ParticlesState *ps, float dt) {
+  v128_t vdt = wasm_f32x4_splat(dt);
+  for (uint32_t i = 0; i < ps->count; i += 4) {
+    v128_t x = wasm_v128_load(ps->x + i);
+    v128_t y = wasm_v128_load(ps->y + i);
+    v128_t ttl = wasm_v128_load(ps->ttl + i);
+    x = wasm_f32x4_add(x, wasm_f32x4_mul(wasm_v128_load(ps->vx + i), vdt));
+    y = wasm_f32x4_add(y, wasm_f32x4_mul(wasm_v128_load(ps->vy + i), vdt));
+    ttl = wasm_f32x4_sub(ttl, vdt);
+    wasm_v128_store(ps->x + i, x);
+    wasm_v128_store(ps->y + i, y);
+    wasm_v128_store(ps->ttl + i, ttl);
+  }
+}
+
+#else
+
+static void particles_integrate(ParticlesState *ps, float dt) {
+  for (uint32_t i = 0; i < ps->count; ++i) {
+    ps->x[i] += ps->vx[i] * dt;
+    ps->y[i] += ps->vy[i] * dt;
+    ps->ttl[i] -= dt;
   }
 }
 
+#endif
+
 void particles_update(ParticlesState *ps, float dt) {
   ps->time += dt;
 
+  // Phase 1: type-specific velocity behavior (scalar; the per-type wobble
+  // needs sinf and a switch, and is much lighter than integration)
   for (uint32_t i = 0; i < ps->count; ++i) {
-    Particle *p = ps->buffer + i;
-    p->ttl -= dt;
-    if (p->ttl <= 0) {
-      particles_unspawn(ps, i);
-      --i; // Recheck this index (now holds swapped particle)
-      continue;
-    }
-
-    // Update velocity based on particle type (no acceleration for most)
-    switch (p->type) {
+    switch (ps->type[i]) {
     case PARTICLE_TYPE_BLOOD:
       // Blood decelerates and falls (parabolic arc)
-      p->vx *= 0.92f;
-      p->vy += 8.0f * dt; // gravity
+      ps->vx[i] *= 0.92f;
+      ps->vy[i] += 8.0f * dt; // gravity
       break;
     case PARTICLE_TYPE_TORCH_SPARK:
       // Sparks decelerate and fall (parabolic arc)
-      p->vx *= 0.95f;
-      p->vy += 15.0f * dt; // strong gravity
+      ps->vx[i] *= 0.95f;
+      ps->vy[i] += 15.0f * dt; // strong gravity
       break;
     case PARTICLE_TYPE_FOG:
       // Fog drifts with sinusoidal wobble
-      p->vx = 0.3f * sinf(ps->time * 1.5f + (float)i * 0.3f);
+      ps->vx[i] = 0.3f * sinf(ps->time * 1.5f + (float)i * 0.3f);
       break;
     case PARTICLE_TYPE_SNOW:
       // Snow wobbles side to side while falling (sine wave)
-      p->vx = 0.5f * sinf(ps->time * 2.0f + (float)i * 0.5f);
+      ps->vx[i] = 0.5f * sinf(ps->time * 2.0f + (float)i * 0.5f);
       break;
     case PARTICLE_TYPE_TORCH_SMOKE:
       // Smoke wobbles as it rises
-      p->vx = 0.4f * sinf(ps->time * 2.5f + (float)i * 0.2f);
-      p->vy *= 0.98f; // slight deceleration
+      ps->vx[i] = 0.4f * sinf(ps->time * 2.5f + (float)i * 0.2f);
+      ps->vy[i] *= 0.98f; // slight deceleration
       break;
     case PARTICLE_TYPE_RAIN:
       // Rain maintains constant velocity (already at terminal)
       break;
     }
+  }
 
-    // Update position
-    p->x += p->vx * dt;
-    p->y += p->vy * dt;
+  // Phase 2: vectorized integrate-and-age
+  particles_integrate(ps, dt);
+
+  // Phase 3: stable compaction of expired particles
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < ps->count; ++i) {
+    if (ps->ttl[i] <= 0.0f) {
+      continue;
+    }
+    if (n != i) {
+      ps->x[n] = ps->x[i];
+      ps->y[n] = ps->y[i];
+      ps->vx[n] = ps->vx[i];
+      ps->vy[n] = ps->vy[i];
+      ps->ttl[n] = ps->ttl[i];
+      ps->lifetime[n] = ps->lifetime[i];
+      ps->type[n] = ps->type[i];
+    }
+    n++;
   }
+  ps->count = n;
 }
\ No newline at end of file
@@ -2,7 +2,7 @@
 
 #include <stdint.h>
 
-#define MAX_PARTICLES 1024
+#define MAX_PARTICLES (16 * 1024)
 
 typedef enum {
   PARTICLE_TYPE_BLOOD,
@@ -13,18 +13,26 @@ typedef enum {
   PARTICLE_TYPE_TORCH_SPARK,
 } ParticleType;
 
-typedef struct {
-  ParticleType type;
-  float x, y;
-  float vx, vy;
-  float ttl;      // time remaining
-  float lifetime; // initial lifetime (for age-based effects in rendering)
-} Particle;
-
 typedef struct {
   float time;
   uint32_t count;
-  Particle buffer[MAX_PARTICLES];
+
+  // Counter-based RNG stream for spawn variation, so purely cosmetic
+  // particle rolls never advance (or depend on) the gameplay stream
+  uint64_t rng_key;
+  uint64_t rng_counter;
+
+  // Structure-of-arrays layout: the per-frame integrate-and-age pass
+  // walks x/y/vx/vy/ttl as straight float streams, which the SIMD
+  // kernels (and the autovectorizer) handle several particles at a time.
+  // type and lifetime are only touched at spawn and render time
+  float x[MAX_PARTICLES];
+  float y[MAX_PARTICLES];
+  float vx[MAX_PARTICLES];
+  float vy[MAX_PARTICLES];
+  float ttl[MAX_PARTICLES];      // time remaining
+  float lifetime[MAX_PARTICLES]; // initial ttl (for age-based fade)
+  uint8_t type[MAX_PARTICLES];
 } ParticlesState;
 
 // Spawn particle with type-specific default behavior
@@ -37,4 +45,4 @@ void particles_spawn_directed(ParticlesState *ps, ParticleType type, float x,
 
 void particles_update(ParticlesState *ps, float dt);
 
-int particles_gen_spawn_interval(ParticleType type);
\ No newline at end of file
+int particles_gen_spawn_interval(ParticlesState *ps, ParticleType type);
\ No newline at end of file
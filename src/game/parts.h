@@ -31,6 +31,15 @@ typedef struct {
   int8_t con : 4;
 } AttributesModifier;
 
+// Cached result of attributes_effective: base Attributes plus the
+// modifiers of the entity's subtree. Valid while epoch matches
+// WORLD.attributes_epoch, which moves on any attribute, modifier,
+// hierarchy or equipment change
+typedef struct {
+  Attributes attr;
+  uint32_t epoch;
+} EffectiveAttributes;
+
 enum {
   MATERIAL_WOOD,
   MATERIAL_LEATHER,
@@ -118,9 +127,11 @@ typedef struct {
   PART(Material, uint8_t)                                                      \
   PART(Attributes, Attributes)                                                 \
   PART(AttributesModifier, AttributesModifier)                                 \
+  PART(EffectiveAttributes, EffectiveAttributes)                               \
   PART(Health, uint8_t)                                                        \
   PART(BodyPart, BodyPart)                                                     \
-  PART(ParticleEmitter, ParticleEmitter)
+  PART(ParticleEmitter, ParticleEmitter)                                       \
+  PART(LightSource, uint8_t) /* light radius in tiles (see lighting.h) */
 
 #define FOREACH_MARK(MARK)                                                     \
   MARK(IsEquipped)                                                             \
@@ -131,9 +142,14 @@ typedef struct {
 // PartState struct
 // ============================================================================
 
+// Every part gets a companion DirtyBitset tracking which entities had the
+// part added, removed or mutated (via PART_MUT) since the last
+// parts_clear_dirty(). Incremental systems iterate these instead of
+// rescanning the world
 #define DO_DECLARE_BITSET(name) uint64_t name##Bitset[ENTITY_BITSET_WORDS];
 #define DO_DECLARE_PART(name, type)                                            \
   DO_DECLARE_BITSET(name)                                                      \
+  uint64_t name##DirtyBitset[ENTITY_BITSET_WORDS];                             \
   type name[MAX_ENTITIES];
 
 typedef struct {
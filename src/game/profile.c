@@ -0,0 +1,81 @@
+#include "profile.h"
+#include "utils/print.h"
+#include "world.h"
+
+void profile_record(ProfilePhase phase, double start_us, double end_us) {
+  ProfileState *prof = &WORLD.profile;
+  float dur_us = (float)(end_us - start_us);
+
+  prof->samples_us[phase][prof->sample_count[phase] % PROFILE_SAMPLES] =
+      dur_us;
+  prof->sample_count[phase]++;
+
+  prof->trace[prof->trace_count % PROFILE_TRACE_EVENTS] = (ProfileEvent){
+      .start_us = start_us,
+      .dur_us = dur_us,
+      .phase = (uint8_t)phase,
+  };
+  prof->trace_count++;
+}
+
+float profile_phase_p95(ProfilePhase phase) {
+  ProfileState *prof = &WORLD.profile;
+  uint32_t n = prof->sample_count[phase];
+  if (n > PROFILE_SAMPLES) {
+    n = PROFILE_SAMPLES;
+  }
+  if (n == 0) {
+    return 0.0f;
+  }
+
+  // Insertion sort a copy; the window is small enough that this is cheap
+  float sorted[PROFILE_SAMPLES];
+  for (uint32_t i = 0; i < n; i++) {
+    float v = prof->samples_us[phase][i];
+    uint32_t j = i;
+    while (j > 0 && sorted[j - 1] > v) {
+      sorted[j] = sorted[j - 1];
+      j--;
+    }
+    sorted[j] = v;
+  }
+
+  return sorted[(n * 95) / 100];
+}
+
+const char *profile_phase_name(ProfilePhase phase) {
+  switch (phase) {
+#define DO_PHASE_NAME(name)                                                    \
+  case PROFILE_PHASE_##name:                                                   \
+    return #name;
+    FOREACH_PROFILE_PHASE(DO_PHASE_NAME)
+#undef DO_PHASE_NAME
+  default:
+    return "?";
+  }
+}
+
+void profile_dump_trace(void) {
+  ProfileState *prof = &WORLD.profile;
+  uint32_t count = prof->trace_count;
+  uint32_t first = 0;
+  if (count > PROFILE_TRACE_EVENTS) {
+    first = count - PROFILE_TRACE_EVENTS;
+  }
+
+  // One JSON object per line so the output survives interleaved logging;
+  // concatenating the lines between the brackets yields a valid trace
+  host_log(LOG_INFO, "[");
+  for (uint32_t i = first; i < count; i++) {
+    ProfileEvent *ev = &prof->trace[i % PROFILE_TRACE_EVENTS];
+    PRINT(line, 128, "{\"name\":\"");
+    print_str(&line, profile_phase_name((ProfilePhase)ev->phase));
+    print_str(&line, "\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":");
+    print_uint(&line, (uint64_t)ev->start_us);
+    print_str(&line, ",\"dur\":");
+    print_uint(&line, (uint64_t)ev->dur_us);
+    print_str(&line, i + 1 < count ? "}," : "}");
+    host_log(LOG_INFO, line.data);
+  }
+  host_log(LOG_INFO, "]");
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "common.h"
+
+// ============================================================================
+// Per-phase frame profiler
+//
+// Wrap the major frame phases in PROFILE_SCOPE(...) blocks; each scope
+// records its duration into a small per-phase sample ring (for the p95
+// overlay in game.c) and into a trace ring that can be dumped through the
+// host log in chrome://tracing JSON format (open chrome://tracing or
+// https://ui.perfetto.dev and load the saved output).
+//
+// Timing comes from host_time_us and is used for measurement only; game
+// logic must stay deterministic and keep using dt/ticks.
+// ============================================================================
+
+#define FOREACH_PROFILE_PHASE(X)                                               \
+  X(MAPGEN)                                                                    \
+  X(TICKS)                                                                     \
+  X(PARTICLES)                                                                 \
+  X(TURNS)                                                                     \
+  X(GEOMETRY)
+
+typedef enum {
+#define DO_DECLARE_PHASE(name) PROFILE_PHASE_##name,
+  FOREACH_PROFILE_PHASE(DO_DECLARE_PHASE)
+#undef DO_DECLARE_PHASE
+      PROFILE_PHASE_MAX,
+} ProfilePhase;
+
+#define PROFILE_SAMPLES 64       // recent samples per phase (p95 window)
+#define PROFILE_TRACE_EVENTS 1024 // recent scope events kept for trace dump
+
+typedef struct {
+  double start_us;
+  float dur_us;
+  uint8_t phase;
+} ProfileEvent;
+
+typedef struct {
+  float samples_us[PROFILE_PHASE_MAX][PROFILE_SAMPLES];
+  uint32_t sample_count[PROFILE_PHASE_MAX]; // total recorded (ring index)
+
+  // Ring of the most recent scope events, dumped on request
+  ProfileEvent trace[PROFILE_TRACE_EVENTS];
+  uint32_t trace_count;
+} ProfileState;
+
+// Record one completed scope (called by PROFILE_SCOPE)
+void profile_record(ProfilePhase phase, double start_us, double end_us);
+
+// 95th percentile of the phase's recent samples, in microseconds
+float profile_phase_p95(ProfilePhase phase);
+
+const char *profile_phase_name(ProfilePhase phase);
+
+// Dump the trace ring through host_log as a chrome://tracing JSON array
+void profile_dump_trace(void);
+
+// Scoped timer around a block: PROFILE_SCOPE(TURNS) { ... }
+#define PROFILE_SCOPE(phase)                                                   \
+  for (double _t0 = host_time_us(), _done = 0.0; _done == 0.0;                 \
+       profile_record(PROFILE_PHASE_##phase, _t0, host_time_us()),             \
+              _done = 1.0)
@@ -26,15 +26,42 @@ IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE. */
    It is a very fast generator passing BigCrush, and it can be useful if
    for some reason you absolutely want 64 bits of state. */
 
-// Generate a random 64-bit number based on WORLD.rng_state
-static inline uint64_t random64(void) { // aka splitmix64
-  uint64_t z = (WORLD.rng_state += 0x9e3779b97f4a7c15);
+// Advance an explicit state, for streams that must stay reproducible no
+// matter how much the global RNG has been consumed (chunk generation)
+static inline uint64_t random64_state(uint64_t *state) { // aka splitmix64
+  uint64_t z = (*state += 0x9e3779b97f4a7c15);
   z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
   z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
   return z ^ (z >> 31);
 }
 
+// Generate a random 64-bit number based on WORLD.rng_state
+static inline uint64_t random64(void) {
+  return random64_state(&WORLD.rng_state);
+}
+
 // Generate a random floating point number based on WORLD.rng_state
 static inline float randomf(void) {
   return (float)random64() / (float)UINT64_MAX;
 }
+
+// Counter-based (stateless) access: the index'th draw of the stream seeded
+// with key, computed directly. Consumers keyed on stable identifiers (world
+// seed + chunk coordinates, emitter ids, ...) get reproducible sequences
+// that do not depend on global RNG consumption or on evaluation order,
+// which is what the chunk pipeline and delta persistence rely on
+static inline uint64_t random64_at(uint64_t key, uint64_t index) {
+  uint64_t state = key + index * 0x9e3779b97f4a7c15;
+  return random64_state(&state);
+}
+
+static inline float randomf_at(uint64_t key, uint64_t index) {
+  return (float)random64_at(key, index) / (float)UINT64_MAX;
+}
+
+// Derive a decorrelated stream key from a seed and an identifier (chunk
+// key, entity index, subsystem tag, ...)
+static inline uint64_t random_key(uint64_t seed, uint64_t id) {
+  uint64_t state = seed ^ (id * 0x9e3779b97f4a7c15);
+  return random64_state(&state);
+}
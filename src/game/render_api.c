@@ -1,9 +1,24 @@
 #include "render_api.h"
 
+#include <string.h>
+
 // Tile atlas constants
 #define TILE_SIZE 12
 #define TILE_PADDING 1
 
+// Texture coordinates of the white tile's center pixel (sampling the
+// center avoids edge artifacts); used for all untextured colored quads
+static void white_tile_uv(RenderContext *ctx, float *u, float *v) {
+  int atlas_cols =
+      (ctx->atlas_width_px - TILE_PADDING) / (TILE_SIZE + TILE_PADDING);
+  int tile_x = WHITE_TILE_INDEX % atlas_cols;
+  int tile_y = WHITE_TILE_INDEX / atlas_cols;
+  int atlas_x = TILE_PADDING + tile_x * (TILE_SIZE + TILE_PADDING);
+  int atlas_y = TILE_PADDING + tile_y * (TILE_SIZE + TILE_PADDING);
+  *u = (atlas_x + TILE_SIZE / 2.0f) / ctx->atlas_width_px;
+  *v = (atlas_y + TILE_SIZE / 2.0f) / ctx->atlas_height_px;
+}
+
 void geobuilder_init(GeometryBuilder *geom, RenderContext *ctx) {
   geom->count = 0;
   geom->ctx = ctx;
@@ -25,11 +40,8 @@ static void geobuilder_flush_if_full(GeometryBuilder *geom,
   }
 }
 
-static void geobuilder_vert(GeometryBuilder *geom, float x, float y,
-                            Color color, float u, float v) {
-  geobuilder_flush_if_full(geom, 1);
-
-  Vertex *vert = &geom->vertices[geom->count++];
+static void vertex_set(Vertex *vert, float x, float y, Color color, float u,
+                       float v) {
   vert->position[0] = x;
   vert->position[1] = y;
   vert->color[0] = color.r / 255.0f;
@@ -40,25 +52,30 @@ static void geobuilder_vert(GeometryBuilder *geom, float x, float y,
   vert->tex_coord[1] = v;
 }
 
-// Helper: push a quad (2 triangles = 6 vertices)
+// Helper: write a quad's 4 vertices (TL, TR, BL, BR) into a buffer; the
+// hosts expand each quad to 2 triangles with the shared index pattern
+// {0,1,2, 2,1,3}
+static int emit_quad(Vertex *out, float x0, float y0, float x1, float y1,
+                     Color color, float u0, float v0, float u1, float v1) {
+  vertex_set(&out[0], x0, y0, color, u0, v0); // top-left
+  vertex_set(&out[1], x1, y0, color, u1, v0); // top-right
+  vertex_set(&out[2], x0, y1, color, u0, v1); // bottom-left
+  vertex_set(&out[3], x1, y1, color, u1, v1); // bottom-right
+  return 4;
+}
+
+// Helper: push a quad (4 vertices)
 static void geobuilder_quad(GeometryBuilder *geom, float x0, float y0, float x1,
                             float y1, Color color, float u0, float v0, float u1,
                             float v1) {
-  geobuilder_flush_if_full(geom, 6);
-
-  // Triangle 1: top-left, top-right, bottom-left
-  geobuilder_vert(geom, x0, y0, color, u0, v0);
-  geobuilder_vert(geom, x1, y0, color, u1, v0);
-  geobuilder_vert(geom, x0, y1, color, u0, v1);
-
-  // Triangle 2: bottom-left, top-right, bottom-right
-  geobuilder_vert(geom, x0, y1, color, u0, v1);
-  geobuilder_vert(geom, x1, y0, color, u1, v0);
-  geobuilder_vert(geom, x1, y1, color, u1, v1);
+  geobuilder_flush_if_full(geom, 4);
+  geom->count +=
+      emit_quad(&geom->vertices[geom->count], x0, y0, x1, y1, color, u0, v0,
+                u1, v1);
 }
 
-void geobuilder_tile(GeometryBuilder *geom, int tile_index, int x, int y) {
-  RenderContext *ctx = geom->ctx;
+int geometry_emit_tile(RenderContext *ctx, Vertex *out, int tile_index, int x,
+                       int y) {
   int tile_size = ctx->tile_size;
 
   // Calculate tile position in atlas (with padding)
@@ -84,24 +101,41 @@ void geobuilder_tile(GeometryBuilder *geom, int tile_index, int x, int y) {
   // White color for textured quads (texture colors pass through)
   Color white = {255, 255, 255, 255};
 
-  geobuilder_quad(geom, x0, y0, x1, y1, white, u0, v0, u1, v1);
+  return emit_quad(out, x0, y0, x1, y1, white, u0, v0, u1, v1);
 }
 
-void geobuilder_rect(GeometryBuilder *geom, int x, int y, int w, int h,
-                     Color color) {
-  RenderContext *ctx = geom->ctx;
+void geobuilder_tile(GeometryBuilder *geom, int tile_index, int x, int y) {
+  geobuilder_flush_if_full(geom, 4);
+  geom->count += geometry_emit_tile(geom->ctx, &geom->vertices[geom->count],
+                                    tile_index, x, y);
+}
 
-  // Calculate white tile position in atlas
-  int atlas_cols =
-      (ctx->atlas_width_px - TILE_PADDING) / (TILE_SIZE + TILE_PADDING);
-  int tile_x = WHITE_TILE_INDEX % atlas_cols;
-  int tile_y = WHITE_TILE_INDEX / atlas_cols;
-  int atlas_x = TILE_PADDING + tile_x * (TILE_SIZE + TILE_PADDING);
-  int atlas_y = TILE_PADDING + tile_y * (TILE_SIZE + TILE_PADDING);
+void geobuilder_vertices(GeometryBuilder *geom, const Vertex *verts, int count,
+                         float dx, float dy) {
+  int i = 0;
+  while (i < count) {
+    int space = MAX_VERTICES - geom->count;
+    int n = count - i < space ? count - i : space;
+    n -= n % 4; // never split a quad across submissions
+    if (n == 0) {
+      geobuilder_flush(geom);
+      continue;
+    }
+    for (int k = 0; k < n; k++) {
+      Vertex *vert = &geom->vertices[geom->count + k];
+      *vert = verts[i + k];
+      vert->position[0] += dx;
+      vert->position[1] += dy;
+    }
+    geom->count += n;
+    i += n;
+  }
+}
 
-  // Sample center pixel of white tile to avoid edge artifacts
-  float u = (atlas_x + TILE_SIZE / 2.0f) / ctx->atlas_width_px;
-  float v = (atlas_y + TILE_SIZE / 2.0f) / ctx->atlas_height_px;
+void geobuilder_rect(GeometryBuilder *geom, int x, int y, int w, int h,
+                     Color color) {
+  float u, v;
+  white_tile_uv(geom->ctx, &u, &v);
 
   // Screen coordinates
   float x0 = (float)x;
@@ -114,19 +148,8 @@ void geobuilder_rect(GeometryBuilder *geom, int x, int y, int w, int h,
 
 void geobuilder_rect_colored(GeometryBuilder *geom, int x, int y, int w, int h,
                              Color tl, Color tr, Color bl, Color br) {
-  RenderContext *ctx = geom->ctx;
-
-  // Calculate white tile position in atlas
-  int atlas_cols =
-      (ctx->atlas_width_px - TILE_PADDING) / (TILE_SIZE + TILE_PADDING);
-  int tile_x = WHITE_TILE_INDEX % atlas_cols;
-  int tile_y = WHITE_TILE_INDEX / atlas_cols;
-  int atlas_x = TILE_PADDING + tile_x * (TILE_SIZE + TILE_PADDING);
-  int atlas_y = TILE_PADDING + tile_y * (TILE_SIZE + TILE_PADDING);
-
-  // Sample center pixel of white tile to avoid edge artifacts
-  float u = (atlas_x + TILE_SIZE / 2.0f) / ctx->atlas_width_px;
-  float v = (atlas_y + TILE_SIZE / 2.0f) / ctx->atlas_height_px;
+  float u, v;
+  white_tile_uv(geom->ctx, &u, &v);
 
   // Screen coordinates
   float x0 = (float)x;
@@ -142,27 +165,68 @@ void geobuilder_rect_colored(GeometryBuilder *geom, int x, int y, int w, int h,
                   (uint8_t)((tl.b + tr.b + bl.b + br.b) / 4),
                   (uint8_t)((tl.a + tr.a + bl.a + br.a) / 4)};
 
-  geobuilder_flush_if_full(geom, 12); // 4 triangles = 12 vertices
+  geobuilder_flush_if_full(geom, 16); // 4 fan triangles as degenerate quads
+
+  // Each fan triangle is emitted as a quad with its last vertex repeated:
+  // the quad index pattern {0,1,2, 2,1,3} then yields the real triangle
+  // plus a zero-area one, keeping everything on the shared index buffer
+  Vertex *out = &geom->vertices[geom->count];
 
   // Triangle 1: top (center, top-left, top-right)
-  geobuilder_vert(geom, xc, yc, center, u, v);
-  geobuilder_vert(geom, x0, y0, tl, u, v);
-  geobuilder_vert(geom, x1, y0, tr, u, v);
+  vertex_set(&out[0], xc, yc, center, u, v);
+  vertex_set(&out[1], x0, y0, tl, u, v);
+  vertex_set(&out[2], x1, y0, tr, u, v);
+  vertex_set(&out[3], x1, y0, tr, u, v);
 
   // Triangle 2: right (center, top-right, bottom-right)
-  geobuilder_vert(geom, xc, yc, center, u, v);
-  geobuilder_vert(geom, x1, y0, tr, u, v);
-  geobuilder_vert(geom, x1, y1, br, u, v);
+  vertex_set(&out[4], xc, yc, center, u, v);
+  vertex_set(&out[5], x1, y0, tr, u, v);
+  vertex_set(&out[6], x1, y1, br, u, v);
+  vertex_set(&out[7], x1, y1, br, u, v);
 
   // Triangle 3: bottom (center, bottom-right, bottom-left)
-  geobuilder_vert(geom, xc, yc, center, u, v);
-  geobuilder_vert(geom, x1, y1, br, u, v);
-  geobuilder_vert(geom, x0, y1, bl, u, v);
+  vertex_set(&out[8], xc, yc, center, u, v);
+  vertex_set(&out[9], x1, y1, br, u, v);
+  vertex_set(&out[10], x0, y1, bl, u, v);
+  vertex_set(&out[11], x0, y1, bl, u, v);
 
   // Triangle 4: left (center, bottom-left, top-left)
-  geobuilder_vert(geom, xc, yc, center, u, v);
-  geobuilder_vert(geom, x0, y1, bl, u, v);
-  geobuilder_vert(geom, x0, y0, tl, u, v);
+  vertex_set(&out[12], xc, yc, center, u, v);
+  vertex_set(&out[13], x0, y1, bl, u, v);
+  vertex_set(&out[14], x0, y0, tl, u, v);
+  vertex_set(&out[15], x0, y0, tl, u, v);
+
+  geom->count += 16;
+}
+
+// Emit one font glyph quad's vertices; returns vertices written
+static int emit_char_quad(RenderContext *ctx, Vertex *out, unsigned char ch,
+                          int x, int y, int char_size) {
+  // Calculate tile position in atlas (with padding)
+  int atlas_cols =
+      (ctx->atlas_width_px - TILE_PADDING) / (TILE_SIZE + TILE_PADDING);
+  int tile_index = FONT_BASE_INDEX + ch;
+  int tile_x = tile_index % atlas_cols;
+  int tile_y = tile_index / atlas_cols;
+  int atlas_x = TILE_PADDING + tile_x * (TILE_SIZE + TILE_PADDING);
+  int atlas_y = TILE_PADDING + tile_y * (TILE_SIZE + TILE_PADDING);
+
+  // Calculate texture coordinates (0-1 range)
+  float u0 = (float)atlas_x / ctx->atlas_width_px;
+  float v0 = (float)atlas_y / ctx->atlas_height_px;
+  float u1 = (float)(atlas_x + TILE_SIZE) / ctx->atlas_width_px;
+  float v1 = (float)(atlas_y + TILE_SIZE) / ctx->atlas_height_px;
+
+  // Screen coordinates with custom size
+  float x0 = (float)x;
+  float y0 = (float)y;
+  float x1 = (float)(x + char_size);
+  float y1 = (float)(y + char_size);
+
+  // White color for textured quads (texture colors pass through)
+  Color white = {255, 255, 255, 255};
+
+  return emit_quad(out, x0, y0, x1, y1, white, u0, v0, u1, v1);
 }
 
 void geobuilder_text(GeometryBuilder *geom, int x, int y, float scale,
@@ -187,34 +251,91 @@ void geobuilder_text(GeometryBuilder *geom, int x, int y, float scale,
   // Draw text
   int char_x = draw_x;
   for (const char *p = text; *p; p++) {
-    unsigned char ch = (unsigned char)*p;
-
-    // Calculate tile position in atlas (with padding)
-    int atlas_cols =
-        (ctx->atlas_width_px - TILE_PADDING) / (TILE_SIZE + TILE_PADDING);
-    int tile_index = FONT_BASE_INDEX + ch;
-    int tile_x = tile_index % atlas_cols;
-    int tile_y = tile_index / atlas_cols;
-    int atlas_x = TILE_PADDING + tile_x * (TILE_SIZE + TILE_PADDING);
-    int atlas_y = TILE_PADDING + tile_y * (TILE_SIZE + TILE_PADDING);
-
-    // Calculate texture coordinates (0-1 range)
-    float u0 = (float)atlas_x / ctx->atlas_width_px;
-    float v0 = (float)atlas_y / ctx->atlas_height_px;
-    float u1 = (float)(atlas_x + TILE_SIZE) / ctx->atlas_width_px;
-    float v1 = (float)(atlas_y + TILE_SIZE) / ctx->atlas_height_px;
-
-    // Screen coordinates with custom size
-    float x0 = (float)char_x;
-    float y0 = (float)y;
-    float x1 = (float)(char_x + char_size);
-    float y1 = (float)(y + char_size);
-
-    // White color for textured quads (texture colors pass through)
-    Color white = {255, 255, 255, 255};
-
-    geobuilder_quad(geom, x0, y0, x1, y1, white, u0, v0, u1, v1);
+    geobuilder_flush_if_full(geom, 4);
+    geom->count += emit_char_quad(ctx, &geom->vertices[geom->count],
+                                  (unsigned char)*p, char_x, y, char_size);
+    char_x += char_size;
+  }
+}
 
+// Cached text runs: shaping a string re-walks per-glyph atlas math every
+// frame, which is wasteful for HUD strings that change at most once per
+// second or per turn. Runs are shaped once at the origin and replayed
+// shifted into place; a small direct-mapped cache keyed by a hash of
+// string + style holds them. Lives in plain statics like the geometry
+// builder: losing it on hot-reload just costs a reshape
+#define TEXT_RUN_MAX_GLYPHS 127
+#define TEXT_RUN_MAX_VERTICES ((TEXT_RUN_MAX_GLYPHS + 1) * 4) // +1 bg quad
+#define TEXT_CACHE_SLOTS 32
+
+typedef struct {
+  uint64_t key; // 0 = empty slot
+  int count;
+  int text_width; // pixels; alignment is applied at replay time
+  Vertex vertices[TEXT_RUN_MAX_VERTICES];
+} TextRun;
+
+static TextRun text_cache[TEXT_CACHE_SLOTS];
+
+// FNV-1a over the string plus everything else that affects the shaped
+// vertices (glyph size and background color)
+static uint64_t text_run_key(int char_size, Color bg_color, const char *text) {
+  uint64_t h = 1469598103934665603ull;
+  for (const char *p = text; *p; p++) {
+    h = (h ^ (uint8_t)*p) * 1099511628211ull;
+  }
+  h = (h ^ (uint64_t)(uint32_t)char_size) * 1099511628211ull;
+  h = (h ^ bg_color.r) * 1099511628211ull;
+  h = (h ^ bg_color.g) * 1099511628211ull;
+  h = (h ^ bg_color.b) * 1099511628211ull;
+  h = (h ^ bg_color.a) * 1099511628211ull;
+  return h ? h : 1; // key 0 means "empty slot"
+}
+
+static void text_run_shape(RenderContext *ctx, TextRun *run, int char_size,
+                           Color bg_color, const char *text) {
+  int text_width = 0;
+  for (const char *p = text; *p; p++) {
+    text_width += char_size;
+  }
+
+  run->count = 0;
+  run->text_width = text_width;
+
+  if (bg_color.a > 0) {
+    float u, v;
+    white_tile_uv(ctx, &u, &v);
+    run->count += emit_quad(&run->vertices[0], 0.0f, 0.0f, (float)text_width,
+                            (float)char_size, bg_color, u, v, u, v);
+  }
+
+  int char_x = 0;
+  for (const char *p = text; *p; p++) {
+    run->count += emit_char_quad(ctx, &run->vertices[run->count],
+                                 (unsigned char)*p, char_x, 0, char_size);
     char_x += char_size;
   }
 }
+
+void geobuilder_text_cached(GeometryBuilder *geom, int x, int y, float scale,
+                            TextAlign align, Color bg_color, const char *text) {
+  RenderContext *ctx = geom->ctx;
+  int char_size = (int)(ctx->tile_size * scale);
+
+  // Strings too long for a run slot take the uncached path
+  if (strlen(text) > TEXT_RUN_MAX_GLYPHS) {
+    geobuilder_text(geom, x, y, scale, align, bg_color, text);
+    return;
+  }
+
+  uint64_t key = text_run_key(char_size, bg_color, text);
+  TextRun *run = &text_cache[key % TEXT_CACHE_SLOTS];
+  if (run->key != key) {
+    text_run_shape(ctx, run, char_size, bg_color, text);
+    run->key = key;
+  }
+
+  int draw_x = (align == TEXT_ALIGN_RIGHT) ? (x - run->text_width) : x;
+  geobuilder_vertices(geom, run->vertices, run->count, (float)draw_x,
+                      (float)y);
+}
@@ -40,7 +40,15 @@ typedef struct {
 // Geometry builder - builds vertex buffers for rendering
 // ============================================================================
 
-#define MAX_VERTICES 4096
+// All geometry is submitted as quads: 4 vertices each (top-left, top-right,
+// bottom-left, bottom-right), and both hosts draw them indexed with a shared
+// static index buffer using the per-quad pattern {0,1,2, 2,1,3}. That cuts
+// vertex bandwidth by a third versus the old 6-vertices-per-quad layout.
+// The capacity is overridable (-DMAX_VERTICES=...) and must stay a multiple
+// of 4 so flushes never split a quad
+#ifndef MAX_VERTICES
+#define MAX_VERTICES (16 * 1024)
+#endif
 
 typedef struct {
   Vertex vertices[MAX_VERTICES];
@@ -57,18 +65,28 @@ void geobuilder_clear(GeometryBuilder *geom);
 // Flush accumulated vertices to the host
 void geobuilder_flush(GeometryBuilder *geom);
 
-// Push a textured quad (6 vertices = 2 triangles)
+// Push a textured quad (4 vertices, drawn via the shared index buffer)
 // tile_index is the tile index in the combined atlas
 // Renders at tile_size × tile_size from the context
 void geobuilder_tile(GeometryBuilder *geom, int tile_index, int x, int y);
 
-// Push a colored rect (6 vertices using white tile center)
+// Emit one tile quad's vertices into a caller-provided buffer instead of
+// the builder (for layers cached across frames); returns vertices written
+int geometry_emit_tile(RenderContext *ctx, Vertex *out, int tile_index, int x,
+                       int y);
+
+// Append pre-built vertices translated by (dx, dy), flushing only on
+// quad boundaries (replays cached layers through the normal batching)
+void geobuilder_vertices(GeometryBuilder *geom, const Vertex *verts, int count,
+                         float dx, float dy);
+
+// Push a colored rect (one quad using white tile center)
 void geobuilder_rect(GeometryBuilder *geom, int x, int y, int w, int h,
                      Color color);
 
-// Push a colored rect with per-vertex colors (6 vertices using white tile
-// center) Colors are specified for each corner: top-left, top-right,
-// bottom-left, bottom-right
+// Push a colored rect with per-vertex colors (a center-fan of four
+// degenerate quads using white tile center). Colors are specified for each
+// corner: top-left, top-right, bottom-left, bottom-right
 void geobuilder_rect_colored(GeometryBuilder *geom, int x, int y, int w, int h,
                              Color tl, Color tr, Color bl, Color br);
 
@@ -83,3 +101,10 @@ typedef enum {
 // scale: 1.0 = tile_size, 0.5 = half size, etc.
 void geobuilder_text(GeometryBuilder *geom, int x, int y, float scale,
                      TextAlign align, Color bg_color, const char *text);
+
+// Same semantics as geobuilder_text, but shaped glyph quads are kept in
+// a small cache keyed by string + style and replayed shifted into place.
+// Use for HUD strings that change rarely (FPS counter, message log);
+// strings too long for a cache slot fall back to the uncached path
+void geobuilder_text_cached(GeometryBuilder *geom, int x, int y, float scale,
+                            TextAlign align, Color bg_color, const char *text);
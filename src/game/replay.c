@@ -0,0 +1,139 @@
+#include "replay.h"
+#include "api.h"
+#include "utils/bbuf.h"
+#include "utils/print.h"
+#include "world.h"
+
+// Header: u32 version, u64 rng_seed, u64 end_rng_state, u64
+// end_tick_counter. The end-state fields are packed as zeros up front and
+// rewritten in place at export time; end_state_offset remembers where
+// they landed (bbuf debug labels make the offset depend on the build)
+#define REPLAY_VERSION 1
+
+// declared here rather than in api.h (which only carries the signature
+// macros); game_start_replay restarts the world through it
+GAME_INIT_SIG(GAME_INIT_NAME);
+
+void replay_record_start(uint64_t rng_seed) {
+  ReplayState *rp = &WORLD.replay;
+  if (rp->mode == REPLAY_REPLAYING) {
+    return; // the session is being driven by a replay, not recorded
+  }
+  ByteBuffer buf = {.capacity = REPLAY_BUFFER_SIZE, .data = rp->buffer};
+  bbuf_pack_u32(&buf, REPLAY_VERSION, "replay_version");
+  bbuf_pack_u64(&buf, rng_seed, "rng_seed");
+  rp->end_state_offset = buf.size;
+  bbuf_pack_u64(&buf, 0, "end_rng_state");    // finalized at export
+  bbuf_pack_u64(&buf, 0, "end_tick_counter"); // finalized at export
+  rp->size = buf.size;
+  rp->cursor = 0;
+  rp->mode = REPLAY_RECORDING;
+}
+
+// Replay ran past its last frame: report whether the live world ended up
+// in the recorded end state, then hand control back to the host
+static void replay_finish(void) {
+  ReplayState *rp = &WORLD.replay;
+  rp->mode = REPLAY_OFF;
+  WORLD.frame_damage = true;
+  if (WORLD.rng_state == rp->end_rng_state &&
+      WORLD.tick_counter == rp->end_tick_counter) {
+    host_log(LOG_INFO, "replay finished: outcome matches recording");
+  } else {
+    PRINT(msg, 128, "replay DIVERGED: tick ");
+    print_uint(&msg, WORLD.tick_counter);
+    print_str(&msg, " vs recorded ");
+    print_uint(&msg, rp->end_tick_counter);
+    print_str(&msg, ", rng_state ");
+    print_str(&msg, WORLD.rng_state == rp->end_rng_state ? "matches"
+                                                         : "differs");
+    host_log(LOG_ERROR, msg.data);
+  }
+}
+
+double replay_frame(double dt) {
+  ReplayState *rp = &WORLD.replay;
+
+  if (rp->mode == REPLAY_RECORDING) {
+    // quantize dt and run the frame on the quantized value, so the live
+    // session computes exactly what its replays will
+    uint32_t dt_us = (uint32_t)(dt * 1000000.0 + 0.5);
+    if (rp->size + 16 > REPLAY_BUFFER_SIZE) {
+      rp->mode = REPLAY_OFF;
+      host_log(LOG_WARN, "replay buffer full, recording stopped");
+      return dt;
+    }
+    ByteBuffer buf = {
+        .capacity = REPLAY_BUFFER_SIZE, .size = rp->size, .data = rp->buffer};
+    // terse labels: these two are paid once per frame
+    bbuf_pack_varint(&buf, dt_us, "dt");
+    bbuf_pack_varint(&buf, WORLD.next_player_input, "in");
+    rp->size = buf.size;
+    return dt_us / 1000000.0;
+  }
+
+  if (rp->mode == REPLAY_REPLAYING) {
+    if (rp->cursor >= rp->size) {
+      replay_finish();
+      return dt;
+    }
+    ByteBuffer buf = {
+        .size = rp->size, .read_pos = rp->cursor, .data = rp->buffer};
+    uint32_t dt_us = (uint32_t)bbuf_unpack_varint(&buf, "dt");
+    InputCommand cmd = (InputCommand)bbuf_unpack_varint(&buf, "in");
+    rp->cursor = buf.read_pos;
+    if (WORLD.next_player_input != cmd) {
+      WORLD.next_player_input = cmd;
+      WORLD.frame_damage = true;
+    }
+    return dt_us / 1000000.0;
+  }
+
+  return dt;
+}
+
+GAME_GET_REPLAY_SIG(GAME_GET_REPLAY_NAME) {
+  ReplayState *rp = &WORLD.replay;
+  if (rp->mode != REPLAY_RECORDING) {
+    return 0;
+  }
+  // finalize the end-state fields in place (same labels, same widths, so
+  // the stream layout is unchanged); recording keeps appending afterwards,
+  // so the host must consume the bytes before the next game_frame
+  ByteBuffer buf = {.capacity = rp->size - rp->end_state_offset,
+                    .data = rp->buffer + rp->end_state_offset};
+  bbuf_pack_u64(&buf, WORLD.rng_state, "end_rng_state");
+  bbuf_pack_u64(&buf, WORLD.tick_counter, "end_tick_counter");
+  *data = rp->buffer;
+  return rp->size;
+}
+
+GAME_START_REPLAY_SIG(GAME_START_REPLAY_NAME) {
+  if (data_size < 16 || data_size > REPLAY_BUFFER_SIZE) {
+    host_log(LOG_ERROR, "replay data has invalid size");
+    return;
+  }
+  ByteBuffer header = {.size = (uint32_t)data_size, .data = (uint8_t *)data};
+  if (bbuf_unpack_u32(&header, "replay_version") != REPLAY_VERSION) {
+    host_log(LOG_ERROR, "replay data has unsupported version");
+    return;
+  }
+  uint64_t rng_seed = bbuf_unpack_u64(&header, "rng_seed");
+  uint64_t end_rng_state = bbuf_unpack_u64(&header, "end_rng_state");
+  uint64_t end_tick_counter = bbuf_unpack_u64(&header, "end_tick_counter");
+  uint32_t frames_start = header.read_pos;
+
+  // restart from scratch: game_init assumes zeroed memory, and the replay
+  // stream (set up before the call, since replay_record_start checks the
+  // mode) must survive the wipe
+  memset(&WORLD, 0, sizeof(WorldState));
+  ReplayState *rp = &WORLD.replay;
+  memcpy(rp->buffer, data, data_size);
+  rp->size = (uint32_t)data_size;
+  rp->cursor = frames_start;
+  rp->end_rng_state = end_rng_state;
+  rp->end_tick_counter = end_tick_counter;
+  rp->mode = REPLAY_REPLAYING;
+  game_init(rng_seed);
+  host_log(LOG_INFO, "replay started");
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "common.h"
+
+// ============================================================================
+// Input session recording and deterministic replay
+//
+// All nondeterminism enters the simulation through the rng seed passed to
+// game_init, the per-frame dt, and next_player_input. Recording captures
+// exactly those: a header with the seed, then one record per frame with
+// the dt (quantized to microseconds, and the quantized value is what the
+// frame actually runs with, so a recorded session is bit-identical to its
+// own replays) and the effective input. Replay restarts the world from
+// the recorded seed and drives game_frame from the stream, overriding
+// host dt and input, so the same file re-executes identically in the
+// windowed and headless builds.
+//
+// The header also carries the rng_state and tick_counter at export time;
+// when the stream runs out the replay compares them against the live
+// world and logs whether the run matched or diverged — a changed outcome
+// is how an "optimization" that altered game logic gets caught.
+//
+// Caveat: chunk paging round-trips through host storage, so replays
+// assume an empty chunk store (a fresh world re-creates the same chunks)
+// and deterministic storage callback timing. The headless host's
+// synchronous store satisfies both; the SDL host's async flush thread can
+// shift game_chunk_loaded by a frame under load.
+//
+// Hosts reach this through game_get_replay / game_start_replay (api.h)
+// and own the file I/O; the game only sees the byte stream.
+// ============================================================================
+
+// ~10 bytes per frame (varint dt + input + the bbuf debug labels), so
+// this holds roughly half an hour at 60fps; recording stops with a
+// warning when full
+#define REPLAY_BUFFER_SIZE (1024 * 1024)
+
+typedef enum {
+  REPLAY_OFF,
+  REPLAY_RECORDING,
+  REPLAY_REPLAYING,
+} ReplayMode;
+
+typedef struct {
+  ReplayMode mode;
+  uint32_t size;   // bytes used in buffer
+  uint32_t cursor; // read position while replaying
+  uint32_t end_state_offset; // where the end-state header fields sit,
+                             // rewritten in place at export time
+  uint64_t end_rng_state;    // expected final state (from the header)
+  uint64_t end_tick_counter;
+  uint8_t buffer[REPLAY_BUFFER_SIZE];
+} ReplayState;
+
+// Begin recording a fresh session (called from game_init; no-op when a
+// replay is driving the session)
+void replay_record_start(uint64_t rng_seed);
+
+// Per-frame hook at the top of game_frame: while recording, appends this
+// frame's dt and input and returns the quantized dt to run with; while
+// replaying, overrides next_player_input from the stream and returns the
+// recorded dt. Otherwise returns dt unchanged.
+double replay_frame(double dt);
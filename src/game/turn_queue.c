@@ -2,131 +2,106 @@
 #include "world.h"
 
 // ============================================================================
-// Turn queue implementation (min-heap on turn_schedule[e].delay)
+// Turn queue implementation (calendar queue on turn_schedule[e].delay)
+//
+// Replaces the old binary heap: delays are nearly all small multiples
+// within TURN_INTERVAL of each other, so a bucket per exact delay value
+// with a forward-scanning minimum cursor beats O(log n) sift churn per
+// push/pop. queue_index stores the entity's bucket, keeping the
+// TurnSchedule contract. Ties within a bucket pop most-recently-inserted
+// first — a different (but still deterministic) order than the heap's
+// index tie-break.
 // ============================================================================
 
-static inline void turn_queue_swap(uint16_t i, uint16_t j) {
-  EntityHandle tmp = WORLD.turn_queue.entities[i];
-  WORLD.turn_queue.entities[i] = WORLD.turn_queue.entities[j];
-  WORLD.turn_queue.entities[j] = tmp;
-
-  // Update stored heap indices (which heap position each entity is at)
-  EntityIndex entity_i = entity_handle_to_index(WORLD.turn_queue.entities[i]);
-  EntityIndex entity_j = entity_handle_to_index(WORLD.turn_queue.entities[j]);
-  PART(TurnSchedule, entity_i).queue_index =
-      i; // entity_i is now at heap position i
-  PART(TurnSchedule, entity_j).queue_index =
-      j; // entity_j is now at heap position j
+#define TURN_QUEUE_MASK (TURN_QUEUE_BUCKETS - 1)
+
+// Map a delay to its bucket, pulling the calendar back first when the
+// delay undercuts the current minimum (so the pop-min scan still starts
+// at the smallest key)
+static uint16_t turn_queue_bucket(int32_t delay) {
+  TurnQueue *q = &WORLD.turn_queue;
+  if (q->count == 0) {
+    q->base = delay;
+  } else if (delay < q->base) {
+    int32_t diff = q->base - delay;
+    assert(diff < TURN_QUEUE_BUCKETS);
+    q->cursor = (q->cursor + TURN_QUEUE_BUCKETS - diff) & TURN_QUEUE_MASK;
+    q->base = delay;
+  }
+  assert(delay - q->base < TURN_QUEUE_BUCKETS);
+  return (uint16_t)((q->cursor + (uint32_t)(delay - q->base)) &
+                    TURN_QUEUE_MASK);
 }
 
-static inline int turn_queue_compare(uint16_t a, uint16_t b) {
-  EntityIndex idx_a = entity_handle_to_index(WORLD.turn_queue.entities[a]);
-  EntityIndex idx_b = entity_handle_to_index(WORLD.turn_queue.entities[b]);
-  int diff = PART(TurnSchedule, idx_a).delay - PART(TurnSchedule, idx_b).delay;
-  return diff ? diff : idx_a - idx_b;
+static void turn_queue_link(EntityIndex entity, uint16_t bucket) {
+  TurnQueue *q = &WORLD.turn_queue;
+  q->next[entity] = q->bucket_head[bucket];
+  q->bucket_head[bucket] = entity;
+  PART(TurnSchedule, entity).queue_index = bucket;
 }
 
-static void turn_queue_sift_up(uint16_t heap_index) {
-  while (heap_index > 0) {
-    uint16_t parent = (heap_index - 1) / 2;
-    if (turn_queue_compare(heap_index, parent) >= 0)
-      break;
-    turn_queue_swap(heap_index, parent);
-    heap_index = parent;
+// Same walking unlink as spatial_index_remove: a bucket only holds the
+// entities sharing one exact delay value
+static void turn_queue_unlink(EntityIndex entity) {
+  TurnQueue *q = &WORLD.turn_queue;
+  uint16_t bucket = PART(TurnSchedule, entity).queue_index;
+  EntityIndex *link = &q->bucket_head[bucket];
+  while (*link != entity) {
+    assert(*link != 0); // entity must be in its recorded bucket
+    link = &q->next[*link];
   }
+  *link = q->next[entity];
 }
 
-static void turn_queue_sift_down(uint16_t heap_index) {
-  while (1) {
-    uint16_t left = 2 * heap_index + 1;
-    uint16_t right = 2 * heap_index + 2;
-    uint16_t smallest = heap_index;
-
-    if (left < WORLD.turn_queue.count &&
-        turn_queue_compare(left, smallest) < 0) {
-      smallest = left;
-    }
-    if (right < WORLD.turn_queue.count &&
-        turn_queue_compare(right, smallest) < 0) {
-      smallest = right;
-    }
-
-    if (smallest == heap_index)
-      break;
-
-    turn_queue_swap(heap_index, smallest);
-    heap_index = smallest;
+// Advance the cursor to the bucket holding the current minimum
+static uint16_t turn_queue_min_bucket(void) {
+  TurnQueue *q = &WORLD.turn_queue;
+  assert(q->count > 0);
+  while (q->bucket_head[q->cursor] == 0) {
+    q->cursor = (q->cursor + 1) & TURN_QUEUE_MASK;
+    q->base++;
   }
+  return (uint16_t)q->cursor;
 }
 
 void turn_queue_insert(EntityIndex entity, int16_t delay) {
   assert(WORLD.turn_queue.count < MAX_ENTITIES);
   assert(!HAS_PART(TurnSchedule, entity)); // Must not already be in queue
 
-  // Add part
-  uint16_t heap_pos = WORLD.turn_queue.count;
-  ADD_PART(TurnSchedule, entity,
-           ((TurnSchedule){.delay = delay, .queue_index = heap_pos}));
-
-  // Add to end of heap and sift up
-  WORLD.turn_queue.entities[heap_pos] = entity_handle_from_index(entity);
-  turn_queue_sift_up(heap_pos);
+  ADD_PART(TurnSchedule, entity, ((TurnSchedule){.delay = delay}));
+  turn_queue_link(entity, turn_queue_bucket(delay));
   WORLD.turn_queue.count++;
 }
 
 void turn_queue_remove(EntityIndex entity) {
   assert(HAS_PART(TurnSchedule, entity));
 
-  uint16_t heap_index = PART(TurnSchedule, entity).queue_index;
-  assert(heap_index < WORLD.turn_queue.count);
-
-  // Remove part
+  turn_queue_unlink(entity);
   REMOVE_PART(TurnSchedule, entity);
-
-  // Replace with last element
   WORLD.turn_queue.count--;
-  if (heap_index < WORLD.turn_queue.count) {
-    WORLD.turn_queue.entities[heap_index] =
-        WORLD.turn_queue.entities[WORLD.turn_queue.count];
-    EntityIndex moved_entity =
-        entity_handle_to_index(WORLD.turn_queue.entities[heap_index]);
-    PART(TurnSchedule, moved_entity).queue_index = heap_index;
-
-    // Restore heap property - try both directions
-    uint16_t original = heap_index;
-    turn_queue_sift_up(heap_index);
-    if (PART(TurnSchedule, moved_entity).queue_index == original) {
-      turn_queue_sift_down(heap_index);
-    }
-  }
 }
 
 void turn_queue_add_delay(EntityIndex entity, int16_t delta) {
   assert(HAS_PART(TurnSchedule, entity));
 
-  uint16_t heap_index = PART(TurnSchedule, entity).queue_index;
-  PART(TurnSchedule, entity).delay += delta;
+  turn_queue_unlink(entity);
+  int16_t delay = (PART(TurnSchedule, entity).delay += delta);
+  turn_queue_link(entity, turn_queue_bucket(delay));
+}
 
-  // Reprioritize - try both directions
-  uint16_t original = heap_index;
-  turn_queue_sift_up(heap_index);
-  if (PART(TurnSchedule, entity).queue_index == original) {
-    turn_queue_sift_down(heap_index);
-  }
+void turn_queue_rebase(int16_t delta) {
+  WORLD.turn_queue.base += delta;
 }
 
 EntityHandle turn_queue_peek() {
-  assert(WORLD.turn_queue.count > 0);
-  return WORLD.turn_queue.entities[0];
+  return entity_handle_from_index(
+      WORLD.turn_queue.bucket_head[turn_queue_min_bucket()]);
 }
 
 EntityHandle turn_queue_pop() {
-  assert(WORLD.turn_queue.count > 0);
-
-  EntityHandle result = WORLD.turn_queue.entities[0];
-  EntityIndex entity = entity_handle_to_index(result);
+  EntityIndex entity = WORLD.turn_queue.bucket_head[turn_queue_min_bucket()];
   turn_queue_remove(entity);
-  return result;
+  return entity_handle_from_index(entity);
 }
 
 void turn_queue_debug_print() {
@@ -3,12 +3,25 @@
 #include "common.h"
 
 // ============================================================================
-// Turn queue (min-heap priority queue based on turn_schedule[e].delay)
+// Turn queue (calendar/bucket queue on turn_schedule[e].delay)
+//
+// One bucket per exact delay value, as intrusive singly-linked entity
+// lists (same shape as SpatialIndex). Insert, reprioritize and pop-min
+// are O(1) amortized: cursor points at the bucket holding the current
+// minimum and only ever walks forward as game time advances, and base is
+// the delay value that bucket represents. All delays must fall within
+// TURN_QUEUE_BUCKETS of the current minimum — action costs top out at a
+// few TURN_INTERVALs, so the horizon is generous.
 // ============================================================================
 
+#define TURN_QUEUE_BUCKETS 1024 // power of two
+
 typedef struct {
   int count;
-  EntityHandle entities[MAX_ENTITIES];
+  int32_t base;    // delay value of the bucket at cursor
+  uint32_t cursor; // bucket where the pop-min scan starts
+  EntityIndex bucket_head[TURN_QUEUE_BUCKETS]; // 0 = empty bucket
+  EntityIndex next[MAX_ENTITIES]; // next entity in the same bucket
 } TurnQueue;
 
 // Insert entity into turn queue with given delay (adds turn_schedule part)
@@ -20,6 +33,11 @@ void turn_queue_remove(EntityIndex entity);
 // Add to entity's turn_schedule[e].delay and reprioritize in queue
 void turn_queue_add_delay(EntityIndex entity, int16_t delta);
 
+// Tell the queue about a uniform shift applied to every scheduled
+// entity's delay (the per-turn decrement in game.c): relative order is
+// unchanged, so only the anchor moves and every bucket stays put
+void turn_queue_rebase(int16_t delta);
+
 // Peek at next entity to act (lowest delay) without removing
 EntityHandle turn_queue_peek();
 
@@ -7,6 +7,7 @@ typedef struct {
   uint8_t *buffer;
   size_t capacity;
   size_t offset;
+  size_t high_water; // largest offset ever reached (for sizing/benchmarks)
 } Arena;
 
 // Checkpoint for restoring arena state
@@ -25,6 +26,9 @@ static inline void *arena_alloc(Arena *arena, size_t size) {
   void *ptr = arena->buffer + arena->offset;
   memset(ptr, 0, size);
   arena->offset += size;
+  if (arena->offset > arena->high_water) {
+    arena->high_water = arena->offset;
+  }
   return ptr;
 }
 
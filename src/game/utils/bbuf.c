@@ -2,8 +2,14 @@
 #include "../common.h" // IWYU pragma: keep
 #include "print.h"
 
-// Define this to enable debug label validation
+// Debug label validation embeds each field name in the stream and checks
+// it on unpack, catching pack/unpack mismatches at the exact field.
+// Stripped in release builds: labels roughly double stream size and add
+// a strlen + copy per field. NOTE: label presence is part of the wire
+// format, so debug and release builds do not read each other's saves
+#ifndef NDEBUG
 #define BBUF_DEBUG_LABELS
+#endif
 
 #ifdef BBUF_DEBUG_LABELS
 static void pack_label(ByteBuffer *buf, const char *label) {
@@ -145,6 +151,25 @@ void bbuf_pack_i64(ByteBuffer *buf, int64_t value, const char *label) {
   bbuf_pack_u64(buf, (uint64_t)value, label);
 }
 
+void bbuf_pack_varint(ByteBuffer *buf, uint64_t value, const char *label) {
+  // 7 value bits per byte, high bit set on all but the last byte
+  for (;;) {
+    uint8_t byte = value & 0x7F;
+    value >>= 7;
+    if (value) {
+      byte |= 0x80;
+    }
+    if (buf->size < buf->capacity) {
+      buf->data[buf->size] = byte;
+    }
+    buf->size++;
+    if (!value) {
+      break;
+    }
+  }
+  pack_label(buf, label);
+}
+
 void bbuf_pack_bytes(ByteBuffer *buf, const void *data, uint32_t len,
                      const char *label) {
   uint32_t to_copy = len;
@@ -158,6 +183,48 @@ void bbuf_pack_bytes(ByteBuffer *buf, const void *data, uint32_t len,
   pack_label(buf, label);
 }
 
+// Bulk array variants: one capacity check for the whole array, then a
+// tight store loop (or memcpy) the compiler can vectorize. All-or-
+// nothing on overflow: size still grows past capacity so the caller can
+// detect it, but nothing partial is written
+
+void bbuf_pack_u8_array(ByteBuffer *buf, const uint8_t *values, uint32_t count,
+                        const char *label) {
+  if (buf->size + count <= buf->capacity) {
+    memcpy(buf->data + buf->size, values, count);
+  }
+  buf->size += count;
+  pack_label(buf, label);
+}
+
+void bbuf_pack_u16_array(ByteBuffer *buf, const uint16_t *values,
+                         uint32_t count, const char *label) {
+  if (buf->size + count * 2 <= buf->capacity) {
+    uint8_t *out = buf->data + buf->size;
+    for (uint32_t i = 0; i < count; i++) {
+      out[i * 2 + 0] = (uint8_t)(values[i] & 0xFF);
+      out[i * 2 + 1] = (uint8_t)(values[i] >> 8);
+    }
+  }
+  buf->size += count * 2;
+  pack_label(buf, label);
+}
+
+void bbuf_pack_u32_array(ByteBuffer *buf, const uint32_t *values,
+                         uint32_t count, const char *label) {
+  if (buf->size + count * 4 <= buf->capacity) {
+    uint8_t *out = buf->data + buf->size;
+    for (uint32_t i = 0; i < count; i++) {
+      out[i * 4 + 0] = (uint8_t)(values[i] & 0xFF);
+      out[i * 4 + 1] = (uint8_t)((values[i] >> 8) & 0xFF);
+      out[i * 4 + 2] = (uint8_t)((values[i] >> 16) & 0xFF);
+      out[i * 4 + 3] = (uint8_t)((values[i] >> 24) & 0xFF);
+    }
+  }
+  buf->size += count * 4;
+  pack_label(buf, label);
+}
+
 // Unpack functions - little-endian byte-packed decoding
 // Uses internal read_pos which is updated as we read
 // asserts that reads don't go out of bounds
@@ -220,6 +287,21 @@ int64_t bbuf_unpack_i64(ByteBuffer *buf, const char *label) {
   return (int64_t)bbuf_unpack_u64(buf, label);
 }
 
+uint64_t bbuf_unpack_varint(ByteBuffer *buf, const char *label) {
+  uint64_t value = 0;
+  int shift = 0;
+  uint8_t byte;
+  do {
+    assert(buf->read_pos + 1 <= buf->size);
+    assert(shift < 64);
+    byte = buf->data[buf->read_pos++];
+    value |= (uint64_t)(byte & 0x7F) << shift;
+    shift += 7;
+  } while (byte & 0x80);
+  unpack_label(buf, label);
+  return value;
+}
+
 void bbuf_unpack_bytes(ByteBuffer *buf, void *dest, uint32_t len,
                        const char *label) {
   assert(buf->read_pos + len <= buf->size);
@@ -227,3 +309,35 @@ void bbuf_unpack_bytes(ByteBuffer *buf, void *dest, uint32_t len,
   buf->read_pos += len;
   unpack_label(buf, label);
 }
+
+void bbuf_unpack_u8_array(ByteBuffer *buf, uint8_t *values, uint32_t count,
+                          const char *label) {
+  assert(buf->read_pos + count <= buf->size);
+  memcpy(values, buf->data + buf->read_pos, count);
+  buf->read_pos += count;
+  unpack_label(buf, label);
+}
+
+void bbuf_unpack_u16_array(ByteBuffer *buf, uint16_t *values, uint32_t count,
+                           const char *label) {
+  assert(buf->read_pos + count * 2 <= buf->size);
+  const uint8_t *in = buf->data + buf->read_pos;
+  for (uint32_t i = 0; i < count; i++) {
+    values[i] = (uint16_t)(in[i * 2 + 0] | (in[i * 2 + 1] << 8));
+  }
+  buf->read_pos += count * 2;
+  unpack_label(buf, label);
+}
+
+void bbuf_unpack_u32_array(ByteBuffer *buf, uint32_t *values, uint32_t count,
+                           const char *label) {
+  assert(buf->read_pos + count * 4 <= buf->size);
+  const uint8_t *in = buf->data + buf->read_pos;
+  for (uint32_t i = 0; i < count; i++) {
+    values[i] = (uint32_t)in[i * 4 + 0] | ((uint32_t)in[i * 4 + 1] << 8) |
+                ((uint32_t)in[i * 4 + 2] << 16) |
+                ((uint32_t)in[i * 4 + 3] << 24);
+  }
+  buf->read_pos += count * 4;
+  unpack_label(buf, label);
+}
@@ -20,9 +20,23 @@ void bbuf_pack_i16(ByteBuffer *buf, int16_t value, const char *label);
 void bbuf_pack_i32(ByteBuffer *buf, int32_t value, const char *label);
 void bbuf_pack_i64(ByteBuffer *buf, int64_t value, const char *label);
 
+// LEB128 variable-length encoding: small values (entity indices, counts,
+// sparse bitset words) take 1-2 bytes instead of a fixed-width field
+void bbuf_pack_varint(ByteBuffer *buf, uint64_t value, const char *label);
+
 void bbuf_pack_bytes(ByteBuffer *buf, const void *data, uint32_t len,
                      const char *label);
 
+// Bulk typed arrays: one capacity check and one label for the whole
+// array instead of per element. The count is not part of the encoding;
+// callers pack it themselves (usually as a varint)
+void bbuf_pack_u8_array(ByteBuffer *buf, const uint8_t *values, uint32_t count,
+                        const char *label);
+void bbuf_pack_u16_array(ByteBuffer *buf, const uint16_t *values,
+                         uint32_t count, const char *label);
+void bbuf_pack_u32_array(ByteBuffer *buf, const uint32_t *values,
+                         uint32_t count, const char *label);
+
 uint8_t bbuf_unpack_u8(ByteBuffer *buf, const char *label);
 uint16_t bbuf_unpack_u16(ByteBuffer *buf, const char *label);
 uint32_t bbuf_unpack_u32(ByteBuffer *buf, const char *label);
@@ -33,5 +47,14 @@ int16_t bbuf_unpack_i16(ByteBuffer *buf, const char *label);
 int32_t bbuf_unpack_i32(ByteBuffer *buf, const char *label);
 int64_t bbuf_unpack_i64(ByteBuffer *buf, const char *label);
 
+uint64_t bbuf_unpack_varint(ByteBuffer *buf, const char *label);
+
 void bbuf_unpack_bytes(ByteBuffer *buf, void *dest, uint32_t len,
                        const char *label);
+
+void bbuf_unpack_u8_array(ByteBuffer *buf, uint8_t *values, uint32_t count,
+                          const char *label);
+void bbuf_unpack_u16_array(ByteBuffer *buf, uint16_t *values, uint32_t count,
+                           const char *label);
+void bbuf_unpack_u32_array(ByteBuffer *buf, uint32_t *values, uint32_t count,
+                           const char *label);
@@ -94,9 +94,12 @@ sdefl_lit(unsigned char *dst, struct sdefl *s, int c)
         return sdefl_put(dst, s, sdefl_mirror[0x30+c], 8);
     else return sdefl_put(dst, s, 1 + 2 * sdefl_mirror[0x90 - 144 + c], 9);
 }
-extern int
-sdeflate(struct sdefl *s, unsigned char *out,
-    const unsigned char *in, int in_len, int lvl)
+/* shared core: in holds start history bytes (dictionary) followed by the
+ * payload, total in_len bytes. history enters the hash chains so payload
+ * matches can reference it, but only payload bytes are emitted */
+static int
+sdefl_compress(struct sdefl *s, unsigned char *out,
+    const unsigned char *in, int start, int in_len, int lvl)
 {
     int p = 0;
     int max_chain = (lvl < 8) ? (1<<(lvl+1)): (1<<13);
@@ -107,6 +110,11 @@ sdeflate(struct sdefl *s, unsigned char *out,
         s->tbl[p] = SDEFL_NIL;
 
     p = 0;
+    while (p < start) {
+        unsigned h = sdefl_hash32(&in[p]);
+        s->prv[p&SDEFL_WIN_MSK] = s->tbl[h];
+        s->tbl[h] = p++;
+    }
     q = sdefl_put(q, s, 0x01, 1); /* block */
     q = sdefl_put(q, s, 0x01, 2); /* static huffman */
     while (p < in_len) {
@@ -172,6 +180,18 @@ sdeflate(struct sdefl *s, unsigned char *out,
     return (int)(q - out);
 }
 extern int
+sdeflate(struct sdefl *s, unsigned char *out,
+    const unsigned char *in, int in_len, int lvl)
+{
+    return sdefl_compress(s, out, in, 0, in_len, lvl);
+}
+extern int
+sdeflate_dict(struct sdefl *s, unsigned char *out,
+    const unsigned char *buf, int dict_len, int in_len, int lvl)
+{
+    return sdefl_compress(s, out, buf, dict_len, dict_len + in_len, lvl);
+}
+extern int
 sdefl_bound(int len)
 {
     int a = 128 + (len * 110) / 100;
@@ -24,5 +24,11 @@ struct sdefl {
 };
 extern int sdefl_bound(int in_len);
 extern int sdeflate(struct sdefl *s, unsigned char *out, const unsigned char *in, int in_len, int lvl);
+/* compress with a preset dictionary: buf holds dict_len dictionary bytes
+ * immediately followed by in_len payload bytes. the dictionary primes the
+ * match window (like zlib's deflateSetDictionary) but is not emitted, so
+ * payloads that repeat dictionary patterns compress as back-references
+ * from the first byte. decompress with sinflate_dict and the same dict */
+extern int sdeflate_dict(struct sdefl *s, unsigned char *out, const unsigned char *buf, int dict_len, int in_len, int lvl);
 
 #endif /* SDEFL_H_INCLUDED */
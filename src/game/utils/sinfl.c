@@ -64,7 +64,10 @@ static int sinfl_decode(const unsigned char **in, const unsigned char *end,
   sinfl_get(in, end, s, key & 0x0f);
   return (key >> 4) & 0x0fff;
 }
-extern int sinflate(unsigned char *out, const unsigned char *in, int size) {
+/* shared core: out already holds dict_len history bytes that matches may
+ * reach back into; decompressed payload is appended after them */
+static int sinfl_decompress(unsigned char *out, const unsigned char *in,
+                            int size, int dict_len) {
   static const char order[] = {16, 17, 18, 0, 8,  7, 9,  6, 10, 5,
                                11, 4,  12, 3, 13, 2, 14, 1, 15};
   static const short dbase[30 + 2] = {
@@ -82,6 +85,7 @@ extern int sinflate(unsigned char *out, const unsigned char *in, int size) {
                                               4, 4, 5, 5, 5, 5, 0, 0, 0};
 
   const unsigned char *e = in + size, *o = out;
+  out += dict_len;
   enum sinfl_states { hdr, stored, fixed, dyn, blk };
   enum sinfl_states state = hdr;
   struct sinfl s;
@@ -98,7 +102,7 @@ extern int sinflate(unsigned char *out, const unsigned char *in, int size) {
 
       switch (type) {
       default:
-        return (int)(out - o);
+        return (int)(out - o) - dict_len;
       case 0x00:
         state = stored;
         break;
@@ -119,7 +123,7 @@ extern int sinflate(unsigned char *out, const unsigned char *in, int size) {
       s.bitcnt = 0;
 
       if (len > (e - in) || !len)
-        return (int)(out - o);
+        return (int)(out - o) - dict_len;
       memcpy(out, in, (size_t)len);
       in += len, out += len;
       state = hdr;
@@ -191,18 +195,25 @@ extern int sinflate(unsigned char *out, const unsigned char *in, int size) {
           int dsym = sinfl_decode(&in, e, &s, s.dsts, s.tdist);
           int offs = sinfl_get(&in, e, &s, dbits[dsym]) + dbase[dsym];
           if (offs > (int)(out - o))
-            return (int)(out - o);
+            return (int)(out - o) - dict_len;
           while (len--)
             *out = *(out - offs), out++;
         }
       } else if (sym == 256) {
         if (last)
-          return (int)(out - o);
+          return (int)(out - o) - dict_len;
         state = hdr;
       } else
         *out++ = (unsigned char)sym;
     } break;
     }
   }
-  return (int)(out - o);
+  return (int)(out - o) - dict_len;
+}
+extern int sinflate(unsigned char *out, const unsigned char *in, int size) {
+  return sinfl_decompress(out, in, size, 0);
+}
+extern int sinflate_dict(unsigned char *out, const unsigned char *in, int size,
+                         int dict_len) {
+  return sinfl_decompress(out, in, size, dict_len);
 }
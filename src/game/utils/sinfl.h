@@ -9,6 +9,11 @@ struct sinfl {
     int tlit, tdist, tlen;
 };
 extern int sinflate(unsigned char *out, const unsigned char *in, int size);
+/* decompress a stream produced by sdeflate_dict: out[0..dict_len) must
+ * already hold the dictionary, decompressed bytes are written starting at
+ * out + dict_len and the payload length is returned. streams compressed
+ * without a dictionary never reach back into it and decode unchanged */
+extern int sinflate_dict(unsigned char *out, const unsigned char *in, int size, int dict_len);
 
 #endif /* SINFL_H_INCLUDED */
 
@@ -2,89 +2,312 @@
 #include "common.h"
 #include "events/events.h"
 #include "parts.h"
+#include "utils/print.h"
 
 // declare global WorldState pointer
 WorldState *active_world;
 
 void output_message(const char *text) {
-  // If buffer is full, drop oldest message
-  if (WORLD.messages.count == MESSAGE_COUNT_MAX) {
-    WORLD.messages.first = (WORLD.messages.first + 1) % MESSAGE_COUNT_MAX;
-  } else {
-    WORLD.messages.count++;
+  MessageState *log = &WORLD.messages;
+
+  uint32_t length = strlen(text);
+  if (length > MESSAGE_LENGTH_MAX) {
+    length = MESSAGE_LENGTH_MAX;
   }
 
-  // Format message at next position
-  uint32_t pos =
-      (WORLD.messages.first + WORLD.messages.count - 1) % MESSAGE_COUNT_MAX;
-  Message *msg = &WORLD.messages.buffer[pos];
-  msg->length = strlen(text);
-  if (msg->length > MESSAGE_LENGTH_MAX) {
-    msg->length = MESSAGE_LENGTH_MAX;
+  // Records never straddle the end of the text ring: when the tail is
+  // too short, skip it (the skipped bytes age out like any others)
+  uint32_t pos = log->text_head & (MESSAGE_TEXT_SIZE - 1);
+  if (pos + length + 1 > MESSAGE_TEXT_SIZE) {
+    log->text_head += MESSAGE_TEXT_SIZE - pos;
   }
-  memcpy(msg->text, text, msg->length);
-  msg->text[msg->length] = '\0';
-}
 
-void entityset_add(EntitySet *set, EntityIndex index) {
-  if (bitset_test(set->bitset, index)) {
-    return;
+  uint32_t offset = log->text_head;
+  log->text_head += length + 1;
+
+  // Drop messages whose bytes the new record overwrites, plus the
+  // oldest one when the index ring itself is full
+  while (log->count > 0 &&
+         (log->count == MESSAGE_COUNT_MAX ||
+          log->text_head - log->offsets[log->first & (MESSAGE_COUNT_MAX - 1)] >
+              MESSAGE_TEXT_SIZE)) {
+    log->first++;
+    log->count--;
   }
-  bitset_set(set->bitset, index);
-  set->entities[set->count++] = index;
+
+  log->offsets[(log->first + log->count) & (MESSAGE_COUNT_MAX - 1)] = offset;
+  log->count++;
+
+  char *dst = &log->text[offset & (MESSAGE_TEXT_SIZE - 1)];
+  memcpy(dst, text, length);
+  dst[length] = '\0';
+
+  WORLD.frame_damage = true; // message log is rendered, so redraw
 }
 
-#define MAX_DEPTH 100
+// Fetch retained message text by age. The pointer aims into the text
+// ring and stays valid until the next output_message
+const char *message_get(uint32_t index) {
+  assert(index < WORLD.messages.count);
+  uint32_t offset = WORLD.messages.offsets[(WORLD.messages.first + index) &
+                                           (MESSAGE_COUNT_MAX - 1)];
+  return &WORLD.messages.text[offset & (MESSAGE_TEXT_SIZE - 1)];
+}
 
-void entityset_expand_descendants(EntitySet *set) {
-  // Track visited entities to avoid redundant parent chain walks
-  uint64_t visited[ENTITY_BITSET_WORDS];
+// ============================================================================
+// Cached queries
+// ============================================================================
+
+static const uint64_t *part_bitset_for_type(PartType type) {
+  switch (type) {
+#define DO_MARK_CASE(name)                                                     \
+  case PART_TYPE_##name:                                                       \
+    return WORLD.parts.name##Bitset;
+#define DO_PART_CASE(name, type)                                               \
+  case PART_TYPE_##name:                                                       \
+    return WORLD.parts.name##Bitset;
+    FOREACH_MARK(DO_MARK_CASE)
+    FOREACH_PART(DO_PART_CASE)
+#undef DO_MARK_CASE
+#undef DO_PART_CASE
+  default:
+    assert(0 && "unknown part type");
+    return NULL;
+  }
+}
 
-  // Pre-populate visited with entities already in the set
-  bitset_copy(visited, set->bitset);
+static bool query_matches_entity(CachedQuery *query, EntityIndex entity) {
+  for (PartType type = 0; type < PART_TYPE_MAX; type++) {
+    if (part_bitset_test(&query->include, type) &&
+        !bitset_test(part_bitset_for_type(type), entity)) {
+      return false;
+    }
+    if (part_bitset_test(&query->exclude, type) &&
+        bitset_test(part_bitset_for_type(type), entity)) {
+      return false;
+    }
+  }
+  return true;
+}
 
-  // Scan all entities with parent part
-  WORLD_QUERY(i, BITS(Parent)) {
-    // Skip if already visited
-    if (bitset_test(visited, i))
+// combine the query's part bitsets into one scratch match bitset using the
+// vectorized kernels. returns false if the query has no include parts, in
+// which case the caller must fall back to a per-entity scan (a pure-exclude
+// bitset would wrongly match unallocated slots)
+static bool query_build_match_bitset(CachedQuery *query, uint64_t *scratch) {
+  bool have_include = false;
+  for (PartType type = 0; type < PART_TYPE_MAX; type++) {
+    if (!part_bitset_test(&query->include, type)) {
       continue;
+    }
+    if (!have_include) {
+      bitset_copy(scratch, part_bitset_for_type(type));
+      have_include = true;
+    } else {
+      bitset_and(scratch, scratch, part_bitset_for_type(type));
+    }
+  }
+  if (!have_include) {
+    return false;
+  }
+  for (PartType type = 0; type < PART_TYPE_MAX; type++) {
+    if (part_bitset_test(&query->exclude, type)) {
+      bitset_andnot(scratch, scratch, part_bitset_for_type(type));
+    }
+  }
+  return true;
+}
 
-    // Walk up parent chain, recording the path
-    uint32_t path[MAX_DEPTH];
-    uint32_t path_len = 0;
-    path[path_len++] = i;
-    bitset_set(visited, i);
+static void query_add_entity(CachedQuery *query, EntityIndex entity) {
+  bitset_set(query->bitset, entity);
+  query->entities[query->count++] = entity;
+}
 
-    EntityIndex current_idx = PART(Parent, i);
-    bool found = false;
+static void query_remove_entity(CachedQuery *query, EntityIndex entity) {
+  bitset_clear(query->bitset, entity);
+  for (uint32_t i = 0; i < query->count; i++) {
+    if (query->entities[i] == entity) {
+      query->entities[i] = query->entities[--query->count];
+      return;
+    }
+  }
+  assert(0 && "entity in query bitset but not in dense list");
+}
 
-    for (int depth = 0; depth < MAX_DEPTH; depth++) {
-      // Check if this ancestor is in the set
-      if (bitset_test(set->bitset, current_idx)) {
-        found = true;
-        break;
-      }
+CachedQuery *query_cache_get(PartBitset include, PartBitset exclude) {
+  // look up existing registration for these masks
+  for (uint32_t i = 0; i < WORLD.query_cache.count; i++) {
+    CachedQuery *query = &WORLD.query_cache.queries[i];
+    if (memcmp(&query->include, &include, sizeof(include)) == 0 &&
+        memcmp(&query->exclude, &exclude, sizeof(exclude)) == 0) {
+      return query;
+    }
+  }
 
-      // Check if already visited (meaning we've determined it's not a
-      // descendant)
-      if (bitset_test(visited, current_idx)) {
-        break;
+  // register new query and build its index list with a one-time full scan
+  assert(WORLD.query_cache.count < QUERY_CACHE_MAX);
+  CachedQuery *query = &WORLD.query_cache.queries[WORLD.query_cache.count++];
+  memset(query, 0, sizeof(*query));
+  query->include = include;
+  query->exclude = exclude;
+  uint64_t scratch[ENTITY_BITSET_WORDS];
+  if (query_build_match_bitset(query, scratch)) {
+    BITSET_QUERY(i, scratch) { query_add_entity(query, i); }
+  } else {
+    for (EntityIndex i = 0; i < ENTITIES.count; i++) {
+      if (query_matches_entity(query, i)) {
+        query_add_entity(query, i);
       }
+    }
+  }
+  return query;
+}
+
+void query_cache_on_part_changed(PartType type, EntityIndex entity) {
+  // attribute, modifier, hierarchy and equipment changes expire every
+  // cached EffectiveAttributes entry (see attributes_effective)
+  switch (type) {
+  case PART_TYPE_Attributes:
+  case PART_TYPE_AttributesModifier:
+  case PART_TYPE_Parent:
+  case PART_TYPE_IsEquipped:
+    WORLD.attributes_epoch++;
+    break;
+  default:
+    break;
+  }
 
-      path[path_len++] = current_idx;
-      bitset_set(visited, current_idx);
+  for (uint32_t i = 0; i < WORLD.query_cache.count; i++) {
+    CachedQuery *query = &WORLD.query_cache.queries[i];
 
-      if (!HAS_PART(Parent, current_idx))
-        break;
-      current_idx = PART(Parent, current_idx);
+    // skip queries that don't care about this part
+    if (!part_bitset_test(&query->include, type) &&
+        !part_bitset_test(&query->exclude, type)) {
+      continue;
     }
 
-    // Add the entire path to set if found
-    if (found) {
-      for (uint32_t j = 0; j < path_len; j++) {
-        entityset_add(set, path[j]);
-      }
+    bool is_member = bitset_test(query->bitset, entity);
+    bool matches = query_matches_entity(query, entity);
+    if (matches && !is_member) {
+      query_add_entity(query, entity);
+    } else if (!matches && is_member) {
+      query_remove_entity(query, entity);
+    }
+  }
+}
+
+// ============================================================================
+// Spatial index
+// ============================================================================
+
+void spatial_index_insert(EntityIndex entity) {
+  assert(HAS_PART(Position, entity));
+  Position *pos = &PART(Position, entity);
+  if (pos->x >= MAP_WIDTH_MAX || pos->y >= MAP_HEIGHT_MAX) {
+    return; // out of window (about to be freed or rebuilt)
+  }
+  uint32_t idx = pos->y * MAP_WIDTH_MAX + pos->x;
+  WORLD.spatial.next[entity] = WORLD.spatial.head[idx];
+  WORLD.spatial.head[idx] = entity;
+}
+
+void spatial_index_remove(EntityIndex entity) {
+  assert(HAS_PART(Position, entity));
+  Position *pos = &PART(Position, entity);
+  if (pos->x >= MAP_WIDTH_MAX || pos->y >= MAP_HEIGHT_MAX) {
+    return; // never indexed (see spatial_index_insert)
+  }
+  uint32_t idx = pos->y * MAP_WIDTH_MAX + pos->x;
+  for (EntityIndex *link = &WORLD.spatial.head[idx]; *link;
+       link = &WORLD.spatial.next[*link]) {
+    if (*link == entity) {
+      *link = WORLD.spatial.next[entity];
+      WORLD.spatial.next[entity] = 0;
+      return;
+    }
+  }
+}
+
+void spatial_index_move(EntityIndex entity, Position to) {
+  spatial_index_remove(entity);
+  PART_MUT(Position, entity) = to;
+  spatial_index_insert(entity);
+}
+
+void spatial_index_rebuild(void) {
+  memset(&WORLD.spatial, 0, sizeof(WORLD.spatial));
+  WORLD_QUERY(i, BITS(Position)) { spatial_index_insert(i); }
+}
+
+// ============================================================================
+// Hierarchy index
+// ============================================================================
+
+void hierarchy_set_parent(EntityIndex entity, EntityIndex parent) {
+  if (HAS_PART(Parent, entity)) {
+    hierarchy_remove_parent(entity);
+  }
+  ADD_PART(Parent, entity, parent);
+  WORLD.hierarchy.next_sibling[entity] = WORLD.hierarchy.first_child[parent];
+  WORLD.hierarchy.first_child[parent] = entity;
+}
+
+void hierarchy_remove_parent(EntityIndex entity) {
+  if (!HAS_PART(Parent, entity)) {
+    return;
+  }
+  EntityIndex parent = PART(Parent, entity);
+  EntityIndex *link = &WORLD.hierarchy.first_child[parent];
+  while (*link != entity) {
+    assert(*link && "entity not in its parent's child list");
+    link = &WORLD.hierarchy.next_sibling[*link];
+  }
+  *link = WORLD.hierarchy.next_sibling[entity];
+  WORLD.hierarchy.next_sibling[entity] = 0;
+  REMOVE_PART(Parent, entity);
+}
+
+void hierarchy_rebuild(void) {
+  memset(&WORLD.hierarchy, 0, sizeof(WORLD.hierarchy));
+  WORLD_QUERY(i, BITS(Parent)) {
+    EntityIndex parent = PART(Parent, i);
+    WORLD.hierarchy.next_sibling[i] = WORLD.hierarchy.first_child[parent];
+    WORLD.hierarchy.first_child[parent] = i;
+  }
+}
+
+// spill an inline set to the arena-backed bitset + dense array form
+static void entityset_promote(EntitySet *set) {
+  set->bitset =
+      arena_alloc(&WORLD.frame_arena, ENTITY_BITSET_WORDS * sizeof(uint64_t));
+  set->entities = arena_alloc(&WORLD.frame_arena, MAX_ENTITIES * sizeof(EntityIndex));
+  for (uint32_t i = 0; i < set->count; i++) {
+    set->entities[i] = set->inline_entities[i];
+    bitset_set(set->bitset, set->inline_entities[i]);
+  }
+}
+
+void entityset_add(EntitySet *set, EntityIndex index) {
+  if (entityset_contains(set, index)) {
+    return;
+  }
+  if (!set->bitset) {
+    if (set->count < ENTITYSET_INLINE_MAX) {
+      set->inline_entities[set->count++] = index;
+      return;
     }
+    entityset_promote(set);
+  }
+  bitset_set(set->bitset, index);
+  set->entities[set->count++] = index;
+}
+
+void entityset_expand_descendants(EntitySet *set) {
+  // breadth-first walk over the child links: entities appended during
+  // iteration get their own children visited in turn, and entityset_add
+  // deduplicates, so this touches only the actual family members
+  for (uint32_t i = 0; i < set->count; i++) {
+    CHILDREN_QUERY(child, entityset_get(set, i)) { entityset_add(set, child); }
   }
 }
 
@@ -93,7 +316,7 @@ void entityset_free(EntitySet *to_free) {
 
   // Free all collected entities
   for (uint32_t i = 0; i < to_free->count; i++) {
-    EntityIndex index = to_free->entities[i];
+    EntityIndex index = entityset_get(to_free, i);
 
     on_entity_free(index);
 
@@ -115,6 +338,148 @@ void entityset_free(EntitySet *to_free) {
   }
 }
 
+// rebuild every registered cached query from scratch (used after operations
+// that move part bits around wholesale, like compaction)
+static void query_cache_rebuild_all(void) {
+  for (uint32_t i = 0; i < WORLD.query_cache.count; i++) {
+    CachedQuery *query = &WORLD.query_cache.queries[i];
+    query->count = 0;
+    memset(query->bitset, 0, sizeof(query->bitset));
+    uint64_t scratch[ENTITY_BITSET_WORDS];
+    if (query_build_match_bitset(query, scratch)) {
+      BITSET_QUERY(e, scratch) { query_add_entity(query, e); }
+    } else {
+      for (EntityIndex e = 0; e < ENTITIES.count; e++) {
+        if (query_matches_entity(query, e)) {
+          query_add_entity(query, e);
+        }
+      }
+    }
+  }
+}
+
+void entities_compact(void) {
+  // determine which slots hold live entities. freed slots sit in the
+  // freelist; slots retired at max generation are reclaimed here since all
+  // surviving handles get rewritten below
+  uint64_t in_freelist[ENTITY_BITSET_WORDS] = {0};
+  for (uint32_t i = 0; i < ENTITIES.freelist_count; i++) {
+    bitset_set(in_freelist, ENTITIES.freelist[i]);
+  }
+
+  // build old -> new remap, packing live entities into the low index range.
+  // the map is monotonic, so relative entity order (and turn queue
+  // tie-breaking on index) is preserved
+  EntityIndex remap[MAX_ENTITIES];
+  memset(remap, 0, sizeof(remap));
+  uint32_t live_count = 0;
+  for (uint32_t old = 0; old < ENTITIES.count; old++) {
+    bool live = old == 0 || (!bitset_test(in_freelist, old) &&
+                             ENTITIES.generation[old] != UINT16_MAX);
+    if (live) {
+      remap[old] = live_count++;
+    }
+  }
+
+  // move part data and bitset bits down. destinations are always <= source,
+  // so an ascending walk never overwrites unprocessed entries
+#define DO_COMPACT_MARK(name)                                                  \
+  for (uint32_t old = 1; old < ENTITIES.count; old++) {                        \
+    if (!bitset_test(WORLD.parts.name##Bitset, old)) {                         \
+      continue;                                                                \
+    }                                                                          \
+    bitset_clear(WORLD.parts.name##Bitset, old);                               \
+    bitset_set(WORLD.parts.name##Bitset, remap[old]);                          \
+  }
+
+#define DO_COMPACT_PART(name, type)                                            \
+  for (uint32_t old = 1; old < ENTITIES.count; old++) {                        \
+    if (!bitset_test(WORLD.parts.name##Bitset, old)) {                         \
+      continue;                                                                \
+    }                                                                          \
+    bitset_clear(WORLD.parts.name##Bitset, old);                               \
+    bitset_set(WORLD.parts.name##Bitset, remap[old]);                          \
+    if (bitset_test(WORLD.parts.name##DirtyBitset, old)) {                     \
+      bitset_clear(WORLD.parts.name##DirtyBitset, old);                        \
+      bitset_set(WORLD.parts.name##DirtyBitset, remap[old]);                   \
+    }                                                                          \
+    if (remap[old] != old) {                                                   \
+      PART(name, remap[old]) = PART(name, old);                                \
+      memset(&PART(name, old), 0, sizeof(PART(name, old)));                    \
+    }                                                                          \
+  }
+
+  FOREACH_MARK(DO_COMPACT_MARK)
+  FOREACH_PART(DO_COMPACT_PART)
+#undef DO_COMPACT_MARK
+#undef DO_COMPACT_PART
+
+  // move generations down with their entities so existing handles stay
+  // valid once their index is rewritten
+  for (uint32_t old = 1; old < ENTITIES.count; old++) {
+    if (remap[old] != 0 && remap[old] != old) {
+      ENTITIES.generation[remap[old]] = ENTITIES.generation[old];
+    }
+  }
+  for (uint32_t i = live_count; i < ENTITIES.count; i++) {
+    ENTITIES.generation[i] = 0;
+  }
+  ENTITIES.count = live_count;
+  ENTITIES.freelist_count = 0;
+
+  // fix up Parent links (stored as raw indices)
+  WORLD_QUERY(i, BITS(Parent)) { PART(Parent, i) = remap[PART(Parent, i)]; }
+
+  // fix up turn queue bucket lists (bucket indices in TurnSchedule stay
+  // valid, but the intrusive lists are keyed by entity index, so both the
+  // stored links and the next[] slots they live in must move)
+  EntityIndex old_next[MAX_ENTITIES];
+  memcpy(old_next, WORLD.turn_queue.next, sizeof(old_next));
+  for (int b = 0; b < TURN_QUEUE_BUCKETS; b++) {
+    EntityIndex old = WORLD.turn_queue.bucket_head[b];
+    WORLD.turn_queue.bucket_head[b] = remap[old];
+    while (old != 0) {
+      WORLD.turn_queue.next[remap[old]] = remap[old_next[old]];
+      old = old_next[old];
+    }
+  }
+
+  // fix up goal targets for goal types that reference entities
+  for (uint32_t i = 1; i < WORLD.ai.goals_count; i++) {
+    Goal *goal = &WORLD.ai.goals[i];
+    if (goal->type == GOAL_KILL || goal->type == GOAL_ATTACK) {
+      goal->target_entity._index = remap[goal->target_entity._index];
+    }
+  }
+
+  // fix up the special entity handles and any in-flight action animation
+  ENTITIES.player._index = remap[ENTITIES.player._index];
+  ENTITIES.turn._index = remap[ENTITIES.turn._index];
+  if (WORLD.anim.type != ACTION_ANIM_NONE) {
+    WORLD.anim.actor._index = remap[WORLD.anim.actor._index];
+    if (WORLD.anim.type == ACTION_ANIM_ATTACK) {
+      WORLD.anim.attack.target._index = remap[WORLD.anim.attack.target._index];
+    }
+  }
+
+  // per-entity side state that tracks indices across turns: NPC plans are
+  // transient decisions and just recompute; the lighting diff snapshot is
+  // keyed by old indices, so force a full relight instead of remapping a
+  // partial one; the autosave delta chain references old indices in
+  // already-written records, so restart it from a fresh baseline
+  memset(WORLD.npc_plan, 0, sizeof(WORLD.npc_plan));
+  memset(WORLD.lighting.prev_bits, 0, sizeof(WORLD.lighting.prev_bits));
+  WORLD.lighting.map_stamp_valid = false;
+  memset(WORLD.autosave.pending, 0, sizeof(WORLD.autosave.pending));
+  autosave_request_baseline();
+
+  WORLD.compact_counter++;
+
+  query_cache_rebuild_all();
+  spatial_index_rebuild();
+  hierarchy_rebuild();
+}
+
 EntityIndex entity_alloc(void) {
   if (ENTITIES.freelist_count > 0) {
     return ENTITIES.freelist[--ENTITIES.freelist_count];
@@ -123,10 +488,117 @@ EntityIndex entity_alloc(void) {
   return ENTITIES.count++;
 }
 
+// set all bits in [first, first + count) with word-granular masks
+static void bitset_set_range(uint64_t *bitset, uint32_t first, uint32_t count) {
+  uint32_t end = first + count;
+  for (uint32_t w = first / 64; w <= (end - 1) / 64; w++) {
+    uint32_t lo = w * 64 < first ? first - w * 64 : 0;
+    uint32_t hi = (w + 1) * 64 > end ? end - w * 64 : 64;
+    uint64_t mask = (hi == 64 ? ~0ULL : (1ULL << hi) - 1) & ~((1ULL << lo) - 1);
+    bitset[w] |= mask;
+  }
+}
+
+EntityBatch entity_batch_alloc(uint16_t count) {
+  assert(ENTITIES.count + count <= MAX_ENTITIES);
+  EntityBatch batch = {.first = (EntityIndex)ENTITIES.count, .count = count};
+  ENTITIES.count += count;
+  return batch;
+}
+
+void entity_batch_enable(uint64_t *bitset, uint64_t *dirty_bitset,
+                         PartType type, EntityBatch batch) {
+  if (batch.count == 0) {
+    return;
+  }
+  bitset_set_range(bitset, batch.first, batch.count);
+  if (dirty_bitset) {
+    bitset_set_range(dirty_bitset, batch.first, batch.count);
+  }
+  // cached queries still need per-entity membership updates
+  for (uint32_t i = 0; i < batch.count; i++) {
+    query_cache_on_part_changed(type, (EntityIndex)(batch.first + i));
+  }
+}
+
 void entity_free(EntityIndex index) {
+  // large hierarchies can promote the set to arena storage, so bracket it
+  ArenaCheckpoint checkpoint = arena_checkpoint(&WORLD.frame_arena);
   EntitySet to_free = {0};
   entityset_add(&to_free, index);
   entityset_free(&to_free);
+  arena_restore(&WORLD.frame_arena, checkpoint);
+}
+
+void parts_clear_dirty(void) {
+#define DO_CLEAR_DIRTY(name, type)                                             \
+  memset(WORLD.parts.name##DirtyBitset, 0,                                     \
+         sizeof(WORLD.parts.name##DirtyBitset));
+  FOREACH_PART(DO_CLEAR_DIRTY)
+#undef DO_CLEAR_DIRTY
+}
+
+bool parts_any_dirty(void) {
+  uint64_t acc = 0;
+#define DO_OR_DIRTY(name, type)                                                \
+  for (int w = 0; w < ENTITY_BITSET_WORDS; w++) {                              \
+    acc |= WORLD.parts.name##DirtyBitset[w];                                   \
+  }
+  FOREACH_PART(DO_OR_DIRTY)
+#undef DO_OR_DIRTY
+  return acc != 0;
+}
+
+static uint32_t bitset_popcount(const uint64_t *bitset) {
+  uint32_t n = 0;
+  for (int w = 0; w < ENTITY_BITSET_WORDS; w++) {
+    n += (uint32_t)__builtin_popcountll(bitset[w]);
+  }
+  return n;
+}
+
+uint32_t parts_debug_stats(PartStats *stats) {
+  uint32_t n = 0;
+#define DO_STAT_MARK(part)                                                     \
+  stats[n++] = (PartStats){                                                    \
+      .name = #part,                                                           \
+      .population = bitset_popcount(WORLD.parts.part##Bitset),                 \
+  };
+#define DO_STAT_PART(part, type)                                               \
+  stats[n++] = (PartStats){                                                    \
+      .name = #part,                                                           \
+      .population = bitset_popcount(WORLD.parts.part##Bitset),                 \
+      .dirty = bitset_popcount(WORLD.parts.part##DirtyBitset),                 \
+      .elem_size = (uint32_t)sizeof(type),                                     \
+  };
+  FOREACH_MARK(DO_STAT_MARK)
+  FOREACH_PART(DO_STAT_PART)
+#undef DO_STAT_MARK
+#undef DO_STAT_PART
+  assert(n == PART_TYPE_MAX);
+  return n;
+}
+
+void parts_debug_dump(void) {
+  PartStats stats[PART_TYPE_MAX];
+  uint32_t count = parts_debug_stats(stats);
+  for (uint32_t i = 0; i < count; i++) {
+    PRINT(msg, 128, "part ");
+    print_str(&msg, stats[i].name);
+    print_str(&msg, ": ");
+    print_uint(&msg, stats[i].population);
+    print_str(&msg, "/");
+    print_uint(&msg, ENTITIES.count);
+    print_str(&msg, " live");
+    if (stats[i].elem_size) {
+      print_str(&msg, ", ");
+      print_uint(&msg, stats[i].dirty * stats[i].elem_size);
+      print_str(&msg, "B dirty, ");
+      print_uint(&msg, (uint64_t)stats[i].elem_size * MAX_ENTITIES);
+      print_str(&msg, "B reserved");
+    }
+    host_log(LOG_INFO, msg.data);
+  }
 }
 
 bool entity_is_player(EntityIndex index) {
@@ -162,44 +634,97 @@ EntityIndex get_attributes_ancestor(EntityIndex entity) {
   }
 }
 
+// Effective attributes: base Attributes plus every AttributesModifier in
+// the entity's subtree that resolves to it via get_attributes_ancestor.
+// The result is cached in the EffectiveAttributes part and stays valid
+// while its recorded epoch matches WORLD.attributes_epoch, so repeated
+// lookups (every attack roll in a fight) are one array read; the
+// hierarchy walk only reruns after an attribute or equipment change
+Attributes attributes_effective(EntityIndex entity) {
+  if (HAS_PART(EffectiveAttributes, entity) &&
+      PART(EffectiveAttributes, entity).epoch == WORLD.attributes_epoch) {
+    return PART(EffectiveAttributes, entity).attr;
+  }
+
+  Attributes attr = {0};
+  if (HAS_PART(Attributes, entity)) {
+    attr = PART(Attributes, entity);
+
+    // a heavily laden entity's tree can spill the set into the arena
+    ArenaCheckpoint checkpoint = arena_checkpoint(&WORLD.frame_arena);
+    EntitySet tree = {0};
+    entityset_add(&tree, entity);
+    entityset_expand_descendants(&tree);
+
+    ENTITYSET_QUERY(i, &tree, HAS(AttributesModifier)) {
+      if (get_attributes_ancestor(i) == entity) {
+        attr.str =
+            clamp_int(attr.str + PART(AttributesModifier, i).str, 0, STR_MAX);
+        attr.dex =
+            clamp_int(attr.dex + PART(AttributesModifier, i).dex, 0, DEX_MAX);
+        attr.wil =
+            clamp_int(attr.wil + PART(AttributesModifier, i).wil, 0, WIL_MAX);
+        attr.con =
+            clamp_int(attr.con + PART(AttributesModifier, i).con, 0, CON_MAX);
+      }
+    }
+    arena_restore(&WORLD.frame_arena, checkpoint);
+  } else {
+    attr.str = STR_DEFAULT;
+    attr.dex = DEX_DEFAULT;
+    attr.wil = WIL_DEFAULT;
+    attr.con = CON_DEFAULT;
+  }
+
+  ADD_PART(EffectiveAttributes, entity,
+           ((EffectiveAttributes){.attr = attr,
+                                  .epoch = WORLD.attributes_epoch}));
+  return attr;
+}
+
 void entity_pack(EntityIndex entity, ByteBuffer *buf) {
   on_entity_pack(entity);
 
+  // gather the part-presence header first, then write it varint-encoded
+  // (most entities only use low part bits, so a word packs in 1-2 bytes)
   PartBitset part_bitset = {0};
-  uint8_t *part_bitset_ptr = buf->data + buf->size;
-
-  // initially write empty bitset to buffer
-  bbuf_pack_bytes(buf, &part_bitset, sizeof(part_bitset), "part_bitset");
 
-#define DO_PACK_MARK(name)                                                     \
+#define DO_BITSET_MARK(name)                                                   \
   if (HAS_PART(name, entity)) {                                                \
     part_bitset_add(&part_bitset, PART_TYPE_##name);                           \
   }
+#define DO_BITSET_PART(name, type) DO_BITSET_MARK(name)
+
+  FOREACH_MARK(DO_BITSET_MARK)
+  FOREACH_PART(DO_BITSET_PART)
+
+#undef DO_BITSET_MARK
+#undef DO_BITSET_PART
+
+  for (int w = 0; w < PART_BITSET_WORDS; w++) {
+    bbuf_pack_varint(buf, part_bitset.words[w], "part_bitset");
+  }
 
 #define DO_PACK_PART(name, type)                                               \
   if (HAS_PART(name, entity)) {                                                \
-    part_bitset_add(&part_bitset, PART_TYPE_##name);                           \
     bbuf_pack_bytes(buf, &PART(name, entity), sizeof(PART(name, entity)),      \
                     "part_" #name);                                            \
   }
 
-  FOREACH_MARK(DO_PACK_MARK)
   FOREACH_PART(DO_PACK_PART)
 
-#undef DO_SET_MARK_BIT
 #undef DO_PACK_PART
 
   assert(buf->size <= buf->capacity);
-
-  // go back and overwrite empty bitset in buffer
-  memcpy(part_bitset_ptr, &part_bitset, sizeof(part_bitset));
 }
 
 EntityIndex entity_unpack(ByteBuffer *buf) {
   EntityIndex entity = entity_alloc();
 
   PartBitset part_bitset;
-  bbuf_unpack_bytes(buf, &part_bitset, sizeof(part_bitset), "part_bitset");
+  for (int w = 0; w < PART_BITSET_WORDS; w++) {
+    part_bitset.words[w] = bbuf_unpack_varint(buf, "part_bitset");
+  }
 
 #define DU_UNPACK_MARK(name)                                                   \
   if (part_bitset_test(&part_bitset, PART_TYPE_##name)) {                      \
@@ -215,7 +740,7 @@ EntityIndex entity_unpack(ByteBuffer *buf) {
   FOREACH_MARK(DU_UNPACK_MARK)
   FOREACH_PART(DU_UNPACK_PART)
 
-#undef DO_SET_MARK_BIT
+#undef DU_UNPACK_MARK
 #undef DU_UNPACK_PART
 
   on_entity_unpacked(entity);
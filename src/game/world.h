@@ -1,32 +1,51 @@
 #pragma once
 
 #include "ai/ai.h"
+#include "ai/flowfield.h"
+#include "ai/hpastar.h"
+#include "autosave.h"
 #include "common.h"
+#include "flood.h"
+#include "fov.h"
+#include "lighting.h"
 #include "map.h"
+#include "mapgen/mapgen.h"
 #include "particles.h"
 #include "parts.h"
+#include "profile.h"
+#include "replay.h"
 #include "turn_queue.h"
 #include "utils/arena.h"
 #include "utils/bbuf.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
 #define TURN_INTERVAL 100
 
 // ============================================================================
 // Visible message log
 // ============================================================================
 
+// Message text lives in a byte ring of NUL-terminated variable-length
+// records, indexed by a ring of start offsets. A typical message is
+// ~30 characters, so this retains a couple thousand of them where the
+// old layout held 100 fixed 512-byte slots in more memory. Offsets are
+// virtual (monotonically increasing, masked on access), so age checks
+// are plain subtractions.
 #define MESSAGE_LENGTH_MAX 511
-#define MESSAGE_COUNT_MAX 100
-
-typedef struct {
-  int length;
-  char text[MESSAGE_LENGTH_MAX + 1];
-} Message;
+#define MESSAGE_COUNT_MAX 2048        // index entries (power of two)
+#define MESSAGE_TEXT_SIZE (32 * 1024) // text ring bytes (power of two)
 
 typedef struct {
-  uint32_t first;
+  uint32_t first;     // virtual index of the oldest retained message
   uint32_t count;
-  Message buffer[MESSAGE_COUNT_MAX];
+  uint32_t text_head; // virtual offset of the next free text byte
+  uint32_t offsets[MESSAGE_COUNT_MAX]; // per-message start in text[]
+  char text[MESSAGE_TEXT_SIZE];
 } MessageState;
 
 // ============================================================================
@@ -54,6 +73,71 @@ typedef struct {
   };
 } ActionAnim;
 
+// ============================================================================
+// Render snapshot (double-buffered)
+// ============================================================================
+
+// Compact copy of everything game_render reads that simulation mutates
+// every frame: entity sprites, animation interpolation inputs, the
+// particle slice and the message tail. game_frame captures into the
+// back buffer and flips, game_render only reads the front, so a host
+// may run geometry build + execute_render_commands for frame N on
+// another thread while game_frame computes N+1. The map planes (cells,
+// water, light, ghosts) and the debug overlays are exempt: they read
+// live state, which only moves on turn/tick boundaries.
+#define SNAPSHOT_MESSAGE_LINES 10
+
+typedef struct {
+  EntityIndex entity; // for matching anim.actor
+  Position pos;
+  uint16_t tile; // atlas tile index
+} SnapshotSprite;
+
+typedef struct {
+  float x, y;   // tile coordinates
+  uint8_t type; // ParticleType
+  uint8_t fade; // remaining ttl fraction (0..255) for age-based alpha
+} SnapshotParticle;
+
+typedef struct {
+  EntityIndex player; // for camera tracking (0 when position-less)
+  Position player_pos;
+
+  ActionAnim anim;
+  Position attack_target_pos; // resolved, so render needs no part reads
+  bool attack_target_valid;
+
+  uint32_t sprite_count;
+  SnapshotSprite sprites[MAX_ENTITIES];
+
+  float particles_time; // drives torch flicker
+  uint32_t particle_count;
+  SnapshotParticle particles[MAX_PARTICLES];
+
+  uint32_t message_count;
+  char messages[SNAPSHOT_MESSAGE_LINES][MESSAGE_LENGTH_MAX + 1];
+
+  float fps;
+} RenderSnapshot;
+
+// Remembered-entity ghosts: for every tile the plane holds the sprite
+// last seen there while the tile was in FOV (atlas tile + 1, 0 = none).
+// render_snapshot_capture keeps the visible region synced to the live
+// entities and leaves non-visible cells frozen, so the ghost layer can
+// draw what the player remembers on explored-but-dark tiles. counter
+// keys the cached render layer; it only moves when the drawn content
+// can change, i.e. when the visible plane shifts or the window scrolls
+// (ghost writes under FOV don't render until the tile goes dark).
+// Derived presentation state like Map.light: never serialized, dropped
+// wholesale when the chunk window moves (map_stamp)
+typedef struct {
+  uint16_t tiles[MAP_WIDTH_MAX * MAP_HEIGHT_MAX];
+  uint32_t counter;
+  uint64_t prev_visible[MAP_BITSET_WORDS];
+  uint32_t map_stamp;
+  bool map_stamp_valid;
+} GhostsState;
+
 // ============================================================================
 // Entities state
 // ============================================================================
@@ -72,6 +156,54 @@ typedef struct {
   EntityHandle player;
 } EntitiesState;
 
+// ============================================================================
+// Cached queries
+// ============================================================================
+
+#define QUERY_CACHE_MAX 16
+
+// Materialized result of a part-bit query: a dense index list kept up to date
+// incrementally as ENABLE_PART/DISABLE_PART flip bits, so hot per-frame
+// queries become a dense array walk instead of a full bitset scan
+typedef struct {
+  PartBitset include; // parts an entity must have to match
+  PartBitset exclude; // parts an entity must not have to match
+  // stores matching entities both by setting their bit in the bit set, and by
+  // adding the index to the entities array (same redundancy as EntitySet)
+  uint32_t count;
+  uint64_t bitset[ENTITY_BITSET_WORDS];
+  EntityIndex entities[MAX_ENTITIES];
+} CachedQuery;
+
+typedef struct {
+  uint32_t count;
+  CachedQuery queries[QUERY_CACHE_MAX];
+} QueryCacheState;
+
+// ============================================================================
+// Spatial index (tile -> entities)
+// ============================================================================
+
+// Intrusive singly-linked lists of entities per map tile, so "what stands
+// on (x,y)" is O(entities on that tile) instead of a scan over all
+// entities with Position
+typedef struct {
+  EntityIndex head[MAP_WIDTH_MAX * MAP_HEIGHT_MAX]; // 0 = empty tile
+  EntityIndex next[MAX_ENTITIES]; // next entity on the same tile
+} SpatialIndex;
+
+// ============================================================================
+// Hierarchy index
+// ============================================================================
+
+// Intrusive first-child/next-sibling lists mirroring the Parent part, so
+// finding an entity's children is O(children) instead of a scan over all
+// entities with Parent
+typedef struct {
+  EntityIndex first_child[MAX_ENTITIES];  // 0 = no children
+  EntityIndex next_sibling[MAX_ENTITIES]; // next child of the same parent
+} HierarchyIndex;
+
 // ============================================================================
 // World state
 // ============================================================================
@@ -79,41 +211,107 @@ typedef struct {
 typedef struct {
   EntitiesState entities;
   PartsState parts;
+  QueryCacheState query_cache;
+  SpatialIndex spatial;
+  HierarchyIndex hierarchy;
+  HPAState hpa;
+  FlowField flowfield;
+  FovCache fov_cache;
+  RegionLabels regions;
+  LightingState lighting;
+
+  // Moves chosen by the parallel NPC decide phase, consumed serially in
+  // turn order. Stored as direction + 1 so zero means "undecided"
+  // (see npc_decide_phase in game.c)
+  uint8_t npc_plan[MAX_ENTITIES];
   AIState ai;
   MessageState messages;
   TurnQueue turn_queue;
   ParticlesState particles;
   ActionAnim anim;
+
+  // Double-buffered render snapshot: game_frame fills the back buffer
+  // and flips snapshot_front; game_render only reads the front
+  RenderSnapshot snapshot[2];
+  uint32_t snapshot_front;
+  GhostsState ghosts;
+
   Map map;
   WorldMap worldmap;
+  AutosaveState autosave;
+
+  // In-progress sliced chunk generation, driven by map_generate_pending:
+  // the CSP task refines into gen_scratch across frames and the finished
+  // baseline is copied into the window (see map.c)
+  CSPGenTask gen_task;
+  Map gen_scratch;
+  bool gen_task_active;
+  int gen_world_chunk_idx;
+
+  // Recently generated chunk baselines, so paging doesn't re-solve them
+  BaselineCache baseline_cache;
 
   InputCommand next_player_input; // Next input to execute for player
 
+  // Out-of-band frame damage sources (input, messages, map changes) set
+  // this; game_frame folds it into its return value and clears it. When
+  // no damage source fires the hosts skip the redraw entirely
+  bool frame_damage;
+
   uint64_t rng_state;
+  uint64_t world_seed; // never advanced; keys deterministic chunk generation
+
+  // Epoch for the EffectiveAttributes cache: bumped whenever Attributes,
+  // AttributesModifier, Parent or IsEquipped changes anywhere (see
+  // query_cache_on_part_changed), so cached entries expire in O(1)
+  uint32_t attributes_epoch;
 
   // state for tracking ticks (which happen at 10Hz and is used for some real
   // time scheduling porposes)
   double tick_accumulator;
   uint64_t tick_counter;
 
+  // entities_compact runs so far (fragmentation health; see bench_stress)
+  uint32_t compact_counter;
+
   // FPS tracking
   double frame_time_accumulator;
   uint32_t frame_count;
   float fps;
 
+  // Per-phase frame timing (see profile.h)
+  ProfileState profile;
+
+  // Input session recording / replay (see replay.h)
+  ReplayState replay;
+
   // Debug flags
   bool debug_show_light_values;
-
-  // Arena allocator with 4MB scratch buffer
-  uint8_t arena_buffer[4 * 1024 * 1024];
-  Arena arena;
+  bool debug_show_part_stats;
+  bool debug_show_profile;
+
+  // Scratch arenas. The backing stores are NOT part of this struct: they
+  // live in host memory past the end of WorldState (game_get_memory_size
+  // reserves them, game_set_memory binds the pointers), so world copies
+  // and hot-reload handoff move only hot state, not cold scratch bytes.
+  // frame_arena serves within-frame allocations (pathfinding, flood
+  // fill, decide batches, entity sets); turn_arena serves the big
+  // serialize/compress buffers used by chunk paging and autosave. Both
+  // track high_water for sizing.
+  Arena frame_arena;
+  Arena turn_arena;
 } WorldState;
 
+#define FRAME_ARENA_SIZE (4 * 1024 * 1024)
+#define TURN_ARENA_SIZE (4 * 1024 * 1024)
+
 extern WorldState *active_world;
 #define WORLD (*active_world)
 #define ENTITIES WORLD.entities
 #define PART(part, entity) WORLD.parts.part[entity]
 #define MAP(x, y) WORLD.map.cells[(y) * MAP_WIDTH_MAX + (x)]
+#define MAP_PASSABLE(x, y) map_is_passable(&WORLD.map, (x), (y))
+#define MAP_VISIBLE(x, y) map_is_visible(&WORLD.map, (x), (y))
 
 // query all world entities using BITS with part names to form a bitwise
 // expression on bitset words
@@ -147,15 +345,100 @@ static inline void bitset_copy(uint64_t *dst, const uint64_t *src) {
   memcpy(dst, src, ENTITY_BITSET_WORDS * sizeof(uint64_t));
 }
 
+// Whole-bitset combine kernels. When built with SIMD=avx2 (native) or
+// in the game-simd.wasm module (-msimd128, selected by game.js at load
+// time) these process several words per instruction; otherwise a plain
+// scalar loop is used. Combine part bitsets into a scratch bitset with
+// these, then walk it with BITSET_QUERY
+
+#if defined(__AVX2__)
+
+static inline void bitset_and(uint64_t *dst, const uint64_t *a,
+                              const uint64_t *b) {
+  for (int w = 0; w < ENTITY_BITSET_WORDS; w += 4) {
+    __m256i va = _mm256_loadu_si256((const __m256i *)(a + w));
+    __m256i vb = _mm256_loadu_si256((const __m256i *)(b + w));
+    _mm256_storeu_si256((__m256i *)(dst + w), _mm256_and_si256(va, vb));
+  }
+}
+
+static inline void bitset_andnot(uint64_t *dst, const uint64_t *a,
+                                 const uint64_t *b) {
+  for (int w = 0; w < ENTITY_BITSET_WORDS; w += 4) {
+    __m256i va = _mm256_loadu_si256((const __m256i *)(a + w));
+    __m256i vb = _mm256_loadu_si256((const __m256i *)(b + w));
+    // andnot computes ~first & second, so pass b first for a & ~b
+    _mm256_storeu_si256((__m256i *)(dst + w), _mm256_andnot_si256(vb, va));
+  }
+}
+
+#elif defined(__wasm_simd128__)
+
+static inline void bitset_and(uint64_t *dst, const uint64_t *a,
+                              const uint64_t *b) {
+  for (int w = 0; w < ENTITY_BITSET_WORDS; w += 2) {
+    v128_t va = wasm_v128_load(a + w);
+    v128_t vb = wasm_v128_load(b + w);
+    wasm_v128_store(dst + w, wasm_v128_and(va, vb));
+  }
+}
+
+static inline void bitset_andnot(uint64_t *dst, const uint64_t *a,
+                                 const uint64_t *b) {
+  for (int w = 0; w < ENTITY_BITSET_WORDS; w += 2) {
+    v128_t va = wasm_v128_load(a + w);
+    v128_t vb = wasm_v128_load(b + w);
+    wasm_v128_store(dst + w, wasm_v128_andnot(va, vb));
+  }
+}
+
+#else
+
+static inline void bitset_and(uint64_t *dst, const uint64_t *a,
+                              const uint64_t *b) {
+  for (int w = 0; w < ENTITY_BITSET_WORDS; w++) {
+    dst[w] = a[w] & b[w];
+  }
+}
+
+static inline void bitset_andnot(uint64_t *dst, const uint64_t *a,
+                                 const uint64_t *b) {
+  for (int w = 0; w < ENTITY_BITSET_WORDS; w++) {
+    dst[w] = a[w] & ~b[w];
+  }
+}
+
+#endif
+
+// walk all set bits of a pre-combined bitset (same ctzll walk as
+// WORLD_QUERY, but over a scratch result instead of an inline expression)
+#define BITSET_QUERY(index_var, bits)                                          \
+  for (uint32_t index_var, _word_idx = 0, _word_idx_max = ENTITIES.count / 64; \
+       _word_idx <= _word_idx_max; _word_idx++)                                \
+    for (uint64_t _word = (bits)[_word_idx];                                   \
+         _word && (index_var = _word_idx * 64 + __builtin_ctzll(_word), 1);    \
+         _word &= _word - 1)
+
 // ============================================================================
 // Part management utils
 // ============================================================================
 
+// notify cached queries that a part bit was flipped for an entity
+void query_cache_on_part_changed(PartType type, EntityIndex entity);
+
 #define ENABLE_PART(part, entity_idx)                                          \
-  bitset_set(WORLD.parts.part##Bitset, entity_idx)
+  do {                                                                         \
+    uint32_t _enable_idx = entity_idx;                                         \
+    bitset_set(WORLD.parts.part##Bitset, _enable_idx);                         \
+    query_cache_on_part_changed(PART_TYPE_##part, _enable_idx);                \
+  } while (0)
 
 #define DISABLE_PART(part, entity_idx)                                         \
-  bitset_clear(WORLD.parts.part##Bitset, entity_idx)
+  do {                                                                         \
+    uint32_t _disable_idx = entity_idx;                                        \
+    bitset_clear(WORLD.parts.part##Bitset, _disable_idx);                      \
+    query_cache_on_part_changed(PART_TYPE_##part, _disable_idx);               \
+  } while (0)
 
 #define HAS_PART(part, entity_idx)                                             \
   bitset_test(WORLD.parts.part##Bitset, entity_idx)
@@ -164,6 +447,7 @@ static inline void bitset_copy(uint64_t *dst, const uint64_t *src) {
   do {                                                                         \
     uint32_t index = entity_idx;                                               \
     ENABLE_PART(part, index);                                                  \
+    bitset_set(WORLD.parts.part##DirtyBitset, index);                          \
     PART(part, index) = value;                                                 \
   } while (0)
 
@@ -171,9 +455,134 @@ static inline void bitset_copy(uint64_t *dst, const uint64_t *src) {
   do {                                                                         \
     uint32_t index = entity_idx;                                               \
     DISABLE_PART(part, index);                                                 \
+    bitset_set(WORLD.parts.part##DirtyBitset, index);                          \
     memset(&PART(part, index), 0, sizeof(PART(part, index)));                  \
   } while (0)
 
+// ============================================================================
+// Dirty tracking
+// ============================================================================
+
+// mutable part access: like PART but also flags the entity in the part's
+// DirtyBitset, so incremental systems (rendering, autosave) can pick up
+// in-place modifications. read-only access should keep using PART
+#define DO_DECLARE_PART_MUT(name, type)                                        \
+  static inline type *name##_mut(EntityIndex entity) {                         \
+    bitset_set(WORLD.parts.name##DirtyBitset, entity);                         \
+    return &WORLD.parts.name[entity];                                          \
+  }
+FOREACH_PART(DO_DECLARE_PART_MUT)
+#undef DO_DECLARE_PART_MUT
+
+#define PART_MUT(part, entity) (*part##_mut(entity))
+
+// per-word dirty bitset access for WORLD_QUERY expressions, e.g.
+// WORLD_QUERY(i, DIRTY_BITS(Position) & BITS(Health))
+#define DIRTY_BITS(part) WORLD.parts.part##DirtyBitset[_word_idx]
+
+#define IS_PART_DIRTY(part, entity_idx)                                        \
+  bitset_test(WORLD.parts.part##DirtyBitset, entity_idx)
+
+// clear all part dirty bitsets (called once at the start of each frame)
+void parts_clear_dirty(void);
+
+// true if any part of any entity was modified since parts_clear_dirty()
+// (used by frame damage tracking to decide whether a redraw is needed)
+bool parts_any_dirty(void);
+
+// ============================================================================
+// Parts memory accounting (debug)
+// ============================================================================
+
+// per-part population and traffic numbers for deciding hot/cold layout
+typedef struct {
+  const char *name;
+  uint32_t population; // entities that have the part
+  uint32_t dirty;      // entities flagged dirty so far this frame
+  uint32_t elem_size;  // sizeof the part's data type (0 for marks)
+} PartStats;
+
+// fill stats (one entry per mark and part, PART_TYPE_MAX total) and
+// return the entry count
+uint32_t parts_debug_stats(PartStats *stats);
+
+// log a per-part memory accounting report via host_log
+void parts_debug_dump(void);
+
+// ============================================================================
+// Cached query access
+// ============================================================================
+
+// get (or lazily register and build) the cached query for the given
+// include/exclude part masks. the returned pointer stays valid and the
+// list stays current as parts are added/removed, so call sites can just
+// re-fetch it every frame
+CachedQuery *query_cache_get(PartBitset include, PartBitset exclude);
+
+// convenience for the common "all entities with this one part" case
+static inline CachedQuery *query_cache_get1(PartType included) {
+  PartBitset include = {0};
+  PartBitset exclude = {0};
+  part_bitset_add(&include, included);
+  return query_cache_get(include, exclude);
+}
+
+// iterate the dense index list of a CachedQuery
+// example: CACHED_QUERY(i, positions) { ... }
+#define CACHED_QUERY(index_var, query)                                         \
+  for (uint32_t _i = 0, index_var;                                             \
+       _i < (query)->count && (index_var = (query)->entities[_i], 1); _i++)
+
+// ============================================================================
+// Spatial index access
+// ============================================================================
+
+// link entity into the tile list at its current Position (must have one)
+void spatial_index_insert(EntityIndex entity);
+
+// unlink entity from the tile list at its current Position. call this
+// BEFORE clearing or changing the Position part
+void spatial_index_remove(EntityIndex entity);
+
+// change an entity's Position and keep the spatial index in sync
+void spatial_index_move(EntityIndex entity, Position to);
+
+// rebuild the whole index from the Position part (used after bulk position
+// changes like window shifts and compaction)
+void spatial_index_rebuild(void);
+
+// first entity on tile (x, y), or 0 if the tile is empty
+static inline EntityIndex entities_at(int x, int y) {
+  return WORLD.spatial.head[y * MAP_WIDTH_MAX + x];
+}
+
+// iterate all entities standing on tile (x, y)
+// example: TILE_ENTITIES_QUERY(i, x, y) { ... }
+#define TILE_ENTITIES_QUERY(index_var, x, y)                                   \
+  for (EntityIndex index_var = entities_at(x, y); index_var;                   \
+       index_var = WORLD.spatial.next[index_var])
+
+// ============================================================================
+// Hierarchy index access
+// ============================================================================
+
+// set (or change) an entity's Parent part and keep the child links in sync.
+// always use this instead of adding the Parent part directly
+void hierarchy_set_parent(EntityIndex entity, EntityIndex parent);
+
+// clear an entity's Parent part and unlink it from its parent's child list
+void hierarchy_remove_parent(EntityIndex entity);
+
+// rebuild all child links from the Parent part (used after bulk index
+// changes like chunk deserialization and compaction)
+void hierarchy_rebuild(void);
+
+// iterate the direct children of an entity
+// example: CHILDREN_QUERY(child, parent) { ... }
+#define CHILDREN_QUERY(index_var, parent)                                      \
+  for (EntityIndex index_var = WORLD.hierarchy.first_child[parent]; index_var; \
+       index_var = WORLD.hierarchy.next_sibling[index_var])
+
 // ============================================================================
 // EntityHandle
 // ============================================================================
@@ -197,15 +606,41 @@ static inline EntityHandle entity_handle_from_index(EntityIndex index) {
 // EntitySet
 // ============================================================================
 
+// number of entities an EntitySet can hold without spilling to the arena
+#define ENTITYSET_INLINE_MAX 16
+
 typedef struct {
-  // stores added entities both by setting their bit in the bit set, and by
-  // adding the index to the entities array. the redundancy makes both testing
-  // membership and iterating fast
+  // small sets (the common case: one combatant plus its equipment and
+  // inventory) live entirely in the inline array, keeping stack-allocated
+  // sets a few dozen bytes instead of kilobytes. sets that outgrow it
+  // promote to a frame-arena-backed representation that stores entities
+  // both by setting their bit in the bitset and by appending to the dense
+  // array (the redundancy makes both membership tests and iteration fast).
+  // callers whose sets can outgrow the inline storage must bracket the
+  // set's lifetime with an arena checkpoint/restore
   uint32_t count;
-  uint64_t bitset[ENTITY_BITSET_WORDS];
-  EntityIndex entities[MAX_ENTITIES];
+  uint64_t *bitset;      // NULL while the set is inline
+  EntityIndex *entities; // NULL while the set is inline
+  EntityIndex inline_entities[ENTITYSET_INLINE_MAX];
 } EntitySet;
 
+static inline bool entityset_contains(const EntitySet *set, EntityIndex index) {
+  if (set->bitset) {
+    return bitset_test(set->bitset, index);
+  }
+  for (uint32_t i = 0; i < set->count; i++) {
+    if (set->inline_entities[i] == index) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static inline EntityIndex entityset_get(const EntitySet *set, uint32_t i) {
+  assert(i < set->count);
+  return set->bitset ? set->entities[i] : set->inline_entities[i];
+}
+
 // add an entity to the set (unless already added)
 void entityset_add(EntitySet *set, EntityIndex index);
 
@@ -221,7 +656,7 @@ void entityset_free(EntitySet *to_free);
 #define ENTITYSET_QUERY(index_var, set, ...)                                   \
   for (uint32_t _i = 0, index_var, _entity_idx;                                \
        _i < (set)->count &&                                                    \
-       (index_var = _entity_idx = (set)->entities[_i], 1);                     \
+       (index_var = _entity_idx = entityset_get(set, _i), 1);                  \
        _i++)                                                                   \
     if (__VA_ARGS__)
 
@@ -234,6 +669,41 @@ void entityset_free(EntitySet *to_free);
 EntityIndex entity_alloc(void);
 void entity_free(EntityIndex index);
 
+// a contiguous range of freshly reserved entity indices
+typedef struct {
+  EntityIndex first;
+  uint16_t count;
+} EntityBatch;
+
+// reserve count contiguous indices from the tail of the entity array
+// (bypassing the freelist). fill the part arrays directly via PART, then
+// flip each part's bits for the whole range with ENTITY_BATCH_ENABLE_PART,
+// which streams range masks into the bitset words instead of touching
+// them once per entity
+EntityBatch entity_batch_alloc(uint16_t count);
+
+// enable one part for every entity in the batch: the part and dirty
+// bitsets are filled with word-granular range masks in one pass, then
+// cached queries are brought up to date
+void entity_batch_enable(uint64_t *bitset, uint64_t *dirty_bitset,
+                         PartType type, EntityBatch batch);
+
+#define ENTITY_BATCH_ENABLE_PART(part, batch)                                  \
+  entity_batch_enable(WORLD.parts.part##Bitset,                                \
+                      WORLD.parts.part##DirtyBitset, PART_TYPE_##part, batch)
+
+#define ENTITY_BATCH_ENABLE_MARK(mark, batch)                                  \
+  entity_batch_enable(WORLD.parts.mark##Bitset, NULL, PART_TYPE_##mark, batch)
+
+// remap live entities to the low index range so bitset scans and part
+// iteration only touch the actual live population. fixes up generations,
+// Parent links, turn queue handles, goal targets and cached queries, and
+// resets index-keyed side state (NPC plans, the lighting diff snapshot,
+// the autosave delta chain). only safe to run between turns (no
+// animation or iteration in flight); process_turn_entity triggers it
+// when enough slots have fragmented
+void entities_compact(void);
+
 void entity_pack(EntityIndex entity, ByteBuffer *buf);
 EntityIndex entity_unpack(ByteBuffer *buf);
 
@@ -241,3 +711,7 @@ bool entity_is_player(EntityIndex index);
 bool entity_is_alive(EntityHandle index);
 EntityIndex get_position_ancestor(EntityIndex entity);
 EntityIndex get_attributes_ancestor(EntityIndex entity);
+
+// cached effective attributes (base plus subtree modifiers); one array
+// read when the cache is warm, full hierarchy walk otherwise
+Attributes attributes_effective(EntityIndex entity);
@@ -33,9 +33,22 @@
 // NOTE(robin): This file has been changed slightly to avoid global static crc
 // state, to use uint32_t instead of unsigned long, and to rename crc32_value()
 // to crc32_finalize()
+//
+// crc32_update has since been rewritten around a slice-by-8 kernel (the
+// extra tables are derived from the original table below at first use),
+// with a runtime-dispatched PCLMULQDQ folding path on x86 for long
+// buffers. Both produce bit-identical results to the original
+// byte-at-a-time loop, so existing files stay compatible
 
 #include "crc32.h"
+#include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CRC32_HAVE_PCLMUL 1
+#include <immintrin.h>
+#endif
 
 #define CRC_INIT 0xFFFFFFFF
 #define XOROUT 0xFFFFFFFF
@@ -118,6 +131,134 @@ static uint32_t crctable[256] = {
  *********************************************************************/
 uint32_t crc32_init(void) { return CRC_INIT; }
 
+// Slice-by-8 tables: crctable8[t][i] advances a CRC whose next input
+// byte is i by t+1 zero bytes, letting the update loop consume 8 bytes
+// per iteration with 8 independent table lookups. Derived from the
+// original table on first use (idempotent, so a racing rebuild from a
+// second thread just rewrites the same values)
+static uint32_t crctable8[8][256];
+static bool crctable8_ready;
+
+static void build_slice_tables(void) {
+  for (int i = 0; i < 256; i++) {
+    uint32_t crc = crctable[i];
+    crctable8[0][i] = crc;
+    for (int t = 1; t < 8; t++) {
+      crc = crctable[crc & 0xFFL] ^ (crc >> 8);
+      crctable8[t][i] = crc;
+    }
+  }
+  crctable8_ready = true;
+}
+
+#ifdef CRC32_HAVE_PCLMUL
+
+// Carry-less multiplication folding constants for the CRC-32
+// polynomial 0x04C11DB7 (reflected), from the Intel whitepaper "Fast
+// CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction"
+static const uint64_t __attribute__((aligned(16))) fold_k1k2[2] = {
+    0x0154442bd4, 0x01c6e41596};
+static const uint64_t __attribute__((aligned(16))) fold_k3k4[2] = {
+    0x01751997d0, 0x00ccaa009e};
+static const uint64_t __attribute__((aligned(16))) fold_k5k0[2] = {
+    0x0163cd6124, 0x0000000000};
+static const uint64_t __attribute__((aligned(16))) fold_poly[2] = {
+    0x01db710641, 0x01f7011641};
+
+static bool cpu_has_pclmul(void) {
+  static int cached = -1;
+  if (cached < 0) {
+    __builtin_cpu_init();
+    cached = __builtin_cpu_supports("pclmul") &&
+             __builtin_cpu_supports("sse4.1");
+  }
+  return cached != 0;
+}
+
+// Fold 64 bytes at a time through 4 parallel 128-bit accumulators,
+// then reduce to a 32-bit CRC with Barrett reduction. Requires
+// blk_len >= 64 and a multiple of 16; same polynomial and bit order
+// as the table paths
+__attribute__((target("pclmul,sse4.1"))) static uint32_t
+crc32_update_pclmul(uint32_t crc, const uint8_t *ptr, uint32_t blk_len) {
+  __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+  x1 = _mm_loadu_si128((const __m128i *)(ptr + 0x00));
+  x2 = _mm_loadu_si128((const __m128i *)(ptr + 0x10));
+  x3 = _mm_loadu_si128((const __m128i *)(ptr + 0x20));
+  x4 = _mm_loadu_si128((const __m128i *)(ptr + 0x30));
+  x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(crc));
+  x0 = _mm_load_si128((const __m128i *)fold_k1k2);
+  ptr += 0x40;
+  blk_len -= 0x40;
+
+  // Fold 64 bytes per iteration
+  while (blk_len >= 0x40) {
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+    x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+    x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+    x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+    y5 = _mm_loadu_si128((const __m128i *)(ptr + 0x00));
+    y6 = _mm_loadu_si128((const __m128i *)(ptr + 0x10));
+    y7 = _mm_loadu_si128((const __m128i *)(ptr + 0x20));
+    y8 = _mm_loadu_si128((const __m128i *)(ptr + 0x30));
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+    x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+    x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+    x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+    ptr += 0x40;
+    blk_len -= 0x40;
+  }
+
+  // Fold the 4 accumulators into 1
+  x0 = _mm_load_si128((const __m128i *)fold_k3k4);
+  x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+  x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+  x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+  // Fold remaining 16-byte blocks
+  while (blk_len >= 0x10) {
+    x2 = _mm_loadu_si128((const __m128i *)ptr);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    ptr += 0x10;
+    blk_len -= 0x10;
+  }
+
+  // Reduce 128 -> 64 bits
+  x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+  x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+  x1 = _mm_srli_si128(x1, 8);
+  x1 = _mm_xor_si128(x1, x2);
+  x0 = _mm_loadl_epi64((const __m128i *)fold_k5k0);
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_and_si128(x1, x3);
+  x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  // Barrett reduce 64 -> 32 bits
+  x0 = _mm_load_si128((const __m128i *)fold_poly);
+  x2 = _mm_and_si128(x1, x3);
+  x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+  x2 = _mm_and_si128(x2, x3);
+  x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+  return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+
+#endif // CRC32_HAVE_PCLMUL
+
 /*********************************************************************
  * crc32_update:  Update CRC value with a given set of bytes.        *
  * NOTE: this function computes the reflected form CRC. Use it only  *
@@ -125,6 +266,35 @@ uint32_t crc32_init(void) { return CRC_INIT; }
  *********************************************************************/
 uint32_t crc32_update(uint32_t crc, const void *blk_adr, uint32_t blk_len) {
   const uint8_t *ptr = blk_adr;
+
+#ifdef CRC32_HAVE_PCLMUL
+  if (blk_len >= 64 && cpu_has_pclmul()) {
+    uint32_t folded = blk_len & ~(uint32_t)15; // Whole 16-byte blocks
+    crc = crc32_update_pclmul(crc, ptr, folded);
+    ptr += folded;
+    blk_len -= folded;
+  }
+#endif
+
+  if (!crctable8_ready) {
+    build_slice_tables();
+  }
+
+  // Slice-by-8: 8 bytes per iteration (loads assume little-endian,
+  // which covers every host this file builds for)
+  while (blk_len >= 8) {
+    uint32_t lo, hi;
+    memcpy(&lo, ptr, 4);
+    memcpy(&hi, ptr + 4, 4);
+    lo ^= crc;
+    crc = crctable8[7][lo & 0xFF] ^ crctable8[6][(lo >> 8) & 0xFF] ^
+          crctable8[5][(lo >> 16) & 0xFF] ^ crctable8[4][lo >> 24] ^
+          crctable8[3][hi & 0xFF] ^ crctable8[2][(hi >> 8) & 0xFF] ^
+          crctable8[1][(hi >> 16) & 0xFF] ^ crctable8[0][hi >> 24];
+    ptr += 8;
+    blk_len -= 8;
+  }
+
   while (blk_len--) {
     crc = crctable[(crc ^ *ptr++) & 0xFFL] ^ (crc >> 8);
   }
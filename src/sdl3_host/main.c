@@ -4,19 +4,42 @@
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_keycode.h>
 #include <SDL3/SDL_log.h>
+#include <dlfcn.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 static StorageFile save_file;
 static size_t state_memory_size;
 static void *state_memory;
 static uint64_t random_seed;
 
+// The game is split into per-subsystem shared objects so an edit only
+// relinks the module it touches (see the Makefile). Cross-module calls
+// are ordinary C symbols: every module is dlopened with
+// RTLD_LAZY | RTLD_GLOBAL, core first because libgame_ai.so and
+// libgame_mapgen.so bind its data symbols (active_world, the host
+// function pointers) eagerly at load, while function calls in either
+// direction bind lazily on first use. When ANY module changes we close
+// and reopen ALL of them, which discards every lazy binding at once --
+// no module can keep calling into an unloaded library
+static const char *module_paths[] = {
+    "./libgame.so",
+    "./libgame_ai.so",
+    "./libgame_mapgen.so",
+};
+
+#define MODULE_COUNT ((int)SDL_arraysize(module_paths))
+
+typedef struct {
+  void *handle;
+  SDL_Time mtime;
+} GameModule;
+
 typedef struct {
-  void *lib_handle;
-  SDL_Time lib_mtime;
+  GameModule modules[MODULE_COUNT]; // modules[0] is core (exports the API)
 
   GameSetHostFunctionsFn game_set_host_functions;
   GameGetMemorySizeFn game_get_memory_size;
@@ -27,6 +50,8 @@ typedef struct {
   GameRenderFn game_render;
   GameChunkStoredFn game_chunk_stored;
   GameChunkLoadedFn game_chunk_loaded;
+  GameGetReplayFn game_get_replay;
+  GameStartReplayFn game_start_replay;
 } GameAPI;
 
 static GameAPI game_api;
@@ -181,6 +206,10 @@ static InputCommand map_key_to_command(SDL_Keycode key) {
     return INPUT_CMD_PERIOD;
   case SDLK_D:
     return INPUT_CMD_D;
+  case SDLK_P:
+    return INPUT_CMD_P;
+  case SDLK_T:
+    return INPUT_CMD_T;
   default:
     return INPUT_CMD_NONE; // Invalid
   }
@@ -204,87 +233,567 @@ static HOST_LOG_SIG(do_log) {
   }
 }
 
+// Shared static index buffer expanding each 4-vertex quad (TL, TR, BL, BR)
+// into 2 triangles with the pattern {0,1,2, 2,1,3}; filled lazily up to the
+// largest submission seen
+#define MAX_QUAD_VERTICES (64 * 1024)
+static int quad_indices[MAX_QUAD_VERTICES / 4 * 6];
+static int quad_indices_filled; // quads with indices generated so far
+
 static HOST_SUBMIT_GEOMETRY_SIG(do_submit_geometry) {
+  SDL_assert(vertex_count % 4 == 0);
+  SDL_assert(vertex_count <= MAX_QUAD_VERTICES);
+
+  int quad_count = vertex_count / 4;
+  while (quad_indices_filled < quad_count) {
+    int base = quad_indices_filled * 4;
+    int *idx = &quad_indices[quad_indices_filled * 6];
+    idx[0] = base + 0;
+    idx[1] = base + 1;
+    idx[2] = base + 2;
+    idx[3] = base + 2;
+    idx[4] = base + 1;
+    idx[5] = base + 3;
+    quad_indices_filled++;
+  }
+
   // Cast our Vertex format directly to SDL_Vertex
   // They have identical layout by design
   SDL_RenderGeometry(renderer.renderer, renderer.atlas_texture,
-                     (const SDL_Vertex *)vertices, vertex_count, NULL, 0);
+                     (const SDL_Vertex *)vertices, vertex_count, quad_indices,
+                     quad_count * 6);
+}
+
+// Cached rasterizations of static geometry layers. A layer is redrawn
+// into its render-target texture only when the submitted version (or the
+// window size) changes; every other frame costs a single texture blit.
+// Layers overhang the viewport so sub-tile scroll offsets stay covered
+#define RENDER_LAYER_MARGIN 64
+
+typedef struct {
+  SDL_Texture *texture;
+  uint32_t version;
+  bool valid;
+} LayerCache;
+
+static LayerCache layer_cache[RENDER_LAYER_MAX];
+
+static HOST_SUBMIT_LAYER_SIG(do_submit_layer) {
+  SDL_assert(layer_id >= 0 && layer_id < RENDER_LAYER_MAX);
+  LayerCache *layer = &layer_cache[layer_id];
+
+  int want_w = renderer.window_width + RENDER_LAYER_MARGIN;
+  int want_h = renderer.window_height + RENDER_LAYER_MARGIN;
+  float tex_w = 0, tex_h = 0;
+  if (layer->texture) {
+    SDL_GetTextureSize(layer->texture, &tex_w, &tex_h);
+  }
+  if (!layer->texture || (int)tex_w != want_w || (int)tex_h != want_h) {
+    if (layer->texture) {
+      SDL_DestroyTexture(layer->texture);
+    }
+    layer->texture =
+        SDL_CreateTexture(renderer.renderer, SDL_PIXELFORMAT_RGBA32,
+                          SDL_TEXTUREACCESS_TARGET, want_w, want_h);
+    SDL_SetTextureBlendMode(layer->texture, SDL_BLENDMODE_BLEND);
+    SDL_SetTextureScaleMode(layer->texture, SDL_SCALEMODE_NEAREST);
+    layer->valid = false;
+  }
+
+  if (!layer->valid || layer->version != version) {
+    SDL_SetRenderTarget(renderer.renderer, layer->texture);
+    SDL_SetRenderDrawColor(renderer.renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer.renderer);
+    do_submit_geometry(vertices, vertex_count);
+    SDL_SetRenderTarget(renderer.renderer, NULL);
+    layer->version = version;
+    layer->valid = true;
+  }
+
+  SDL_FRect dst = {offset_x, offset_y, (float)want_w, (float)want_h};
+  SDL_RenderTexture(renderer.renderer, layer->texture, NULL, &dst);
+}
+
+// Asynchronous chunk writes: do_store_chunk only enqueues a copy of the
+// record and wakes the flush thread, which drains everything queued into
+// one storage batch (a single commit record and fsync), so the game
+// thread never blocks on disk. Completions are queued back and reported
+// to the game from the main loop. save_mutex guards all save_file
+// access, since the flush thread writes while the game thread may load
+#define STORE_QUEUE_SIZE 64
+
+typedef struct {
+  uint64_t chunk_key;
+  void *data;
+  size_t data_size;
+} StoreRequest;
+
+typedef struct {
+  uint64_t chunk_key;
+  bool ok;
+} StoreResult;
+
+static SDL_Mutex *save_mutex;
+static SDL_Mutex *store_mutex;
+static SDL_Condition *store_cond;
+static SDL_Thread *store_thread;
+static StoreRequest store_queue[STORE_QUEUE_SIZE];
+static int store_queue_head;
+static int store_queue_count;
+static StoreResult store_results[STORE_QUEUE_SIZE * 2];
+static int store_result_count;
+static bool store_thread_quit;
+
+static int store_flush_worker(void *data) {
+  (void)data;
+  StoreRequest batch[STORE_QUEUE_SIZE];
+
+  SDL_LockMutex(store_mutex);
+  for (;;) {
+    while (store_queue_count == 0 && !store_thread_quit) {
+      SDL_WaitCondition(store_cond, store_mutex);
+    }
+    if (store_queue_count == 0) {
+      break; // Quitting and fully drained
+    }
+
+    // Grab everything queued so far as one batch
+    int batch_count = 0;
+    while (store_queue_count > 0) {
+      batch[batch_count++] = store_queue[store_queue_head];
+      store_queue_head = (store_queue_head + 1) % STORE_QUEUE_SIZE;
+      store_queue_count--;
+    }
+    SDL_BroadcastCondition(store_cond); // Wake producers waiting for room
+    SDL_UnlockMutex(store_mutex);
+
+    // One append + one fsync for the whole burst
+    bool ok[STORE_QUEUE_SIZE];
+    SDL_LockMutex(save_mutex);
+    bool batch_open = storage_file_begin_batch(&save_file) == STORAGE_OK;
+    for (int i = 0; i < batch_count; i++) {
+      ok[i] = batch_open &&
+              storage_file_set(&save_file, batch[i].chunk_key, batch[i].data,
+                               batch[i].data_size) == STORAGE_OK;
+    }
+    if (batch_open && storage_file_commit_batch(&save_file) != STORAGE_OK) {
+      // Commit failure rolls the whole batch back
+      for (int i = 0; i < batch_count; i++) {
+        ok[i] = false;
+      }
+    }
+    SDL_UnlockMutex(save_mutex);
+
+    SDL_LockMutex(store_mutex);
+    while (store_result_count + batch_count > (int)SDL_arraysize(store_results)) {
+      SDL_WaitCondition(store_cond, store_mutex); // Wait for a drain
+    }
+    for (int i = 0; i < batch_count; i++) {
+      SDL_free(batch[i].data);
+      store_results[store_result_count++] =
+          (StoreResult){.chunk_key = batch[i].chunk_key, .ok = ok[i]};
+    }
+  }
+  SDL_UnlockMutex(store_mutex);
+  return 0;
+}
+
+// Report finished writes to the game; called from the main loop so
+// game_chunk_stored always runs on the game thread
+static void drain_store_results(void) {
+  if (!store_thread) {
+    return;
+  }
+  StoreResult results[STORE_QUEUE_SIZE * 2];
+  SDL_LockMutex(store_mutex);
+  int count = store_result_count;
+  for (int i = 0; i < count; i++) {
+    results[i] = store_results[i];
+  }
+  store_result_count = 0;
+  SDL_BroadcastCondition(store_cond); // Wake a worker waiting for room
+  SDL_UnlockMutex(store_mutex);
+
+  for (int i = 0; i < count; i++) {
+    game_api.game_chunk_stored(results[i].chunk_key, results[i].ok);
+  }
 }
 
 static HOST_STORE_CHUNK_SIG(do_store_chunk) {
-  bool ok =
-      storage_file_set(&save_file, chunk_key, data, data_size) == STORAGE_OK;
-  game_api.game_chunk_stored(chunk_key, ok);
+  if (!store_thread) {
+    // Flush thread unavailable: write synchronously
+    SDL_LockMutex(save_mutex);
+    bool ok =
+        storage_file_set(&save_file, chunk_key, data, data_size) == STORAGE_OK;
+    SDL_UnlockMutex(save_mutex);
+    game_api.game_chunk_stored(chunk_key, ok);
+    return;
+  }
+
+  void *copy = SDL_malloc(data_size);
+  if (!copy) {
+    game_api.game_chunk_stored(chunk_key, false);
+    return;
+  }
+  SDL_memcpy(copy, data, data_size);
+
+  SDL_LockMutex(store_mutex);
+  while (store_queue_count == STORE_QUEUE_SIZE) {
+    SDL_WaitCondition(store_cond, store_mutex); // Backpressure: queue full
+  }
+  int tail = (store_queue_head + store_queue_count) % STORE_QUEUE_SIZE;
+  store_queue[tail] = (StoreRequest){
+      .chunk_key = chunk_key, .data = copy, .data_size = data_size};
+  store_queue_count++;
+  SDL_BroadcastCondition(store_cond);
+  SDL_UnlockMutex(store_mutex);
+}
+
+// Persistent worker pool behind host_job_submit/host_job_wait (and
+// host_parallel_for, whose slices are just jobs). Workers pull slot
+// indices off a shared ring; a single queue with one mutex is plenty at
+// this job granularity (slices of a frame's work, background mapgen).
+// host_job_wait helps: while its job isn't done it runs queued jobs on
+// the calling thread, so the pool cannot deadlock on a full queue and
+// the game thread contributes a core during parallel-for
+#define JOB_SLOT_COUNT 256
+#define JOB_MAX_WORKERS 16
+
+typedef enum {
+  JOB_SLOT_FREE,
+  JOB_SLOT_QUEUED,
+  JOB_SLOT_RUNNING,
+  JOB_SLOT_DONE,
+} JobSlotState;
+
+typedef struct {
+  JobTask task;
+  void *ctx;
+  JobSlotState state;
+} JobSlot;
+
+static SDL_Mutex *job_mutex;
+static SDL_Condition *job_cond; // signaled on submit, completion and free
+static SDL_Thread *job_threads[JOB_MAX_WORKERS];
+static int job_worker_count;
+static JobSlot job_slots[JOB_SLOT_COUNT];
+static uint32_t job_ring[JOB_SLOT_COUNT]; // queued slot indices
+static int job_ring_head;
+static int job_ring_count;
+static bool job_quit;
+
+// Pop one queued job and run it; job_mutex held on entry and exit
+static void job_run_one_locked(void) {
+  uint32_t slot_index = job_ring[job_ring_head];
+  job_ring_head = (job_ring_head + 1) % JOB_SLOT_COUNT;
+  job_ring_count--;
+  JobSlot *slot = &job_slots[slot_index];
+  slot->state = JOB_SLOT_RUNNING;
+  SDL_UnlockMutex(job_mutex);
+  slot->task(slot->ctx);
+  SDL_LockMutex(job_mutex);
+  slot->state = JOB_SLOT_DONE;
+  SDL_BroadcastCondition(job_cond);
+}
+
+static int job_worker(void *data) {
+  (void)data;
+  SDL_LockMutex(job_mutex);
+  while (!job_quit) {
+    if (job_ring_count > 0) {
+      job_run_one_locked();
+    } else {
+      SDL_WaitCondition(job_cond, job_mutex);
+    }
+  }
+  SDL_UnlockMutex(job_mutex);
+  return 0;
+}
+
+// Handle returned when the pool is unavailable and the job already ran
+// synchronously inside submit
+#define JOB_HANDLE_SYNC UINT32_MAX
+
+static HOST_JOB_SUBMIT_SIG(do_job_submit) {
+  if (job_worker_count == 0) {
+    task(ctx);
+    return JOB_HANDLE_SYNC;
+  }
+
+  SDL_LockMutex(job_mutex);
+  for (;;) {
+    for (uint32_t i = 0; i < JOB_SLOT_COUNT; i++) {
+      if (job_slots[i].state == JOB_SLOT_FREE) {
+        job_slots[i] = (JobSlot){
+            .task = task,
+            .ctx = ctx,
+            .state = JOB_SLOT_QUEUED,
+        };
+        int tail = (job_ring_head + job_ring_count) % JOB_SLOT_COUNT;
+        job_ring[tail] = i;
+        job_ring_count++;
+        SDL_BroadcastCondition(job_cond);
+        SDL_UnlockMutex(job_mutex);
+        return i;
+      }
+    }
+    // All slots taken (submitted but not yet waited); help drain
+    if (job_ring_count > 0) {
+      job_run_one_locked();
+    } else {
+      SDL_WaitCondition(job_cond, job_mutex);
+    }
+  }
+}
+
+static HOST_JOB_WAIT_SIG(do_job_wait) {
+  if (job == JOB_HANDLE_SYNC) {
+    return;
+  }
+  SDL_assert(job < JOB_SLOT_COUNT);
+  SDL_LockMutex(job_mutex);
+  while (job_slots[job].state != JOB_SLOT_DONE) {
+    if (job_ring_count > 0) {
+      job_run_one_locked(); // Help instead of idling (may run our own job)
+    } else {
+      SDL_WaitCondition(job_cond, job_mutex);
+    }
+  }
+  job_slots[job].state = JOB_SLOT_FREE;
+  SDL_BroadcastCondition(job_cond); // Wake a submitter waiting for a slot
+  SDL_UnlockMutex(job_mutex);
+}
+
+static void job_pool_start(void) {
+  job_mutex = SDL_CreateMutex();
+  job_cond = SDL_CreateCondition();
+  if (!job_mutex || !job_cond) {
+    fprintf(stderr, "Job pool unavailable: %s\n", SDL_GetError());
+    return;
+  }
+
+  // Leave one core for the game thread; it helps out during waits anyway
+  int want = SDL_GetNumLogicalCPUCores() - 1;
+  if (want < 1) {
+    want = 1;
+  }
+  if (want > JOB_MAX_WORKERS) {
+    want = JOB_MAX_WORKERS;
+  }
+  for (int t = 0; t < want; t++) {
+    job_threads[job_worker_count] = SDL_CreateThread(job_worker, "job", NULL);
+    if (job_threads[job_worker_count]) {
+      job_worker_count++;
+    }
+  }
+  if (job_worker_count == 0) {
+    fprintf(stderr, "Job pool unavailable: %s\n", SDL_GetError());
+  }
+}
+
+static void job_pool_stop(void) {
+  if (job_worker_count > 0) {
+    SDL_LockMutex(job_mutex);
+    job_quit = true;
+    SDL_BroadcastCondition(job_cond);
+    SDL_UnlockMutex(job_mutex);
+    for (int t = 0; t < job_worker_count; t++) {
+      SDL_WaitThread(job_threads[t], NULL);
+    }
+    job_worker_count = 0;
+  }
+  SDL_DestroyCondition(job_cond);
+  SDL_DestroyMutex(job_mutex);
+}
+
+// Contiguous index slice handed to one pool job
+typedef struct {
+  ParallelForTask task;
+  void *ctx;
+  int begin;
+  int end;
+} ParallelForSlice;
+
+static void parallel_for_job(void *data) {
+  ParallelForSlice *slice = data;
+  for (int i = slice->begin; i < slice->end; i++) {
+    slice->task(i, slice->ctx);
+  }
+}
+
+static HOST_PARALLEL_FOR_SIG(do_parallel_for) {
+  int num_slices = job_worker_count + 1; // Workers plus the calling thread
+  if (num_slices > count) {
+    num_slices = count;
+  }
+
+  // Not worth dispatching for tiny batches
+  if (num_slices <= 1 || count < 32) {
+    for (int i = 0; i < count; i++) {
+      task(i, ctx);
+    }
+    return;
+  }
+
+  ParallelForSlice slices[JOB_MAX_WORKERS + 1];
+  uint32_t jobs[JOB_MAX_WORKERS + 1];
+  for (int t = 0; t < num_slices; t++) {
+    slices[t] = (ParallelForSlice){
+        .task = task,
+        .ctx = ctx,
+        .begin = count * t / num_slices,
+        .end = count * (t + 1) / num_slices,
+    };
+  }
+  for (int t = 1; t < num_slices; t++) {
+    jobs[t] = do_job_submit(parallel_for_job, &slices[t]);
+  }
+  parallel_for_job(&slices[0]); // Calling thread takes the first slice
+  for (int t = 1; t < num_slices; t++) {
+    do_job_wait(jobs[t]);
+  }
+}
+
+static HOST_TIME_US_SIG(do_time_us) {
+  return (double)SDL_GetTicksNS() / 1000.0;
 }
 
 static HOST_LOAD_CHUNK_SIG(do_load_chunk) {
-  uint8_t buffer[1024 * 1024];
-  uint32_t size = sizeof(buffer);
-  if (storage_file_get(&save_file, chunk_key, buffer, &size) != STORAGE_OK) {
+  // Zero-copy read: the game decodes straight from the mapped file
+  // during game_chunk_loaded. The lock is held across the callback so a
+  // concurrent flush (whose compaction can remap) cannot invalidate the
+  // ref while the game is still reading it
+  SDL_LockMutex(save_mutex);
+  const void *data = NULL;
+  uint32_t size = 0;
+  if (storage_file_get_ref(&save_file, chunk_key, &data, &size) != STORAGE_OK) {
     size = 0;
   }
-  game_api.game_chunk_loaded(chunk_key, buffer, size);
+  game_api.game_chunk_loaded(chunk_key, data, size);
+  SDL_UnlockMutex(save_mutex);
 }
 
-// Load or reload the game library
-static bool load_game_api(GameAPI *api, const char *lib_path) {
-  // Get current mtime
-  SDL_PathInfo path_info;
-  if (!SDL_GetPathInfo(lib_path, &path_info)) {
-    fprintf(stderr, "Failed to stat %s: %s\n", lib_path, SDL_GetError());
-    return false;
+// Write the current session's input recording to a file (R key). Replay
+// it later with: ./roguelike --replay <path>
+static void save_replay(const char *path) {
+  const void *data;
+  size_t size = game_api.game_get_replay(&data);
+  if (size == 0) {
+    fprintf(stderr, "No replay recording available\n");
+    return;
   }
+  FILE *f = fopen(path, "wb");
+  if (!f || fwrite(data, 1, size, f) != size) {
+    fprintf(stderr, "Failed to write %s\n", path);
+  } else {
+    printf("Replay saved to %s (%zu bytes)\n", path, size);
+  }
+  if (f) {
+    fclose(f);
+  }
+}
 
-  // Check if we need to reload
-  if (api->lib_handle && path_info.modify_time == api->lib_mtime) {
-    return true; // Already loaded and up to date
+// Load a recording saved by save_replay and hand it to the game, which
+// restarts the world from the recorded seed and re-executes the session
+static void start_replay(const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    fprintf(stderr, "Failed to open %s\n", path);
+    return;
   }
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  void *data = malloc(size);
+  if (fread(data, 1, size, f) == (size_t)size) {
+    game_api.game_start_replay(data, size);
+  } else {
+    fprintf(stderr, "Failed to read %s\n", path);
+  }
+  free(data);
+  fclose(f);
+}
 
-  // Unload old library if present
-  if (api->lib_handle) {
-    printf("Reloading game library...\n");
-    SDL_UnloadObject(api->lib_handle);
-    api->lib_handle = NULL;
+// Unload every game module; reverse order so core (which the other
+// modules bind into) goes away last
+static void unload_game_modules(GameAPI *api) {
+  for (int i = MODULE_COUNT - 1; i >= 0; i--) {
+    if (api->modules[i].handle) {
+      dlclose(api->modules[i].handle);
+      api->modules[i].handle = NULL;
+    }
   }
+}
 
-  // Load the library
-  api->lib_handle = SDL_LoadObject(lib_path);
-  if (!api->lib_handle) {
-    fprintf(stderr, "Failed to load %s: %s\n", lib_path, SDL_GetError());
-    return false;
+static bool load_game_api(GameAPI *api) {
+  // Stat every module; a change in any one of them reloads the whole set
+  SDL_Time mtimes[MODULE_COUNT];
+  bool up_to_date = true;
+  for (int i = 0; i < MODULE_COUNT; i++) {
+    SDL_PathInfo path_info;
+    if (!SDL_GetPathInfo(module_paths[i], &path_info)) {
+      fprintf(stderr, "Failed to stat %s: %s\n", module_paths[i],
+              SDL_GetError());
+      return false;
+    }
+    mtimes[i] = path_info.modify_time;
+    if (!api->modules[i].handle ||
+        api->modules[i].mtime != path_info.modify_time) {
+      up_to_date = false;
+    }
+  }
+  if (up_to_date) {
+    return true; // Already loaded and up to date
   }
 
-  // Load function pointers
-  api->game_set_host_functions = (GameSetHostFunctionsFn)SDL_LoadFunction(
-      api->lib_handle, TOSTRING(GAME_SET_HOST_FUNCTIONS_NAME));
-  api->game_get_memory_size = (GameGetMemorySizeFn)SDL_LoadFunction(
-      api->lib_handle, TOSTRING(GAME_GET_MEMORY_SIZE_NAME));
-  api->game_set_memory = (GameSetMemoryFn)SDL_LoadFunction(
-      api->lib_handle, TOSTRING(GAME_SET_MEMORY_NAME));
-  api->game_init =
-      (GameInitFn)SDL_LoadFunction(api->lib_handle, TOSTRING(GAME_INIT_NAME));
-  api->game_input =
-      (GameInputFn)SDL_LoadFunction(api->lib_handle, TOSTRING(GAME_INPUT_NAME));
-  api->game_frame =
-      (GameFrameFn)SDL_LoadFunction(api->lib_handle, TOSTRING(GAME_FRAME_NAME));
-  api->game_render = (GameRenderFn)SDL_LoadFunction(api->lib_handle,
-                                                    TOSTRING(GAME_RENDER_NAME));
-  api->game_chunk_stored = (GameChunkStoredFn)SDL_LoadFunction(
-      api->lib_handle, TOSTRING(GAME_CHUNK_STORED_NAME));
-  api->game_chunk_loaded = (GameChunkLoadedFn)SDL_LoadFunction(
-      api->lib_handle, TOSTRING(GAME_CHUNK_LOADED_NAME));
+  // Unload old modules if present
+  if (api->modules[0].handle) {
+    printf("Reloading game modules...\n");
+  }
+  unload_game_modules(api);
+
+  // Load all modules, core first (the others resolve its data symbols at
+  // load time; function calls bind lazily once everything is mapped)
+  for (int i = 0; i < MODULE_COUNT; i++) {
+    api->modules[i].handle = dlopen(module_paths[i], RTLD_LAZY | RTLD_GLOBAL);
+    if (!api->modules[i].handle) {
+      fprintf(stderr, "Failed to load %s: %s\n", module_paths[i], dlerror());
+      unload_game_modules(api);
+      return false;
+    }
+    api->modules[i].mtime = mtimes[i];
+  }
+
+  // Load function pointers from the core module
+  void *core = api->modules[0].handle;
+  api->game_set_host_functions = (GameSetHostFunctionsFn)dlsym(
+      core, TOSTRING(GAME_SET_HOST_FUNCTIONS_NAME));
+  api->game_get_memory_size =
+      (GameGetMemorySizeFn)dlsym(core, TOSTRING(GAME_GET_MEMORY_SIZE_NAME));
+  api->game_set_memory =
+      (GameSetMemoryFn)dlsym(core, TOSTRING(GAME_SET_MEMORY_NAME));
+  api->game_init = (GameInitFn)dlsym(core, TOSTRING(GAME_INIT_NAME));
+  api->game_input = (GameInputFn)dlsym(core, TOSTRING(GAME_INPUT_NAME));
+  api->game_frame = (GameFrameFn)dlsym(core, TOSTRING(GAME_FRAME_NAME));
+  api->game_render = (GameRenderFn)dlsym(core, TOSTRING(GAME_RENDER_NAME));
+  api->game_chunk_stored =
+      (GameChunkStoredFn)dlsym(core, TOSTRING(GAME_CHUNK_STORED_NAME));
+  api->game_chunk_loaded =
+      (GameChunkLoadedFn)dlsym(core, TOSTRING(GAME_CHUNK_LOADED_NAME));
+  api->game_get_replay =
+      (GameGetReplayFn)dlsym(core, TOSTRING(GAME_GET_REPLAY_NAME));
+  api->game_start_replay =
+      (GameStartReplayFn)dlsym(core, TOSTRING(GAME_START_REPLAY_NAME));
 
   if (!api->game_init || !api->game_frame || !api->game_render ||
       !api->game_input) {
-    fprintf(stderr, "Failed to load game functions: %s\n", SDL_GetError());
-    SDL_UnloadObject(api->lib_handle);
-    api->lib_handle = NULL;
+    fprintf(stderr, "Failed to load game functions: %s\n", dlerror());
+    unload_game_modules(api);
     return false;
   }
 
-  api->lib_mtime = path_info.modify_time;
-  printf("Game library loaded successfully (mtime: %lld)\n",
-         (long long)api->lib_mtime);
+  printf("Game modules loaded successfully (core mtime: %lld)\n",
+         (long long)api->modules[0].mtime);
 
   bool needs_init = false;
   size_t memory_size = api->game_get_memory_size();
@@ -294,8 +803,10 @@ static bool load_game_api(GameAPI *api, const char *lib_path) {
     needs_init = true;
   }
 
-  game_api.game_set_host_functions(do_log, do_submit_geometry, do_load_chunk,
-                                   do_store_chunk);
+  game_api.game_set_host_functions(do_log, do_submit_geometry, do_submit_layer,
+                                   do_load_chunk, do_store_chunk,
+                                   do_parallel_for, do_job_submit, do_job_wait,
+                                   do_time_us);
   game_api.game_set_memory(state_memory, state_memory_size);
 
   if (needs_init) {
@@ -306,8 +817,10 @@ static bool load_game_api(GameAPI *api, const char *lib_path) {
 }
 
 int main(int argc, char *argv[]) {
-  (void)argc;
-  (void)argv;
+  const char *replay_path = NULL;
+  if (argc > 2 && strcmp(argv[1], "--replay") == 0) {
+    replay_path = argv[2];
+  }
 
   random_seed = SDL_rand_bits();
 
@@ -317,12 +830,31 @@ int main(int argc, char *argv[]) {
     return 1;
   }
 
-  // Load game library
-  const char *lib_path = "./libgame.so";
-  if (!load_game_api(&game_api, lib_path)) {
+  // Start the chunk flush thread; on failure do_store_chunk falls back
+  // to synchronous writes
+  save_mutex = SDL_CreateMutex();
+  store_mutex = SDL_CreateMutex();
+  store_cond = SDL_CreateCondition();
+  if (save_mutex && store_mutex && store_cond) {
+    store_thread = SDL_CreateThread(store_flush_worker, "chunk_flush", NULL);
+  }
+  if (!store_thread) {
+    fprintf(stderr, "Chunk flush thread unavailable: %s\n", SDL_GetError());
+  }
+
+  // Start the job pool; on failure do_job_submit and do_parallel_for
+  // fall back to running everything on the game thread
+  job_pool_start();
+
+  // Load game modules
+  if (!load_game_api(&game_api)) {
     return 1;
   }
 
+  if (replay_path) {
+    start_replay(replay_path);
+  }
+
   renderer = (Renderer){
       .scale = 2, // Default 2x scaling
   };
@@ -333,6 +865,9 @@ int main(int argc, char *argv[]) {
   bool running = true;
   SDL_Event event;
 
+  // Redraw regardless of frame damage (first frame, resize, expose)
+  bool force_redraw = true;
+
   // Timing for frames
   uint64_t last_frame_time = SDL_GetTicksNS();
 
@@ -358,6 +893,11 @@ int main(int argc, char *argv[]) {
                renderer.window_width, renderer.window_height,
                renderer.viewport_tiles_x, renderer.viewport_tiles_y,
                renderer.scale);
+        force_redraw = true;
+        break;
+
+      case SDL_EVENT_WINDOW_EXPOSED:
+        force_redraw = true;
         break;
 
       case SDL_EVENT_KEY_DOWN:
@@ -375,6 +915,13 @@ int main(int argc, char *argv[]) {
           break;
         }
 
+        // Save the session recording with 'R' key (host-side: the game
+        // cannot write files)
+        if (event.key.key == SDLK_R) {
+          save_replay("replay.dat");
+          break;
+        }
+
         // Change scale factor with X key
         if (event.key.key == SDLK_X) {
           renderer.scale++;
@@ -397,34 +944,56 @@ int main(int argc, char *argv[]) {
     }
 
     // Check for hot-reload (every frame)
-    load_game_api(&game_api, lib_path);
+    load_game_api(&game_api);
+
+    // Report chunk writes finished by the flush thread
+    drain_store_results();
 
     // Call game_frame every frame
     double dt = (current_time - last_frame_time) /
                 1000000000.0; // Convert ns to seconds
     last_frame_time = current_time;
-    game_api.game_frame(dt);
+    bool frame_damaged = game_api.game_frame(dt);
 
-    // Render
-    // Clear to black
-    SDL_SetRenderDrawColor(renderer.renderer, 0, 0, 0, 255);
-    SDL_RenderClear(renderer.renderer);
+    // Skip the whole redraw when nothing visible changed; the window keeps
+    // showing the last presented frame
+    if (frame_damaged || force_redraw) {
+      force_redraw = false;
+
+      // Clear to black
+      SDL_SetRenderDrawColor(renderer.renderer, 0, 0, 0, 255);
+      SDL_RenderClear(renderer.renderer);
+
+      // Call game render
+      game_api.game_render(renderer.window_width, renderer.window_height,
+                           renderer.scaled_tile_size, renderer.atlas_width,
+                           renderer.atlas_height);
 
-    // Call game render
-    game_api.game_render(renderer.window_width, renderer.window_height,
-                         renderer.scaled_tile_size, renderer.atlas_width,
-                         renderer.atlas_height);
+      // Present
+      SDL_RenderPresent(renderer.renderer);
+    }
+  }
 
-    // Present
-    SDL_RenderPresent(renderer.renderer);
+  // Flush outstanding chunk writes before closing the save file
+  if (store_thread) {
+    SDL_LockMutex(store_mutex);
+    store_thread_quit = true;
+    SDL_BroadcastCondition(store_cond);
+    SDL_UnlockMutex(store_mutex);
+    SDL_WaitThread(store_thread, NULL);
+    drain_store_results();
+    store_thread = NULL;
   }
+  SDL_DestroyCondition(store_cond);
+  SDL_DestroyMutex(store_mutex);
+  SDL_DestroyMutex(save_mutex);
+
+  job_pool_stop();
 
   storage_file_close(&save_file);
 
   // Cleanup
-  if (game_api.lib_handle) {
-    SDL_UnloadObject(game_api.lib_handle);
-  }
+  unload_game_modules(&game_api);
   shutdown_renderer(&renderer);
   return 0;
 }
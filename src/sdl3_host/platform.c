@@ -8,6 +8,7 @@
 #include <io.h>
 #include <windows.h>
 #else
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 
@@ -61,3 +62,32 @@ int64_t platform_file_size(const char *path) {
   fclose(f);
   return size;
 }
+
+void *platform_mmap_readonly(FILE *f, uint64_t size) {
+#ifdef _WIN32
+  HANDLE h = (HANDLE)_get_osfhandle(_fileno(f));
+  if (h == INVALID_HANDLE_VALUE) {
+    return NULL;
+  }
+  HANDLE mapping = CreateFileMappingA(h, NULL, PAGE_READONLY,
+                                      (DWORD)(size >> 32), (DWORD)size, NULL);
+  if (!mapping) {
+    return NULL;
+  }
+  void *addr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, (SIZE_T)size);
+  CloseHandle(mapping); // The view keeps the mapping object alive
+  return addr;
+#else
+  void *addr = mmap(NULL, size, PROT_READ, MAP_SHARED, fileno(f), 0);
+  return addr == MAP_FAILED ? NULL : addr;
+#endif
+}
+
+void platform_munmap(void *addr, uint64_t size) {
+#ifdef _WIN32
+  (void)size;
+  UnmapViewOfFile(addr);
+#else
+  munmap(addr, size);
+#endif
+}
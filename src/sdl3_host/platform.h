@@ -23,3 +23,11 @@ bool platform_fsync(FILE *f);
 // Opens file, gets size via ftell, closes file
 // Returns file size on success, -1 on failure
 int64_t platform_file_size(const char *path);
+
+// Cross-platform read-only memory mapping
+// Maps the first size bytes of the file into memory
+// Returns mapping address on success, NULL on failure
+void *platform_mmap_readonly(FILE *f, uint64_t size);
+
+// Unmap a mapping created by platform_mmap_readonly
+void platform_munmap(void *addr, uint64_t size);
@@ -9,6 +9,7 @@
 #define STORAGE_MAGIC 0x524C434B // "RLCK"
 #define STORAGE_VERSION 1
 #define FRAGMENTATION_THRESHOLD 0.5f
+#define COMPACT_STEP_BYTES (256 * 1024)
 
 // File header (8 bytes)
 typedef struct {
@@ -133,8 +134,39 @@ static EntryHeader compute_header(uint64_t chunk_key, const void *data,
   return hdr;
 }
 
+// Append a commit record (chunk_key 0) making every record since the
+// previous commit durable once synced; the payload is the byte length
+// of those records
+static bool write_commit_record(FILE *f, uint32_t batch_bytes) {
+  EntryHeader hdr = compute_header(0, &batch_bytes, sizeof(batch_bytes));
+  if (fwrite(&hdr, sizeof(EntryHeader), 1, f) != 1) {
+    return false;
+  }
+  return fwrite(&batch_bytes, sizeof(batch_bytes), 1, f) == 1;
+}
+
+// Roll back an in-progress write batch: truncate its records off the
+// file and discard the pending index updates
+static void batch_rollback(StorageFile *storage) {
+  platform_truncate_file(storage->file, storage->batch_start_offset);
+  storage->in_batch = false;
+  storage->batch_pending_count = 0;
+}
+
+// Drop the memory-mapped read view (recreated lazily by get_ref)
+static void unmap_file(StorageFile *storage) {
+  if (storage->map_base) {
+    platform_munmap(storage->map_base, storage->map_size);
+    storage->map_base = NULL;
+    storage->map_size = 0;
+  }
+}
+
 // Scan file and build index
 static StorageResult scan_file(StorageFile *storage) {
+  // Any existing mapping may refer to a replaced or truncated file
+  unmap_file(storage);
+
   // Clear hash table
   memset(storage->hash_table, 0, sizeof(storage->hash_table));
   storage->useful_bytes = 0;
@@ -163,6 +195,15 @@ static StorageResult scan_file(StorageFile *storage) {
 
   int64_t last_valid_offset = sizeof(FileHeader);
 
+  // Once a commit record has been seen, records are held pending and
+  // only applied when the next commit record arrives; an uncommitted
+  // tail is then discarded by the truncation below. Files written
+  // before commit records existed scan per-entry as before
+  bool batch_mode = false;
+  uint32_t pending_count = 0;
+  uint32_t pending_bytes = 0;
+  StorageHashSlot pending[STORAGE_MAX_BATCH];
+
   while (!feof(storage->file)) {
     int64_t entry_start = ftell(storage->file);
     if (entry_start < 0) {
@@ -182,6 +223,7 @@ static StorageResult scan_file(StorageFile *storage) {
     }
 
     // Validate CRC32 over (size + chunk_key + data)
+    uint32_t commit_payload = 0;
     EntryHeader computed = compute_header(hdr.chunk_key, NULL, hdr.size);
     if (hdr.size > 0) {
       // Stream data through stack buffer and update CRC
@@ -202,6 +244,10 @@ static StorageResult scan_file(StorageFile *storage) {
           break;
         }
         crc = crc32_update(crc, stream_buffer, chunk_size);
+        if (hdr.chunk_key == 0 && bytes_remaining == hdr.size &&
+            chunk_size >= sizeof(commit_payload)) {
+          memcpy(&commit_payload, stream_buffer, sizeof(commit_payload));
+        }
         bytes_remaining -= chunk_size;
       }
 
@@ -245,7 +291,41 @@ static StorageResult scan_file(StorageFile *storage) {
     }
 
     // Valid entry - update index
-    if (hdr.size > 0) {
+    if (hdr.chunk_key == 0) {
+      // Commit record: apply everything held pending since the last one
+      if (hdr.size != sizeof(uint32_t) ||
+          (batch_mode && commit_payload != pending_bytes)) {
+        set_error(storage, "Invalid commit record at offset %" PRId64,
+                  entry_start);
+        return STORAGE_CORRUPTION;
+      }
+      for (uint32_t i = 0; i < pending_count; i++) {
+        if (pending[i].size > 0) {
+          if (!hash_put(storage, pending[i].key, pending[i].offset,
+                        pending[i].size)) {
+            set_error(storage, "Hash table full during scan (max %d chunks)",
+                      HASH_TABLE_SIZE);
+            return STORAGE_TABLE_FULL;
+          }
+        } else {
+          hash_remove(storage, pending[i].key);
+        }
+      }
+      pending_count = 0;
+      pending_bytes = 0;
+      batch_mode = true;
+    } else if (batch_mode) {
+      // Hold until the next commit record makes it durable
+      if (pending_count >= STORAGE_MAX_BATCH) {
+        set_error(storage, "Oversized batch at offset %" PRId64, entry_start);
+        return STORAGE_CORRUPTION;
+      }
+      pending[pending_count++] = (StorageHashSlot){
+          .key = hdr.chunk_key, .offset = (uint32_t)entry_start,
+          .size = hdr.size};
+      pending_bytes += sizeof(EntryHeader) + hdr.size;
+      continue; // Does not advance last_valid_offset until committed
+    } else if (hdr.size > 0) {
       if (!hash_put(storage, hdr.chunk_key, (uint32_t)entry_start, hdr.size)) {
         set_error(storage, "Hash table full during scan (max %d chunks)",
                   HASH_TABLE_SIZE);
@@ -283,6 +363,18 @@ static StorageResult scan_file(StorageFile *storage) {
   return STORAGE_OK;
 }
 
+// Abandon any in-progress incremental compaction pass
+static void compact_abort(StorageFile *storage) {
+  if (storage->compact_file) {
+    fclose(storage->compact_file);
+    storage->compact_file = NULL;
+    char tmp_path[512];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", storage->path);
+    remove(tmp_path);
+  }
+  storage->compact_scan_offset = 0;
+}
+
 StorageResult storage_file_open(StorageFile *storage, const char *path) {
   // Try to open existing file
   FILE *f = fopen(path, "r+b");
@@ -300,6 +392,13 @@ StorageResult storage_file_open(StorageFile *storage, const char *path) {
       fclose(f);
       return STORAGE_IO_ERROR;
     }
+    // Initial empty commit record puts the scan in batch mode from the
+    // first real record on
+    if (!write_commit_record(f, 0)) {
+      set_error(storage, "Failed to write commit record to: %s", path);
+      fclose(f);
+      return STORAGE_IO_ERROR;
+    }
     if (!platform_fsync(f)) {
       set_error(storage, "Failed to sync file header to: %s", path);
       fclose(f);
@@ -315,6 +414,8 @@ StorageResult storage_file_open(StorageFile *storage, const char *path) {
 }
 
 void storage_file_close(StorageFile *storage) {
+  compact_abort(storage);
+  unmap_file(storage);
   if (storage->file) {
     fclose(storage->file);
   }
@@ -398,6 +499,82 @@ StorageResult storage_file_get(StorageFile *storage, uint64_t chunk_key,
   return STORAGE_OK;
 }
 
+StorageResult storage_file_get_ref(StorageFile *storage, uint64_t chunk_key,
+                                   const void **out_data, uint32_t *out_size) {
+  if (!chunk_key) {
+    set_error(storage, "Invalid chunk key: 0 is reserved");
+    return STORAGE_INVALID_ARGUMENT;
+  }
+  if (!out_data || !out_size) {
+    set_error(storage, "out_data and out_size parameters cannot be NULL");
+    return STORAGE_INVALID_ARGUMENT;
+  }
+
+  StorageHashSlot *slot = hash_get(storage, chunk_key);
+  if (!slot) {
+    clear_error(storage);
+    return STORAGE_NOT_FOUND;
+  }
+
+  // (Re)map the file if there is no view yet, or the entry was appended
+  // past the end of the current one
+  uint64_t needed = (uint64_t)slot->offset + sizeof(EntryHeader) + slot->size;
+  if (!storage->map_base || needed > storage->map_size) {
+    unmap_file(storage);
+
+    if (fflush(storage->file) != 0) {
+      set_error(storage, "Failed to flush file before mapping");
+      return STORAGE_IO_ERROR;
+    }
+    if (fseek(storage->file, 0, SEEK_END) != 0) {
+      set_error(storage, "Failed to seek to end of file");
+      return STORAGE_IO_ERROR;
+    }
+    int64_t file_size = ftell(storage->file);
+    if (file_size < 0 || (uint64_t)file_size < needed) {
+      set_error(storage, "File too short for entry at offset %u", slot->offset);
+      return STORAGE_IO_ERROR;
+    }
+
+    storage->map_base = platform_mmap_readonly(storage->file, file_size);
+    if (!storage->map_base) {
+      set_error(storage, "Failed to memory-map file: %s", storage->path);
+      return STORAGE_IO_ERROR;
+    }
+    storage->map_size = (uint64_t)file_size;
+  }
+
+  const uint8_t *entry = storage->map_base + slot->offset;
+  const EntryHeader *hdr = (const EntryHeader *)entry;
+  const uint8_t *data = entry + sizeof(EntryHeader);
+
+  // Validate header size matches index
+  if (hdr->size != slot->size || hdr->chunk_key != chunk_key) {
+    set_error(
+        storage,
+        "Header mismatch: expected size=%u key=%llu, got size=%u key=%llu",
+        slot->size, (unsigned long long)chunk_key, hdr->size,
+        (unsigned long long)hdr->chunk_key);
+    return STORAGE_CORRUPTION;
+  }
+
+  // Validate CRC32 once per record, on first touch
+  if (!slot->crc_checked) {
+    EntryHeader computed = compute_header(chunk_key, data, slot->size);
+    if (computed.crc32 != hdr->crc32) {
+      set_error(storage, "CRC32 mismatch: expected 0x%08x, got 0x%08x",
+                computed.crc32, hdr->crc32);
+      return STORAGE_CORRUPTION;
+    }
+    slot->crc_checked = true;
+  }
+
+  *out_data = data;
+  *out_size = slot->size;
+  clear_error(storage);
+  return STORAGE_OK;
+}
+
 StorageResult storage_file_set(StorageFile *storage, uint64_t chunk_key,
                                const void *data, uint32_t data_size) {
   if (!chunk_key) {
@@ -412,6 +589,11 @@ StorageResult storage_file_set(StorageFile *storage, uint64_t chunk_key,
     set_error(storage, "data_size parameter cannot be 0");
     return STORAGE_INVALID_ARGUMENT;
   }
+  if (storage->in_batch &&
+      storage->batch_pending_count >= STORAGE_MAX_BATCH) {
+    set_error(storage, "Batch full (max %d records)", STORAGE_MAX_BATCH);
+    return STORAGE_BATCH_FULL;
+  }
 
   // Build entry header
   EntryHeader hdr = compute_header(chunk_key, data, data_size);
@@ -435,15 +617,38 @@ StorageResult storage_file_set(StorageFile *storage, uint64_t chunk_key,
   // Write header + data
   if (fwrite(&hdr, sizeof(EntryHeader), 1, storage->file) != 1) {
     set_error(storage, "Failed to write entry header");
+    if (storage->in_batch) {
+      batch_rollback(storage);
+    }
     return STORAGE_IO_ERROR;
   }
   if (fwrite(data, 1, data_size, storage->file) != data_size) {
     set_error(storage, "Failed to write %u bytes of data", data_size);
-    platform_truncate_file(storage->file, (uint64_t)entry_offset);
+    if (storage->in_batch) {
+      batch_rollback(storage);
+    } else {
+      platform_truncate_file(storage->file, (uint64_t)entry_offset);
+    }
     return STORAGE_IO_ERROR;
   }
 
-  // Sync to disk for durability
+  if (storage->in_batch) {
+    // Deferred: no sync and no index update until the batch commits
+    storage->batch_pending[storage->batch_pending_count++] =
+        (StorageHashSlot){.key = chunk_key,
+                          .offset = (uint32_t)entry_offset,
+                          .size = hdr.size};
+    clear_error(storage);
+    return STORAGE_OK;
+  }
+
+  // Commit record + single sync makes the record durable on its own
+  if (!write_commit_record(storage->file,
+                           sizeof(EntryHeader) + hdr.size)) {
+    set_error(storage, "Failed to write commit record");
+    platform_truncate_file(storage->file, (uint64_t)entry_offset);
+    return STORAGE_IO_ERROR;
+  }
   if (!platform_fsync(storage->file)) {
     set_error(storage, "Failed to sync data to disk");
     platform_truncate_file(storage->file, (uint64_t)entry_offset);
@@ -457,13 +662,15 @@ StorageResult storage_file_set(StorageFile *storage, uint64_t chunk_key,
     return STORAGE_TABLE_FULL;
   }
 
-  // Check if compaction needed
+  // Step the online compactor: finish a pass already in progress, or
+  // start one when fragmentation crosses the threshold
   uint32_t total_data = storage->wasted_bytes + storage->useful_bytes;
-  if (total_data > 0 &&
-      (float)storage->wasted_bytes / total_data > FRAGMENTATION_THRESHOLD) {
+  if (storage->compact_file ||
+      (total_data > 0 &&
+       (float)storage->wasted_bytes / total_data > FRAGMENTATION_THRESHOLD)) {
     // Compaction failure is not critical - data is still written
-    // Just log and continue
-    storage_file_compact(storage);
+    // Just continue
+    storage_file_compact_step(storage, COMPACT_STEP_BYTES);
   }
 
   clear_error(storage);
@@ -479,6 +686,11 @@ StorageResult storage_file_del(StorageFile *storage, uint64_t chunk_key) {
     clear_error(storage);
     return STORAGE_NOT_FOUND;
   }
+  if (storage->in_batch &&
+      storage->batch_pending_count >= STORAGE_MAX_BATCH) {
+    set_error(storage, "Batch full (max %d records)", STORAGE_MAX_BATCH);
+    return STORAGE_BATCH_FULL;
+  }
 
   // Append tombstone entry (size = 0)
   EntryHeader hdr = compute_header(chunk_key, NULL, 0);
@@ -488,13 +700,39 @@ StorageResult storage_file_del(StorageFile *storage, uint64_t chunk_key) {
     return STORAGE_IO_ERROR;
   }
 
+  int64_t entry_offset = ftell(storage->file);
+  if (entry_offset < 0) {
+    set_error(storage, "ftell failed");
+    return STORAGE_IO_ERROR;
+  }
+
   if (fwrite(&hdr, sizeof(EntryHeader), 1, storage->file) != 1) {
     set_error(storage, "Failed to write tombstone entry");
+    if (storage->in_batch) {
+      batch_rollback(storage);
+    }
+    return STORAGE_IO_ERROR;
+  }
+
+  if (storage->in_batch) {
+    // Deferred: no sync and no index update until the batch commits
+    storage->batch_pending[storage->batch_pending_count++] =
+        (StorageHashSlot){.key = chunk_key,
+                          .offset = (uint32_t)entry_offset,
+                          .size = 0};
+    clear_error(storage);
+    return STORAGE_OK;
+  }
+
+  if (!write_commit_record(storage->file, sizeof(EntryHeader))) {
+    set_error(storage, "Failed to write commit record");
+    platform_truncate_file(storage->file, (uint64_t)entry_offset);
     return STORAGE_IO_ERROR;
   }
 
   if (!platform_fsync(storage->file)) {
     set_error(storage, "Failed to sync tombstone to disk");
+    platform_truncate_file(storage->file, (uint64_t)entry_offset);
     return STORAGE_IO_ERROR;
   }
 
@@ -504,7 +742,100 @@ StorageResult storage_file_del(StorageFile *storage, uint64_t chunk_key) {
   return STORAGE_OK;
 }
 
+StorageResult storage_file_begin_batch(StorageFile *storage) {
+  if (storage->in_batch) {
+    set_error(storage, "Batch already in progress");
+    return STORAGE_INVALID_ARGUMENT;
+  }
+
+  if (fseek(storage->file, 0, SEEK_END) != 0) {
+    set_error(storage, "Failed to seek to end of file");
+    return STORAGE_IO_ERROR;
+  }
+  int64_t batch_start = ftell(storage->file);
+  if (batch_start < 0) {
+    set_error(storage, "ftell failed");
+    return STORAGE_IO_ERROR;
+  }
+  if (batch_start > UINT32_MAX) {
+    set_error(storage, "File size exceeds 4GB limit");
+    return STORAGE_IO_ERROR;
+  }
+
+  storage->in_batch = true;
+  storage->batch_start_offset = (uint32_t)batch_start;
+  storage->batch_pending_count = 0;
+  clear_error(storage);
+  return STORAGE_OK;
+}
+
+StorageResult storage_file_commit_batch(StorageFile *storage) {
+  if (!storage->in_batch) {
+    set_error(storage, "No batch in progress");
+    return STORAGE_INVALID_ARGUMENT;
+  }
+  if (storage->batch_pending_count == 0) {
+    // Empty batch: nothing to commit
+    storage->in_batch = false;
+    clear_error(storage);
+    return STORAGE_OK;
+  }
+
+  if (fseek(storage->file, 0, SEEK_END) != 0) {
+    set_error(storage, "Failed to seek to end of file");
+    batch_rollback(storage);
+    return STORAGE_IO_ERROR;
+  }
+  int64_t commit_offset = ftell(storage->file);
+  if (commit_offset < 0) {
+    set_error(storage, "ftell failed");
+    batch_rollback(storage);
+    return STORAGE_IO_ERROR;
+  }
+
+  // One commit record and one sync cover the whole batch
+  uint32_t batch_bytes =
+      (uint32_t)commit_offset - storage->batch_start_offset;
+  if (!write_commit_record(storage->file, batch_bytes) ||
+      !platform_fsync(storage->file)) {
+    set_error(storage, "Failed to commit batch");
+    batch_rollback(storage);
+    return STORAGE_IO_ERROR;
+  }
+  storage->in_batch = false;
+
+  // Apply the batch to the index only once it is durable
+  for (uint32_t i = 0; i < storage->batch_pending_count; i++) {
+    StorageHashSlot *rec = &storage->batch_pending[i];
+    if (rec->size > 0) {
+      if (!hash_put(storage, rec->key, rec->offset, rec->size)) {
+        storage->batch_pending_count = 0;
+        set_error(storage, "Hash table full (max %d chunks)", HASH_TABLE_SIZE);
+        return STORAGE_TABLE_FULL;
+      }
+    } else {
+      hash_remove(storage, rec->key);
+    }
+  }
+  storage->batch_pending_count = 0;
+
+  // Step the online compactor now that the batch is out of the way
+  uint32_t total_data = storage->wasted_bytes + storage->useful_bytes;
+  if (storage->compact_file ||
+      (total_data > 0 &&
+       (float)storage->wasted_bytes / total_data > FRAGMENTATION_THRESHOLD)) {
+    storage_file_compact_step(storage, COMPACT_STEP_BYTES);
+  }
+
+  clear_error(storage);
+  return STORAGE_OK;
+}
+
 StorageResult storage_file_compact(StorageFile *storage) {
+  // A one-shot rewrite supersedes any in-progress incremental pass
+  // (which also shares the temporary file path)
+  compact_abort(storage);
+
   char tmp_path[512];
   snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", storage->path);
 
@@ -514,9 +845,10 @@ StorageResult storage_file_compact(StorageFile *storage) {
     return STORAGE_IO_ERROR;
   }
 
-  // Write file header
+  // Write file header and initial empty commit record
   FileHeader file_hdr = {.magic = STORAGE_MAGIC, .version = STORAGE_VERSION};
-  if (fwrite(&file_hdr, sizeof(FileHeader), 1, tmp) != 1) {
+  if (fwrite(&file_hdr, sizeof(FileHeader), 1, tmp) != 1 ||
+      !write_commit_record(tmp, 0)) {
     set_error(storage, "Failed to write header to temporary file");
     fclose(tmp);
     remove(tmp_path);
@@ -524,7 +856,8 @@ StorageResult storage_file_compact(StorageFile *storage) {
   }
 
   // Track expected file size for validation
-  int64_t expected_size = sizeof(FileHeader);
+  int64_t expected_size =
+      sizeof(FileHeader) + sizeof(EntryHeader) + sizeof(uint32_t);
 
   // Copy all active chunks
   for (uint32_t i = 0; i < HASH_TABLE_SIZE; i++) {
@@ -611,8 +944,18 @@ StorageResult storage_file_compact(StorageFile *storage) {
       return STORAGE_IO_ERROR;
     }
 
+    // Commit each copied record individually, so the scan never has to
+    // hold more than one compacted record pending
+    if (!write_commit_record(tmp, sizeof(EntryHeader) + slot->size)) {
+      set_error(storage, "Failed to write commit record during compaction");
+      fclose(tmp);
+      remove(tmp_path);
+      return STORAGE_IO_ERROR;
+    }
+
     // Update expected size
     expected_size += sizeof(EntryHeader) + slot->size;
+    expected_size += sizeof(EntryHeader) + sizeof(uint32_t);
   }
 
   // Close temp file before validation
@@ -657,6 +1000,180 @@ StorageResult storage_file_compact(StorageFile *storage) {
   return scan_file(storage);
 }
 
+// Start an incremental compaction pass: create the temporary file and
+// position the scan just past the file header
+static StorageResult compact_begin(StorageFile *storage) {
+  char tmp_path[512];
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", storage->path);
+
+  FILE *tmp = fopen(tmp_path, "wb");
+  if (!tmp) {
+    set_error(storage, "Failed to create temporary file: %s", tmp_path);
+    return STORAGE_IO_ERROR;
+  }
+
+  FileHeader file_hdr = {.magic = STORAGE_MAGIC, .version = STORAGE_VERSION};
+  if (fwrite(&file_hdr, sizeof(FileHeader), 1, tmp) != 1 ||
+      !write_commit_record(tmp, 0)) {
+    set_error(storage, "Failed to write header to temporary file");
+    fclose(tmp);
+    remove(tmp_path);
+    return STORAGE_IO_ERROR;
+  }
+
+  storage->compact_file = tmp;
+  storage->compact_scan_offset = sizeof(FileHeader);
+  return STORAGE_OK;
+}
+
+// Finish an incremental compaction pass: atomically swap the temporary
+// file in for the original and rebuild the index
+static StorageResult compact_finish(StorageFile *storage) {
+  char tmp_path[512];
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", storage->path);
+
+  FILE *tmp = storage->compact_file;
+  storage->compact_file = NULL;
+  storage->compact_scan_offset = 0;
+
+  if (fclose(tmp) != 0) {
+    set_error(storage, "Failed to close temporary file");
+    remove(tmp_path);
+    return STORAGE_IO_ERROR;
+  }
+
+  // Close original file before atomic replace
+  fclose(storage->file);
+  storage->file = NULL;
+
+  if (!platform_atomic_replace(tmp_path, storage->path)) {
+    set_error(storage, "Failed to replace storage file");
+    storage->file = fopen(storage->path, "r+b"); // Try to recover
+    remove(tmp_path);
+    return STORAGE_IO_ERROR;
+  }
+
+  storage->file = fopen(storage->path, "r+b");
+  if (!storage->file) {
+    set_error(storage, "Failed to reopen storage file after compaction");
+    return STORAGE_IO_ERROR;
+  }
+
+  // Rescan file and return result directly
+  return scan_file(storage);
+}
+
+StorageResult storage_file_compact_step(StorageFile *storage,
+                                        uint32_t max_bytes) {
+  if (storage->in_batch) {
+    // Deferred until the open batch commits; finishing a pass would
+    // swap the file out from under the batch records
+    clear_error(storage);
+    return STORAGE_OK;
+  }
+  if (!storage->compact_file) {
+    StorageResult result = compact_begin(storage);
+    if (result != STORAGE_OK) {
+      return result;
+    }
+  }
+
+  uint32_t scanned_bytes = 0;
+  while (scanned_bytes < max_bytes) {
+    // Find the current end of the log; entries appended between steps
+    // extend the scan, so live versions written mid-pass are picked up
+    if (fseek(storage->file, 0, SEEK_END) != 0) {
+      set_error(storage, "Failed to seek to end of file");
+      compact_abort(storage);
+      return STORAGE_IO_ERROR;
+    }
+    int64_t log_end = ftell(storage->file);
+    if (log_end < 0) {
+      set_error(storage, "ftell failed during compaction");
+      compact_abort(storage);
+      return STORAGE_IO_ERROR;
+    }
+    if ((int64_t)storage->compact_scan_offset >= log_end) {
+      return compact_finish(storage);
+    }
+
+    // Read entry header at the scan position
+    if (fseek(storage->file, storage->compact_scan_offset, SEEK_SET) != 0) {
+      set_error(storage, "Failed to seek to offset %u",
+                storage->compact_scan_offset);
+      compact_abort(storage);
+      return STORAGE_IO_ERROR;
+    }
+    EntryHeader hdr;
+    if (fread(&hdr, sizeof(EntryHeader), 1, storage->file) != 1) {
+      set_error(storage, "Failed to read entry header at offset %u",
+                storage->compact_scan_offset);
+      compact_abort(storage);
+      return STORAGE_IO_ERROR;
+    }
+
+    uint32_t entry_bytes = sizeof(EntryHeader) + hdr.size;
+    bool live;
+    if (hdr.chunk_key == 0) {
+      // Old commit records are dropped; copied records get fresh ones
+      live = false;
+    } else if (hdr.size > 0) {
+      // Data entry is live only if the index still points at it
+      StorageHashSlot *slot = hash_get(storage, hdr.chunk_key);
+      live = slot && slot->offset == storage->compact_scan_offset;
+    } else {
+      // Keep a tombstone while its key is still deleted, in case an
+      // older version of the key was already copied earlier in the pass
+      live = hash_get(storage, hdr.chunk_key) == NULL;
+    }
+
+    if (live) {
+      // Copy the raw entry (the CRC covers size + key + data, none of
+      // which change, so no recomputation is needed)
+      if (fseek(storage->file, storage->compact_scan_offset, SEEK_SET) != 0) {
+        set_error(storage, "Failed to seek to offset %u",
+                  storage->compact_scan_offset);
+        compact_abort(storage);
+        return STORAGE_IO_ERROR;
+      }
+      uint8_t stream_buffer[65536];
+      uint32_t bytes_remaining = entry_bytes;
+      while (bytes_remaining > 0) {
+        uint32_t chunk_size = bytes_remaining < sizeof(stream_buffer)
+                                  ? bytes_remaining
+                                  : sizeof(stream_buffer);
+        if (fread(stream_buffer, 1, chunk_size, storage->file) != chunk_size) {
+          set_error(storage, "Failed to read %u bytes during compaction",
+                    chunk_size);
+          compact_abort(storage);
+          return STORAGE_IO_ERROR;
+        }
+        if (fwrite(stream_buffer, 1, chunk_size, storage->compact_file) !=
+            chunk_size) {
+          set_error(storage, "Failed to write %u bytes during compaction",
+                    chunk_size);
+          compact_abort(storage);
+          return STORAGE_IO_ERROR;
+        }
+        bytes_remaining -= chunk_size;
+      }
+
+      // Commit each copied record so the scan applies it individually
+      if (!write_commit_record(storage->compact_file, entry_bytes)) {
+        set_error(storage, "Failed to write commit record during compaction");
+        compact_abort(storage);
+        return STORAGE_IO_ERROR;
+      }
+    }
+
+    storage->compact_scan_offset += entry_bytes;
+    scanned_bytes += entry_bytes;
+  }
+
+  clear_error(storage);
+  return STORAGE_OK;
+}
+
 #ifdef STORAGE_FILE_TESTS
 
 #include <assert.h>
@@ -954,6 +1471,266 @@ TEST(compaction) {
   return true;
 }
 
+// Test incremental compaction (bounded work per step, writes mid-pass)
+TEST(incremental_compaction) {
+  StorageFile storage = {0};
+  StorageResult result;
+
+  result = storage_file_open(&storage, "test_compact_inc.dat");
+  ASSERT_EQ(result, STORAGE_OK);
+
+  // Write and overwrite to create fragmentation
+  uint8_t data[1000];
+  for (int round = 0; round < 5; round++) {
+    for (uint64_t i = 1; i <= 10; i++) {
+      memset(data, (uint8_t)(round * 10 + i), sizeof(data));
+      result = storage_file_set(&storage, i, data, sizeof(data));
+      ASSERT_EQ(result, STORAGE_OK);
+    }
+  }
+  result = storage_file_del(&storage, 1);
+  ASSERT_EQ(result, STORAGE_OK);
+
+  // Step a few times with a tiny budget, then overwrite a chunk mid-pass;
+  // the finished pass must keep the newest version
+  for (int i = 0; i < 3; i++) {
+    result = storage_file_compact_step(&storage, 2048);
+    ASSERT_EQ(result, STORAGE_OK);
+  }
+  ASSERT(storage.compact_file != NULL); // Pass still in progress
+  memset(data, 0xEE, sizeof(data));
+  result = storage_file_set(&storage, 2, data, sizeof(data));
+  ASSERT_EQ(result, STORAGE_OK);
+
+  // Drive the compactor to completion
+  int steps = 0;
+  while (storage.compact_file || storage.wasted_bytes > 0) {
+    result = storage_file_compact_step(&storage, 2048);
+    ASSERT_EQ(result, STORAGE_OK);
+    ASSERT(++steps < 1000);
+  }
+
+  // Verify surviving chunks hold their latest values
+  uint32_t size = sizeof(data);
+  result = storage_file_get(&storage, 2, data, &size);
+  ASSERT_EQ(result, STORAGE_OK);
+  ASSERT_EQ(data[0], 0xEE);
+  for (uint64_t i = 3; i <= 10; i++) {
+    size = sizeof(data);
+    result = storage_file_get(&storage, i, data, &size);
+    ASSERT_EQ(result, STORAGE_OK);
+    ASSERT_EQ(size, 1000);
+    ASSERT_EQ(data[0], (uint8_t)(40 + i));
+  }
+
+  // Deleted chunk stays gone
+  size = sizeof(data);
+  result = storage_file_get(&storage, 1, data, &size);
+  ASSERT_EQ(result, STORAGE_NOT_FOUND);
+
+  // Compacted file survives close and reopen
+  storage_file_close(&storage);
+  result = storage_file_open(&storage, "test_compact_inc.dat");
+  ASSERT_EQ(result, STORAGE_OK);
+  size = sizeof(data);
+  result = storage_file_get(&storage, 5, data, &size);
+  ASSERT_EQ(result, STORAGE_OK);
+  ASSERT_EQ(data[0], 45);
+
+  storage_file_close(&storage);
+  remove("test_compact_inc.dat");
+  return true;
+}
+
+// Test zero-copy reads through the memory-mapped view
+TEST(get_ref) {
+  StorageFile storage = {0};
+  StorageResult result;
+
+  result = storage_file_open(&storage, "test_get_ref.dat");
+  ASSERT_EQ(result, STORAGE_OK);
+
+  uint8_t write_data[100];
+  for (int i = 0; i < 100; i++) {
+    write_data[i] = (uint8_t)i;
+  }
+  result = storage_file_set(&storage, 42, write_data, sizeof(write_data));
+  ASSERT_EQ(result, STORAGE_OK);
+
+  // First touch maps the file and validates the CRC
+  const void *ref = NULL;
+  uint32_t size = 0;
+  result = storage_file_get_ref(&storage, 42, &ref, &size);
+  ASSERT_EQ(result, STORAGE_OK);
+  ASSERT_EQ(size, sizeof(write_data));
+  ASSERT_EQ(memcmp(ref, write_data, size), 0);
+
+  // Second lookup reuses the mapping and skips revalidation
+  const void *ref2 = NULL;
+  result = storage_file_get_ref(&storage, 42, &ref2, &size);
+  ASSERT_EQ(result, STORAGE_OK);
+  ASSERT(ref2 == ref);
+
+  // Overwrite appends past the mapping; the ref follows the new version
+  uint8_t new_data[100];
+  memset(new_data, 0x5A, sizeof(new_data));
+  result = storage_file_set(&storage, 42, new_data, sizeof(new_data));
+  ASSERT_EQ(result, STORAGE_OK);
+
+  result = storage_file_get_ref(&storage, 42, &ref, &size);
+  ASSERT_EQ(result, STORAGE_OK);
+  ASSERT_EQ(size, sizeof(new_data));
+  ASSERT_EQ(memcmp(ref, new_data, size), 0);
+
+  // Missing key
+  result = storage_file_get_ref(&storage, 999, &ref, &size);
+  ASSERT_EQ(result, STORAGE_NOT_FOUND);
+
+  storage_file_close(&storage);
+  remove("test_get_ref.dat");
+  return true;
+}
+
+// Test CRC corruption detection on first mapped touch
+TEST(get_ref_corruption) {
+  StorageFile storage = {0};
+  StorageResult result;
+
+  result = storage_file_open(&storage, "test_get_ref_corrupt.dat");
+  ASSERT_EQ(result, STORAGE_OK);
+
+  uint8_t data[50];
+  memset(data, 0xDD, sizeof(data));
+  result = storage_file_set(&storage, 333, data, sizeof(data));
+  ASSERT_EQ(result, STORAGE_OK);
+
+  // Corrupt the chunk data on disk before the first mapped read
+  // (FileHeader=8, initial commit record=20, EntryHeader=16)
+  FILE *f = storage.file;
+  ASSERT_EQ(fseek(f, 8 + 20 + 16 + 25, SEEK_SET), 0);
+  uint8_t corrupt_byte = 0x00;
+  ASSERT_EQ(fwrite(&corrupt_byte, 1, 1, f), 1);
+  ASSERT_EQ(fflush(f), 0);
+
+  const void *ref = NULL;
+  uint32_t size = 0;
+  result = storage_file_get_ref(&storage, 333, &ref, &size);
+  ASSERT_EQ(result, STORAGE_CORRUPTION);
+
+  storage_file_close(&storage);
+  remove("test_get_ref_corrupt.dat");
+  return true;
+}
+
+// Test write batches: one commit record + sync covers many records
+TEST(write_batch) {
+  StorageFile storage = {0};
+  StorageResult result;
+
+  result = storage_file_open(&storage, "test_batch.dat");
+  ASSERT_EQ(result, STORAGE_OK);
+
+  // Seed a chunk the batch will overwrite and one it will delete
+  uint8_t data[100];
+  memset(data, 0x11, sizeof(data));
+  result = storage_file_set(&storage, 1, data, sizeof(data));
+  ASSERT_EQ(result, STORAGE_OK);
+  result = storage_file_set(&storage, 2, data, sizeof(data));
+  ASSERT_EQ(result, STORAGE_OK);
+
+  result = storage_file_begin_batch(&storage);
+  ASSERT_EQ(result, STORAGE_OK);
+
+  memset(data, 0x22, sizeof(data));
+  result = storage_file_set(&storage, 1, data, sizeof(data));
+  ASSERT_EQ(result, STORAGE_OK);
+  result = storage_file_set(&storage, 3, data, sizeof(data));
+  ASSERT_EQ(result, STORAGE_OK);
+  result = storage_file_del(&storage, 2);
+  ASSERT_EQ(result, STORAGE_OK);
+
+  // Uncommitted records are invisible to reads
+  uint32_t size = sizeof(data);
+  result = storage_file_get(&storage, 3, data, &size);
+  ASSERT_EQ(result, STORAGE_NOT_FOUND);
+  size = sizeof(data);
+  result = storage_file_get(&storage, 1, data, &size);
+  ASSERT_EQ(result, STORAGE_OK);
+  ASSERT_EQ(data[0], 0x11);
+
+  result = storage_file_commit_batch(&storage);
+  ASSERT_EQ(result, STORAGE_OK);
+
+  // After commit the whole batch is applied
+  size = sizeof(data);
+  result = storage_file_get(&storage, 1, data, &size);
+  ASSERT_EQ(result, STORAGE_OK);
+  ASSERT_EQ(data[0], 0x22);
+  size = sizeof(data);
+  result = storage_file_get(&storage, 3, data, &size);
+  ASSERT_EQ(result, STORAGE_OK);
+  size = sizeof(data);
+  result = storage_file_get(&storage, 2, data, &size);
+  ASSERT_EQ(result, STORAGE_NOT_FOUND);
+
+  // And survives reopen
+  storage_file_close(&storage);
+  result = storage_file_open(&storage, "test_batch.dat");
+  ASSERT_EQ(result, STORAGE_OK);
+  size = sizeof(data);
+  result = storage_file_get(&storage, 1, data, &size);
+  ASSERT_EQ(result, STORAGE_OK);
+  ASSERT_EQ(data[0], 0x22);
+  size = sizeof(data);
+  result = storage_file_get(&storage, 2, data, &size);
+  ASSERT_EQ(result, STORAGE_NOT_FOUND);
+
+  storage_file_close(&storage);
+  remove("test_batch.dat");
+  return true;
+}
+
+// Test that a batch missing its commit record rolls back on reopen
+TEST(write_batch_crash_recovery) {
+  StorageFile storage = {0};
+  StorageResult result;
+
+  result = storage_file_open(&storage, "test_batch_crash.dat");
+  ASSERT_EQ(result, STORAGE_OK);
+
+  uint8_t data[100];
+  memset(data, 0x11, sizeof(data));
+  result = storage_file_set(&storage, 1, data, sizeof(data));
+  ASSERT_EQ(result, STORAGE_OK);
+
+  // Batch records reach the file, but the commit record never does
+  result = storage_file_begin_batch(&storage);
+  ASSERT_EQ(result, STORAGE_OK);
+  memset(data, 0x22, sizeof(data));
+  result = storage_file_set(&storage, 1, data, sizeof(data));
+  ASSERT_EQ(result, STORAGE_OK);
+  result = storage_file_set(&storage, 2, data, sizeof(data));
+  ASSERT_EQ(result, STORAGE_OK);
+
+  // Simulate a crash: close without committing, then reopen
+  storage_file_close(&storage);
+  result = storage_file_open(&storage, "test_batch_crash.dat");
+  ASSERT_EQ(result, STORAGE_OK);
+
+  // The whole batch is rolled back, not half-applied
+  uint32_t size = sizeof(data);
+  result = storage_file_get(&storage, 1, data, &size);
+  ASSERT_EQ(result, STORAGE_OK);
+  ASSERT_EQ(data[0], 0x11);
+  size = sizeof(data);
+  result = storage_file_get(&storage, 2, data, &size);
+  ASSERT_EQ(result, STORAGE_NOT_FOUND);
+
+  storage_file_close(&storage);
+  remove("test_batch_crash.dat");
+  return true;
+}
+
 // Test buffer too small
 TEST(buffer_too_small) {
   StorageFile storage = {0};
@@ -1136,8 +1913,9 @@ TEST(corruption_mid_file) {
   FILE *f = fopen("test_corrupt_mid.dat", "r+b");
   ASSERT(f != NULL);
 
-  // Seek to middle of first entry (header is 8+16=24 bytes)
-  ASSERT_EQ(fseek(f, 8 + 16 + 50, SEEK_SET), 0);
+  // Seek to middle of first entry's data
+  // (FileHeader=8, initial commit record=20, EntryHeader=16)
+  ASSERT_EQ(fseek(f, 8 + 20 + 16 + 50, SEEK_SET), 0);
   uint8_t corrupt_byte = 0x00;
   ASSERT_EQ(fwrite(&corrupt_byte, 1, 1, f), 1);
   fclose(f);
@@ -1226,8 +2004,9 @@ TEST(corruption_crc_on_read) {
   FILE *f = storage.file;
   int64_t current_pos = ftell(f);
 
-  // Seek to middle of entry data (FileHeader=8, EntryHeader=16)
-  ASSERT_EQ(fseek(f, 8 + 16 + 25, SEEK_SET), 0);
+  // Seek to middle of entry data
+  // (FileHeader=8, initial commit record=20, EntryHeader=16)
+  ASSERT_EQ(fseek(f, 8 + 20 + 16 + 25, SEEK_SET), 0);
   uint8_t corrupt_byte = 0x00;
   ASSERT_EQ(fwrite(&corrupt_byte, 1, 1, f), 1);
 
@@ -1258,6 +2037,11 @@ void storage_file_run_tests(void) {
   RUN_TEST(persistence);
   RUN_TEST(multiple_chunks);
   RUN_TEST(compaction);
+  RUN_TEST(incremental_compaction);
+  RUN_TEST(get_ref);
+  RUN_TEST(get_ref_corruption);
+  RUN_TEST(write_batch);
+  RUN_TEST(write_batch_crash_recovery);
   RUN_TEST(buffer_too_small);
   RUN_TEST(large_chunk);
   RUN_TEST(delete_missing);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -8,6 +9,9 @@
 // Simple fixed-size hash table with linear probing
 #define HASH_TABLE_SIZE 16384
 
+// Maximum records per write batch
+#define STORAGE_MAX_BATCH 64
+
 // Result codes for storage operations
 typedef enum {
   STORAGE_OK = 0,           // Success
@@ -18,12 +22,14 @@ typedef enum {
   STORAGE_INTERNAL_ERROR,   // Internal error (unexpected)
   STORAGE_CORRUPTION,       // Data corruption detected (unexpected)
   STORAGE_TABLE_FULL,       // Hash table full (unexpected)
+  STORAGE_BATCH_FULL,       // Too many records in one batch (unexpected)
 } StorageResult;
 
 typedef struct {
-  uint64_t key;    // 0 = empty slot
-  uint32_t offset; // Offset in file where this entry starts
-  uint32_t size;   // Data size
+  uint64_t key;     // 0 = empty slot
+  uint32_t offset;  // Offset in file where this entry starts
+  uint32_t size;    // Data size
+  bool crc_checked; // Entry CRC validated by the mapped read path
 } StorageHashSlot;
 
 typedef struct {
@@ -34,6 +40,24 @@ typedef struct {
   StorageHashSlot hash_table[HASH_TABLE_SIZE];
   uint32_t useful_bytes;
   uint32_t wasted_bytes;
+
+  // Incremental compaction state (compact_file != NULL while a pass is
+  // in progress; compact_scan_offset tracks how far into the log the
+  // pass has copied live entries)
+  FILE *compact_file;
+  uint32_t compact_scan_offset;
+
+  // Read-only memory-mapped view of the file, created lazily by
+  // storage_file_get_ref and remapped when the file grows
+  uint8_t *map_base;
+  uint64_t map_size;
+
+  // Write batch state: while in_batch, set/del append records without
+  // syncing, and index updates are deferred until the batch commits
+  bool in_batch;
+  uint32_t batch_start_offset;
+  uint32_t batch_pending_count;
+  StorageHashSlot batch_pending[STORAGE_MAX_BATCH]; // size 0 = tombstone
 } StorageFile;
 
 // Append-only log-structured chunk storage with CRC32 validation
@@ -50,10 +74,18 @@ typedef struct {
 //   uint64_t chunk_key   // Unique chunk identifier
 //   uint8_t data[size]   // Chunk data
 //
+// Entries with chunk_key 0 are commit records: their 4-byte payload is
+// the byte length of the records they commit. Once a file contains a
+// commit record, records only become durable when a commit record
+// follows them; the scan on open discards any uncommitted tail, so a
+// multi-record batch is applied all-or-nothing after a crash. Files
+// without commit records (written before this scheme) scan per-entry
+//
 // Properties:
 //   - All operations append entries (single atomic write)
 //   - Last entry for a given chunk_key wins
 //   - Delete appends tombstone (size=0)
+//   - Batches coalesce records under one commit record and one sync
 //   - Compaction removes old/deleted entries
 //   - CRC32 validation detects corruption
 //   - Index rebuilt in memory on open by scanning file
@@ -77,6 +109,16 @@ const char *storage_file_error(StorageFile *storage);
 StorageResult storage_file_get(StorageFile *storage, uint64_t chunk_key,
                                void *out_data, uint32_t *out_size);
 
+// Get a zero-copy reference to chunk data by key
+// Returns a pointer directly into a read-only memory mapping of the
+// file, so callers can decode straight from the page cache. The entry
+// CRC is validated on first touch and the result tracked per record.
+// The pointer is only valid until the next set/del/compaction/close
+// Returns STORAGE_OK if found and valid
+// Returns STORAGE_NOT_FOUND if key not found
+StorageResult storage_file_get_ref(StorageFile *storage, uint64_t chunk_key,
+                                   const void **out_data, uint32_t *out_size);
+
 // Set chunk data (appends new entry)
 // Last write for a given chunk_key wins
 // Returns STORAGE_OK on success
@@ -88,12 +130,35 @@ StorageResult storage_file_set(StorageFile *storage, uint64_t chunk_key,
 // Returns STORAGE_NOT_FOUND if key not found
 StorageResult storage_file_del(StorageFile *storage, uint64_t chunk_key);
 
+// Start a write batch: subsequent set/del calls append their records
+// without syncing, and the index is not updated until the commit, so
+// reads during the batch see the pre-batch state
+// Returns STORAGE_OK on success
+StorageResult storage_file_begin_batch(StorageFile *storage);
+
+// Commit a write batch: appends a single commit record covering every
+// record in the batch and syncs once, then applies the batch to the
+// index. On failure the whole batch is rolled back, and a crash before
+// the commit record reaches disk has the same effect on reopen
+// Returns STORAGE_OK on success
+StorageResult storage_file_commit_batch(StorageFile *storage);
+
 // Compact storage file (removes old/deleted entries)
-// Rewrites file with only latest version of each chunk
-// Called automatically when fragmentation exceeds threshold
+// Rewrites file with only latest version of each chunk in one pass
 // Returns STORAGE_OK on success
 StorageResult storage_file_compact(StorageFile *storage);
 
+// Incrementally compact the storage file with bounded work per call
+// Starts a pass when none is in progress, then scans up to max_bytes of
+// the log per call, copying live entries into a temporary file; when the
+// scan catches up with the end of the log the temporary file atomically
+// replaces the original. Writes and deletes may continue between calls.
+// Stepped automatically by storage_file_set while fragmentation exceeds
+// the threshold
+// Returns STORAGE_OK on success (both mid-pass and on completion)
+StorageResult storage_file_compact_step(StorageFile *storage,
+                                        uint32_t max_bytes);
+
 #define STORAGE_FILE_TESTS
 #ifdef STORAGE_FILE_TESTS
 // Run comprehensive test suite
@@ -13,6 +13,15 @@ let tileAtlas = null;
 // IndexedDB for chunk persistence
 let db = null;
 
+// Cached Float32Array view over WASM memory for zero-copy vertex uploads
+// (recreated only when memory growth detaches the underlying ArrayBuffer)
+let memoryF32 = null;
+
+// Per-layer framebuffer caches for host_submit_layer, plus a reusable
+// 4-vertex scratch buffer for blitting a cached layer to the canvas
+const layerCache = [];
+const blitVertices = new Float32Array(4 * 8);
+
 // Staging buffer for chunk loading (allocated after WASM init)
 // We'll use a fixed area at the end of game memory for temporary chunk data
 let chunkStagingBuffer = null;
@@ -30,6 +39,8 @@ const InputCommand = {
   PERIOD: 5,
   R: 6,
   D: 7,
+  P: 8,
+  T: 9,
 };
 
 // WebGL shader sources
@@ -93,6 +104,44 @@ function initWebGL(canvas) {
   // Create single vertex buffer for interleaved data
   shaderProgram.vertexBuffer = gl.createBuffer();
 
+  // Shared static index buffer expanding each 4-vertex quad (TL, TR, BL, BR)
+  // into 2 triangles with the pattern {0,1,2, 2,1,3}. Uint16 indices cap a
+  // single submission at 65536 vertices = 16384 quads, leaving headroom
+  // above the game's default flush threshold (MAX_VERTICES)
+  const MAX_QUADS = 16384;
+  const quadIndices = new Uint16Array(MAX_QUADS * 6);
+  for (let q = 0; q < MAX_QUADS; q++) {
+    const base = q * 4;
+    quadIndices[q * 6 + 0] = base + 0;
+    quadIndices[q * 6 + 1] = base + 1;
+    quadIndices[q * 6 + 2] = base + 2;
+    quadIndices[q * 6 + 3] = base + 2;
+    quadIndices[q * 6 + 4] = base + 1;
+    quadIndices[q * 6 + 5] = base + 3;
+  }
+  shaderProgram.quadIndexBuffer = gl.createBuffer();
+  gl.bindBuffer(gl.ELEMENT_ARRAY_BUFFER, shaderProgram.quadIndexBuffer);
+  gl.bufferData(gl.ELEMENT_ARRAY_BUFFER, quadIndices, gl.STATIC_DRAW);
+
+  // Allocate GPU vertex storage once at max capacity; per-frame submissions
+  // upload into it with bufferSubData instead of reallocating via bufferData
+  const floatsPerVertex = 8; // [x, y, r, g, b, a, u, v] = 32 bytes
+  const stride = floatsPerVertex * 4;
+  gl.bindBuffer(gl.ARRAY_BUFFER, shaderProgram.vertexBuffer);
+  gl.bufferData(gl.ARRAY_BUFFER, MAX_QUADS * 4 * stride, gl.STREAM_DRAW);
+
+  // Attribute layout never changes and both buffers stay bound, so the
+  // vertex attribute setup can happen once here instead of per submission
+  gl.enableVertexAttribArray(shaderProgram.attribLocations.position);
+  gl.vertexAttribPointer(shaderProgram.attribLocations.position,
+    2, gl.FLOAT, false, stride, 0);
+  gl.enableVertexAttribArray(shaderProgram.attribLocations.color);
+  gl.vertexAttribPointer(shaderProgram.attribLocations.color,
+    4, gl.FLOAT, false, stride, 8);
+  gl.enableVertexAttribArray(shaderProgram.attribLocations.texCoord);
+  gl.vertexAttribPointer(shaderProgram.attribLocations.texCoord,
+    2, gl.FLOAT, false, stride, 24);
+
   // Set up blending for transparency
   gl.enable(gl.BLEND);
   gl.blendFunc(gl.SRC_ALPHA, gl.ONE_MINUS_SRC_ALPHA);
@@ -240,62 +289,102 @@ const wasmImports = {
       }
     },
 
+    host_time_us() {
+      return performance.now() * 1000.0;
+    },
+
+    // Cached rasterizations of static geometry layers: each layer renders
+    // into its own framebuffer texture only when the submitted version (or
+    // canvas size) changes, and is otherwise just blitted at the offset
+    host_submit_layer(layerId, version, verticesPtr, vertexCount, offsetX, offsetY) {
+      const margin = 64; // overhang so sub-tile scroll offsets stay covered
+      const wantW = gl.canvas.width + margin;
+      const wantH = gl.canvas.height + margin;
+
+      let layer = layerCache[layerId];
+      if (!layer) {
+        layer = layerCache[layerId] = {
+          texture: null, fbo: null, w: 0, h: 0, version: 0, valid: false,
+        };
+      }
+
+      if (!layer.texture || layer.w !== wantW || layer.h !== wantH) {
+        if (layer.texture) gl.deleteTexture(layer.texture);
+        if (layer.fbo) gl.deleteFramebuffer(layer.fbo);
+        layer.texture = gl.createTexture();
+        gl.bindTexture(gl.TEXTURE_2D, layer.texture);
+        gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, wantW, wantH, 0, gl.RGBA,
+          gl.UNSIGNED_BYTE, null);
+        gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_WRAP_S, gl.CLAMP_TO_EDGE);
+        gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_WRAP_T, gl.CLAMP_TO_EDGE);
+        gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MIN_FILTER, gl.NEAREST);
+        gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MAG_FILTER, gl.NEAREST);
+        layer.fbo = gl.createFramebuffer();
+        gl.bindFramebuffer(gl.FRAMEBUFFER, layer.fbo);
+        gl.framebufferTexture2D(gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0,
+          gl.TEXTURE_2D, layer.texture, 0);
+        gl.bindFramebuffer(gl.FRAMEBUFFER, null);
+        layer.w = wantW;
+        layer.h = wantH;
+        layer.valid = false;
+      }
+
+      if (!layer.valid || layer.version !== version) {
+        gl.bindFramebuffer(gl.FRAMEBUFFER, layer.fbo);
+        gl.viewport(0, 0, wantW, wantH);
+        gl.clearColor(0, 0, 0, 0);
+        gl.clear(gl.COLOR_BUFFER_BIT);
+        gl.uniform2f(shaderProgram.uniformLocations.resolution, wantW, wantH);
+        wasmImports.env.host_submit_geometry(verticesPtr, vertexCount);
+        gl.bindFramebuffer(gl.FRAMEBUFFER, null);
+        gl.viewport(0, 0, gl.canvas.width, gl.canvas.height);
+        gl.uniform2f(shaderProgram.uniformLocations.resolution,
+          gl.canvas.width, gl.canvas.height);
+        layer.version = version;
+        layer.valid = true;
+      }
+
+      // Blit the cached layer as one quad. The shader flips y, so content
+      // at layer y=0 lands in the texture at v=1; the v coords undo that
+      const x0 = offsetX, y0 = offsetY;
+      const x1 = offsetX + wantW, y1 = offsetY + wantH;
+      blitVertices.set([
+        x0, y0, 1, 1, 1, 1, 0, 1, // top-left
+        x1, y0, 1, 1, 1, 1, 1, 1, // top-right
+        x0, y1, 1, 1, 1, 1, 0, 0, // bottom-left
+        x1, y1, 1, 1, 1, 1, 1, 0, // bottom-right
+      ]);
+      gl.bindTexture(gl.TEXTURE_2D, layer.texture);
+      gl.bindBuffer(gl.ARRAY_BUFFER, shaderProgram.vertexBuffer);
+      gl.bufferSubData(gl.ARRAY_BUFFER, 0, blitVertices);
+      gl.drawElements(gl.TRIANGLES, 6, gl.UNSIGNED_SHORT, 0);
+    },
+
     host_submit_geometry(verticesPtr, vertexCount) {
       if (vertexCount === 0) return;
 
-      // Read vertex data directly from WASM memory
+      // View vertex data directly in WASM memory — no copy on the JS side.
       // Each vertex is 8 floats (32 bytes): [x, y, r, g, b, a, u, v]
       const floatsPerVertex = 8;
-      const vertexData = new Float32Array(
-        memory.buffer,
-        verticesPtr,
-        vertexCount * floatsPerVertex
+      if (!memoryF32 || memoryF32.buffer !== memory.buffer) {
+        memoryF32 = new Float32Array(memory.buffer);
+      }
+      const begin = verticesPtr / 4;
+      const vertexData = memoryF32.subarray(
+        begin,
+        begin + vertexCount * floatsPerVertex
       );
 
       // Bind texture
       gl.bindTexture(gl.TEXTURE_2D, tileAtlas);
 
-      // Upload vertex data as interleaved buffer
+      // Upload into the preallocated GPU buffer (no reallocation; attribute
+      // layout and index buffer were set up once in initWebGL)
       gl.bindBuffer(gl.ARRAY_BUFFER, shaderProgram.vertexBuffer);
-      gl.bufferData(gl.ARRAY_BUFFER, vertexData, gl.STREAM_DRAW);
-
-      const stride = floatsPerVertex * 4; // 32 bytes per vertex
-
-      // Position attribute (offset 0)
-      gl.enableVertexAttribArray(shaderProgram.attribLocations.position);
-      gl.vertexAttribPointer(
-        shaderProgram.attribLocations.position,
-        2,
-        gl.FLOAT,
-        false,
-        stride,
-        0
-      );
-
-      // Color attribute (offset 8 bytes)
-      gl.enableVertexAttribArray(shaderProgram.attribLocations.color);
-      gl.vertexAttribPointer(
-        shaderProgram.attribLocations.color,
-        4,
-        gl.FLOAT,
-        false,
-        stride,
-        8
-      );
-
-      // Tex coord attribute (offset 24 bytes)
-      gl.enableVertexAttribArray(shaderProgram.attribLocations.texCoord);
-      gl.vertexAttribPointer(
-        shaderProgram.attribLocations.texCoord,
-        2,
-        gl.FLOAT,
-        false,
-        stride,
-        24
-      );
+      gl.bufferSubData(gl.ARRAY_BUFFER, 0, vertexData);
 
-      // Draw
-      gl.drawArrays(gl.TRIANGLES, 0, vertexCount);
+      // Draw indexed: every 4 vertices form one quad (2 triangles)
+      gl.drawElements(gl.TRIANGLES, (vertexCount / 4) * 6, gl.UNSIGNED_SHORT, 0);
     },
 
     host_load_chunk(chunk_key) {
@@ -395,14 +484,25 @@ const wasmImports = {
 
 // Initialize WASM module
 async function initWasm() {
-  // Create memory (16MB = 256 pages)
-  memory = new WebAssembly.Memory({ initial: 256 });
+  // Create memory (32MB = 512 pages; the game block plus the frame/turn
+  // arena backing stores is ~13.5MB, so 16MB left too little headroom)
+  memory = new WebAssembly.Memory({ initial: 512 });
   wasmImports.env.memory = memory;
 
+  // Pick the SIMD128 + bulk-memory module when the engine validates a
+  // minimal v128 function body (the standard feature-detect probe),
+  // otherwise fall back to the baseline build
+  const simdProbe = new Uint8Array([
+    0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0, 10,
+    10, 1, 8, 0, 65, 0, 253, 15, 253, 98, 11
+  ]);
+  const wasmPath = WebAssembly.validate(simdProbe) ? 'game-simd.wasm' : 'game.wasm';
+  console.log(`Loading ${wasmPath}`);
+
   // Load and instantiate WASM module
   // Use instantiateStreaming for better performance and source map support
   const wasmModule = await WebAssembly.instantiateStreaming(
-    fetch('game.wasm'),
+    fetch(wasmPath),
     wasmImports
   );
 
@@ -462,6 +562,8 @@ function setupInput() {
     'n': InputCommand.DOWN_RIGHT,
     '.': InputCommand.PERIOD,
     'd': InputCommand.D,
+    'p': InputCommand.P,
+    't': InputCommand.T,
   };
 
   document.addEventListener('keydown', (e) => {
@@ -475,29 +577,36 @@ function setupInput() {
 
 // Main game loop
 let lastTime = 0;
+let forceRedraw = true; // redraw regardless of frame damage (resize etc.)
 function gameLoop(currentTime) {
   const dt = (currentTime - lastTime) / 1000.0; // Convert to seconds
   lastTime = currentTime;
 
-  // Update game
-  wasmExports.game_frame(dt);
-
-  // Clear screen
-  gl.clearColor(0, 0, 0, 1);
-  gl.clear(gl.COLOR_BUFFER_BIT);
-
-  gl.useProgram(shaderProgram);
-  gl.uniform2f(shaderProgram.uniformLocations.resolution, gl.canvas.width, gl.canvas.height);
-
-  // Render game (calls back into JS via host_submit_geometry)
-  const tileSizeScaled = 12 * 2; // 2x scaling
-  wasmExports.game_render(
-    gl.canvas.width,
-    gl.canvas.height,
-    tileSizeScaled,
-    tileAtlas.width,
-    tileAtlas.height
-  );
+  // Update game; returns nonzero when anything visible changed
+  const frameDamaged = wasmExports.game_frame(dt);
+
+  // Skip the whole redraw when nothing visible changed; an untouched
+  // canvas keeps compositing the last rendered frame
+  if (frameDamaged || forceRedraw) {
+    forceRedraw = false;
+
+    // Clear screen
+    gl.clearColor(0, 0, 0, 1);
+    gl.clear(gl.COLOR_BUFFER_BIT);
+
+    gl.useProgram(shaderProgram);
+    gl.uniform2f(shaderProgram.uniformLocations.resolution, gl.canvas.width, gl.canvas.height);
+
+    // Render game (calls back into JS via host_submit_geometry)
+    const tileSizeScaled = 12 * 2; // 2x scaling
+    wasmExports.game_render(
+      gl.canvas.width,
+      gl.canvas.height,
+      tileSizeScaled,
+      tileAtlas.width,
+      tileAtlas.height
+    );
+  }
 
   requestAnimationFrame(gameLoop);
 }
@@ -508,6 +617,7 @@ function resizeCanvas() {
   canvas.width = canvas.clientWidth;
   canvas.height = canvas.clientHeight;
   console.log('Resized canvas to', canvas.width, '*', canvas.height)
+  forceRedraw = true;
   if (gl) {
     gl.viewport(0, 0, canvas.width, canvas.height);
   }